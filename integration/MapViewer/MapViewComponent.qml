@@ -61,12 +61,19 @@ Item {
         }
         */
 
+        onGraphicsIdentified: geoElements => {
+            for (var index=0; index<geoElements.length; index++) {
+                var geoElement = geoElements[index];
+                console.log("Identified", geoElement.elementIndex, "of overlay", geoElement.overlayIndex);
+            }
+        }
+
         onMapViewClicked: location => {
             console.log(location);
             
-            // Access the GeoElementsOverlayModel
+            // Access the first page of the GeoElementsOverlayModel
             if (0 < model.overlayModel.count) {
-                var geoelements = model.overlayModel.toDict(0);
+                var geoelements = model.overlayModel.toDictRange(0, 0, 100, [], GeoElementsOverlayModel.NoGeometry);
                 for (var index=0; index<geoelements.length; index++) {
                     var geoelement = geoelements[index];
                     for (var attributeKey in geoelement) {
@@ -1,5 +1,7 @@
 from abc import ABC
-from typing import List, Protocol
+from typing import Any, Dict, List, Optional, Protocol
+
+import numpy as np
 
 
 class GeoElementsOverlayModel(ABC):
@@ -12,6 +14,17 @@ class GeoElementsOverlayModel(ABC):
         Returns the number of graphic overlays of this overlay model.
         """
 
+    FullGeometry: int = 0
+    SimplifiedGeometry: int = 1
+    NoGeometry: int = 2
+
+    def getElementCount(self, index: int) -> int:
+        """
+        Returns the number of geoelements from a graphics overlay.
+
+        :param index: The index of the graphics overlay.
+        """
+
     def toDict(self, index: int) -> List[dict]:
         """
         Returns an array of JSON representation of all geoelements from a graphics overlay.
@@ -19,6 +32,59 @@ class GeoElementsOverlayModel(ABC):
         :param index: The index of the graphics overlay.
         """
 
+    def toDictRange(self, index: int, offset: int, limit: int, fields: List[str]=[],
+                    geometryOutput: int=0, maxDeviation: float=0.0) -> List[dict]:
+        """
+        Returns an array of JSON representation of a page of geoelements from a graphics overlay.
+
+        :param index: The index of the graphics overlay.
+        :param offset: The index of the first geoelement.
+        :param limit: The maximum number of geoelements, a negative limit returns all remaining geoelements.
+        :param fields: The names of the attributes to return, all attributes are returned if empty.
+        :param geometryOutput: FullGeometry, SimplifiedGeometry or NoGeometry.
+        :param maxDeviation: The maximum deviation of simplified geometries, zero derives it from the geometry extent.
+        """
+
+
+class GeoJsonLoadJob(ABC):
+    """
+    Handle of a GeoJSON layer being loaded in the background.
+    Emits progressChanged(featuresParsed, bytesConsumed) and finished(succeeded).
+    """
+
+    featuresParsed: int
+    bytesConsumed: int
+    totalBytes: int
+    running: bool
+    canceled: bool
+    errorString: str
+
+    def cancel(self) -> None:
+        """
+        Cancels the loading, the graphics added so far are kept.
+        """
+
+
+class GeoPackagePrefetchJob(ABC):
+    """
+    Handle of GeoPackage feature tables being loaded and queried in the background.
+    The features within the extent are only counted, which warms the spatial index for the layers.
+    Emits progressChanged(tablesCompleted, tableCount) and finished(succeeded).
+    The job belongs to the map view model and stays valid as long as the model.
+    """
+
+    tablesCompleted: int
+    tableCount: int
+    featuresQueried: int
+    running: bool
+    canceled: bool
+    errorString: str
+
+    def cancel(self) -> None:
+        """
+        Cancels the prefetch, no feature layers are added.
+        """
+
 
 class MapViewModel(ABC):
     """
@@ -68,6 +134,95 @@ class MapViewModel(ABC):
         :param features: The GeoJSON representation of the features.
         """
 
+    def addGeoJsonFeaturesAsync(self, features: str) -> GeoJsonLoadJob:
+        """
+        Adds the GeoJSON features into a graphics collection of this map view model without blocking the event loop.
+        The features are parsed in the background and the graphics are added batch by batch.
+
+        :param features: The GeoJSON representation of the features.
+        """
+
+    def addGeoJsonFeaturesFromFile(self, filePath: str) -> bool:
+        """
+        Adds the features of a GeoJSON file into a graphics collection of this map view model.
+        The file is memory mapped and parsed in place, so it is never held as a string.
+        Returns False if the file cannot be opened or is not valid JSON.
+
+        :param filePath: The path of the GeoJSON file.
+        """
+
+    def addGeoJsonFeaturesFromFileAsync(self, filePath: str) -> GeoJsonLoadJob:
+        """
+        Adds the features of a GeoJSON file like addGeoJsonFeaturesFromFile without blocking the event loop.
+
+        :param filePath: The path of the GeoJSON file.
+        """
+
+    def addGeoJsonFeaturesLazyFromFile(self, filePath: str) -> bool:
+        """
+        Adds the features of a GeoJSON file into a compact feature store like addGeoJsonFeaturesLazy.
+        Returns False if the file cannot be opened or is not valid JSON.
+
+        :param filePath: The path of the GeoJSON file.
+        """
+
+    def addGeoJsonFeaturesLazy(self, features: str) -> bool:
+        """
+        Adds the GeoJSON features into a compact feature store of this map view model.
+        Graphics are only created for the features around the visible area and removed again when they leave it.
+
+        :param features: The GeoJSON representation of the features.
+        """
+
+    def addGeoJsonFeaturesClustered(self, features: str) -> bool:
+        """
+        Adds the GeoJSON features like addGeoJsonFeaturesLazy and shows the points as clusters.
+        Every cluster has a point_count attribute and a <name>_sum attribute for every numeric property.
+
+        :param features: The GeoJSON representation of the features.
+        """
+
+    def addFeatureBinary(self, filePath: str, extent: str = "") -> bool:
+        """
+        Adds the features of a binary feature file into a graphics collection of this map view model.
+        The file is memory mapped and its spatial index is used to read only the features within the extent.
+
+        :param filePath: The path of the binary feature file.
+        :param extent: The Esri JSON representation of the envelope, an empty string loads all features.
+        """
+
+    def writeFeatureBinary(self, filePath: str) -> bool:
+        """
+        Writes the graphics of all graphic overlays of this map view model into a binary feature file.
+        The attributes of every graphic become the properties of its feature.
+
+        :param filePath: The path of the binary feature file.
+        """
+
+    def writeVectorTilePackage(self, filePath: str, minLevel: int=0, maxLevel: int=14) -> bool:
+        """
+        Writes the graphics of all visible graphic overlays of this map view model into a vector tile package.
+        The geometries are clipped, simplified and quantized for every level, every overlay becomes one tile layer.
+        Load the package using loadBasemapFromVectorTilePackage.
+
+        :param filePath: The path of the vector tile package (.vtpk).
+        :param minLevel: The first level of detail having tiles.
+        :param maxLevel: The last level of detail having tiles, deeper levels scale the tiles of this level.
+        """
+
+    def upsertGeoJsonFeatures(self, layerId: str, features: str, idProperty: str, removeMissing: bool = True) -> dict:
+        """
+        Updates the GeoJSON features of a live layer by the value of their id property.
+        Graphics of known features are changed in place, unknown features are added and,
+        when removeMissing is set, features missing in this update are removed.
+
+        :param layerId: The id of the live layer, the first update creates it.
+        :param features: The GeoJSON representation of the features.
+        :param idProperty: The name of the property identifying every feature.
+        :param removeMissing: Whether features not being part of this update are removed.
+        :return: The number of inserted, updated, replaced, removed and skipped features and the elapsed milliseconds.
+        """
+
     def addGeoJsonPointFeatures(self, features: str, renderer: str) -> None:
         """
         Adds the GeoJSON point features into a graphics collection of this map view model.
@@ -110,6 +265,7 @@ class MapViewModel(ABC):
     def addFeatureLayerFromMobile(self, workspacePath: str, featureClassName: str="") -> None:
         """
         Adds a feature layer from a mobile map package (.mpkx) to this map view model.
+        A feature class being shown already keeps its layer.
 
         :param workspacePath: The local file path to the mobile map package (.mpkx).
         :param featureClassName: The name of the feature class. If empty all feature classes are loaded.
@@ -118,11 +274,22 @@ class MapViewModel(ABC):
     def addFeatureLayerFromGeoPackage(self, workspacePath: str, featureClassName: str="") -> None:
         """
         Adds a feature layer from a geopackage (.gpkg) to this map view model.
+        Feature classes being shown already keep their layers.
 
         :param workspacePath: The local file path to the geopackage (.gpkg).
         :param featureClassName: The name of the feature class. If empty all feature classes are loaded.
         """
 
+    def addFeatureLayersFromGeoPackageAsync(self, workspacePath: str, featureClassNames: list[str]=[], extent: str="") -> GeoPackagePrefetchJob:
+        """
+        Loads the feature tables of a geopackage (.gpkg) concurrently and counts their features within the extent,
+        the feature layers are added at once when all tables are done. Feature classes being shown already keep their layers.
+
+        :param workspacePath: The local file path to the geopackage (.gpkg).
+        :param featureClassNames: The names of the feature classes. If empty all feature classes are loaded.
+        :param extent: The extent as JSON being queried up front. If empty the visible area is used.
+        """
+
     def addRasterLayer(self, rasterFilePath: str, opacity: float=0.7) -> None:
         """
         Adds a local raster file to this map view model.
@@ -134,12 +301,52 @@ class MapViewModel(ABC):
     def addRasterLayerFromGeoPackage(self, workspacePath: str, rasterName: str, opacity: float=0.7) -> None:
         """
         Adds a raster from a geopackage (.gpkg) to this map view model.
+        Rasters being shown already keep their layers and only take the opacity.
 
         :param workspacePath: The local file path to the geopackage (.gpkg).
         :param rasterName: The name of the raster. If empty all rasters are loaded.
         :param opacity: The opacity of this layer as a float value between 0.0 (fully transparent) and 1.0 (fully opaque).
         """
 
+    def identifyGraphics(self, screenX: float, screenY: float, tolerance: float=8.0, maximumCount: int=100) -> List[dict]:
+        """
+        Returns the geoelements next to a screen location, the nearest first.
+        Every geoelement is referenced by its overlayIndex and elementIndex.
+
+        :param screenX: The x coordinate of the screen location.
+        :param screenY: The y coordinate of the screen location.
+        :param tolerance: The search tolerance in screen pixels.
+        :param maximumCount: The maximum number of geoelements, a negative count returns all of them.
+        """
+
+    def queryGraphics(self, extent: str, maximumCount: int=-1) -> List[dict]:
+        """
+        Returns the geoelements intersecting an extent.
+        Every geoelement is referenced by its overlayIndex and elementIndex.
+
+        :param extent: The JSON representation of the extent.
+        :param maximumCount: The maximum number of geoelements, a negative count returns all of them.
+        """
+
+    def loadMetrics(self) -> List[Dict[str, Any]]:
+        """
+        Returns the metrics of the most recent load calls, oldest first.
+        Every entry has the operation, elapsedMilliseconds, featuresParsed, verticesBuilt,
+        graphicsAppended, bytesProcessed and the milliseconds and count of every stage.
+        """
+
+    def clearLoadMetrics(self) -> None:
+        """
+        Forgets the metrics of all load calls.
+        """
+
+    def writeLoadTrace(self, filePath: str) -> bool:
+        """
+        Writes the stages of the most recent load calls as Chrome trace JSON.
+
+        :param filePath: The path of the trace file, open it with chrome://tracing or ui.perfetto.dev.
+        """
+
     def clearGraphicOverlays(self) -> None:
         """
         Removes all graphic overlays from this map view model.
@@ -149,3 +356,72 @@ class MapViewModel(ABC):
         """
         Removes all operational layers from this map view model.
         """
+
+
+def addPointArrays(model: MapViewModel, x: np.ndarray, y: np.ndarray, renderer: str,
+                   z: Optional[np.ndarray]=None, m: Optional[np.ndarray]=None,
+                   attributes: Dict[str, np.ndarray]={}, wkid: int=4326) -> bool:
+    """
+    Adds points from NumPy coordinate arrays into a new graphics overlay of the map view model.
+    Contiguous float64 arrays are read in place, without any JSON round trip.
+
+    :param model: The map view model.
+    :param x: The x coordinates.
+    :param y: The y coordinates.
+    :param renderer: The JSON representation of the renderer.
+    :param z: The optional z values.
+    :param m: The optional m values.
+    :param attributes: The attribute columns having one value per point.
+    :param wkid: The well-known ID of the spatial reference.
+    """
+
+
+def addPolylineArrays(model: MapViewModel, x: np.ndarray, y: np.ndarray, partOffsets: np.ndarray, renderer: str,
+                      geometryOffsets: Optional[np.ndarray]=None, z: Optional[np.ndarray]=None, m: Optional[np.ndarray]=None,
+                      attributes: Dict[str, np.ndarray]={}, wkid: int=4326) -> bool:
+    """
+    Adds polylines from NumPy coordinate and offset arrays into a new graphics overlay of the map view model.
+
+    :param model: The map view model.
+    :param x: The x coordinates of all vertices.
+    :param y: The y coordinates of all vertices.
+    :param partOffsets: The int64 offsets of the first vertex of every part, followed by the number of vertices.
+    :param renderer: The JSON representation of the renderer.
+    :param geometryOffsets: The optional int64 offsets of the first part of every polyline, followed by the number of parts. Every part is a polyline if omitted.
+    :param z: The optional z values.
+    :param m: The optional m values.
+    :param attributes: The attribute columns having one value per polyline.
+    :param wkid: The well-known ID of the spatial reference.
+    """
+
+
+def addPolygonArrays(model: MapViewModel, x: np.ndarray, y: np.ndarray, partOffsets: np.ndarray, renderer: str,
+                     geometryOffsets: Optional[np.ndarray]=None, z: Optional[np.ndarray]=None, m: Optional[np.ndarray]=None,
+                     attributes: Dict[str, np.ndarray]={}, wkid: int=4326) -> bool:
+    """
+    Adds polygons from NumPy coordinate and offset arrays into a new graphics overlay of the map view model.
+
+    :param model: The map view model.
+    :param x: The x coordinates of all vertices.
+    :param y: The y coordinates of all vertices.
+    :param partOffsets: The int64 offsets of the first vertex of every ring, followed by the number of vertices.
+    :param renderer: The JSON representation of the renderer.
+    :param geometryOffsets: The optional int64 offsets of the first ring of every polygon, followed by the number of rings. Every ring is a polygon if omitted.
+    :param z: The optional z values.
+    :param m: The optional m values.
+    :param attributes: The attribute columns having one value per polygon.
+    :param wkid: The well-known ID of the spatial reference.
+    """
+
+
+def toColumns(model: GeoElementsOverlayModel, index: int) -> Dict[str, Any]:
+    """
+    Exports all geoelements from a graphics overlay as columns instead of one dictionary per geoelement.
+    The returned dictionary contains the geometryType, the count of geoelements, the x, y and optional z coordinates,
+    the optional partOffsets and geometryOffsets using the layout of addPolylineArrays and addPolygonArrays,
+    the attributes as one array per field and the nulls as one boolean mask per field having missing values.
+    Numeric arrays share the exported buffers instead of copying them.
+
+    :param model: The geoelements overlay model.
+    :param index: The index of the graphics overlay.
+    """
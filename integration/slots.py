@@ -6,7 +6,7 @@ QML_IMPORT_MAJOR_VERSION = 1
 from PySide6.QtQml import QmlElement
 from PySide6.QtCore import QObject, Slot
 
-from coremapping import GeoElementsOverlayModel
+from coremapping import GeoElementsOverlayModel, toColumns
 
 
 @QmlElement
@@ -22,8 +22,8 @@ class GeoElementsInspector(QObject):
     @Slot(QObject)
     def inspect(self, model: GeoElementsOverlayModel):
         if 0 < model.getCount():
-            geoelements = model.toDict(0)
-            for index in range(0, len(geoelements)):
-                geoelement = geoelements[index]
-                for key, value in geoelement.items():
-                    print(key, ":", value)
+            columns = toColumns(model, 0)
+            print("geometryType", ":", columns["geometryType"])
+            print("count", ":", columns["count"])
+            for key, values in columns["attributes"].items():
+                print(key, ":", values.dtype, values[:10])
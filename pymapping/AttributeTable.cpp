@@ -0,0 +1,286 @@
+// geoint-mapping offers core mapping and Geospatial Intelligence capabilities for Python.
+// Copyright (C) 2024 Jan Tschada (gisfromscratch@live.de)
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// Additional permission under GNU LGPL version 3 section 4 and 5
+// If you modify this Program, or any covered work, by linking or combining
+// it with ArcGIS Runtime for Qt (or a modified version of that library),
+// containing parts covered by the terms of ArcGIS Runtime for Qt,
+// the licensors of this Program grant you additional permission to convey the resulting work.
+// See <https://developers.arcgis.com/qt/> for further information.
+//
+
+#include "AttributeTable.h"
+
+void AttributeTable::append(const QVariantMap& attributes)
+{
+    const qsizetype row = m_rowCount++;
+    for (Column& column : m_columns)
+    {
+        column.states.append(CellState::Absent);
+        resizeStorage(column, m_rowCount);
+    }
+
+    for (auto attribute = attributes.cbegin(); attribute != attributes.cend(); attribute++)
+    {
+        setValue(m_columns[field(attribute.key())], row, attribute.value());
+    }
+}
+
+void AttributeTable::clear()
+{
+    m_rowCount = 0;
+    m_fieldNames.clear();
+    m_fieldIndices.clear();
+    m_columns.clear();
+    m_strings.clear();
+    m_stringIndices.clear();
+}
+
+void AttributeTable::squeeze()
+{
+    for (Column& column : m_columns)
+    {
+        column.states.squeeze();
+        column.integers.squeeze();
+        column.doubles.squeeze();
+        column.strings.squeeze();
+        column.variants.squeeze();
+    }
+}
+
+qsizetype AttributeTable::size() const
+{
+    return m_rowCount;
+}
+
+qsizetype AttributeTable::fieldCount() const
+{
+    return m_fieldNames.size();
+}
+
+QString AttributeTable::fieldName(qsizetype fieldIndex) const
+{
+    return m_fieldNames.at(fieldIndex);
+}
+
+AttributeTable::FieldType AttributeTable::fieldType(qsizetype fieldIndex) const
+{
+    return m_columns.at(fieldIndex).type;
+}
+
+QVariantMap AttributeTable::attributes(qsizetype row) const
+{
+    QVariantMap attributes;
+    for (qsizetype fieldIndex = 0; fieldIndex < m_columns.size(); fieldIndex++)
+    {
+        const Column& column = m_columns.at(fieldIndex);
+        if (CellState::Absent != column.states.at(row))
+        {
+            attributes.insert(m_fieldNames.at(fieldIndex), value(column, row));
+        }
+    }
+
+    return attributes;
+}
+
+AttributeTable::FieldType AttributeTable::valueType(const QVariant& value)
+{
+    switch (value.typeId())
+    {
+    case QMetaType::Bool:
+        return FieldType::Boolean;
+
+    case QMetaType::Int:
+    case QMetaType::UInt:
+    case QMetaType::LongLong:
+        return FieldType::Integer;
+
+    case QMetaType::Float:
+    case QMetaType::Double:
+        return FieldType::Double;
+
+    case QMetaType::QString:
+        return FieldType::String;
+
+    default:
+        return FieldType::Variant;
+    }
+}
+
+AttributeTable::FieldType AttributeTable::mergedType(FieldType columnType, FieldType valueType)
+{
+    if (columnType == valueType || FieldType::Null == valueType)
+    {
+        return columnType;
+    }
+    if (FieldType::Null == columnType)
+    {
+        return valueType;
+    }
+
+    const bool isNumber = FieldType::Integer == columnType || FieldType::Double == columnType;
+    const bool isNumberValue = FieldType::Integer == valueType || FieldType::Double == valueType;
+    if (isNumber && isNumberValue)
+    {
+        return FieldType::Double;
+    }
+
+    return FieldType::Variant;
+}
+
+void AttributeTable::resizeStorage(Column& column, qsizetype rowCount)
+{
+    switch (column.type)
+    {
+    case FieldType::Boolean:
+    case FieldType::Integer:
+        column.integers.resize(rowCount);
+        break;
+
+    case FieldType::Double:
+        column.doubles.resize(rowCount);
+        break;
+
+    case FieldType::String:
+        column.strings.resize(rowCount);
+        break;
+
+    case FieldType::Variant:
+        column.variants.resize(rowCount);
+        break;
+
+    default:
+        break;
+    }
+}
+
+qsizetype AttributeTable::field(const QString& name)
+{
+    auto fieldIndex = m_fieldIndices.constFind(name);
+    if (m_fieldIndices.constEnd() != fieldIndex)
+    {
+        return fieldIndex.value();
+    }
+
+    // Rows appended before have no value for the new field
+    Column column;
+    column.states.fill(CellState::Absent, m_rowCount);
+    m_columns.append(column);
+    m_fieldNames.append(name);
+    m_fieldIndices.insert(name, m_columns.size() - 1);
+    return m_columns.size() - 1;
+}
+
+void AttributeTable::convert(Column& column, FieldType fieldType)
+{
+    Column converted;
+    converted.type = fieldType;
+    converted.states = column.states;
+    resizeStorage(converted, m_rowCount);
+    for (qsizetype row = 0; row < m_rowCount; row++)
+    {
+        if (CellState::Value != column.states.at(row))
+        {
+            continue;
+        }
+
+        if (FieldType::Double == fieldType)
+        {
+            converted.doubles[row] = static_cast<double>(column.integers.at(row));
+        }
+        else if (FieldType::Variant == fieldType)
+        {
+            converted.variants[row] = value(column, row);
+        }
+    }
+
+    column = converted;
+}
+
+void AttributeTable::setValue(Column& column, qsizetype row, const QVariant& value)
+{
+    // Invalid variants and JSON nulls are stored as nulls
+    if (value.isNull())
+    {
+        column.states[row] = CellState::Null;
+        return;
+    }
+
+    const FieldType fieldType = mergedType(column.type, valueType(value));
+    if (fieldType != column.type)
+    {
+        convert(column, fieldType);
+    }
+
+    column.states[row] = CellState::Value;
+    switch (column.type)
+    {
+    case FieldType::Boolean:
+        column.integers[row] = value.toBool() ? 1 : 0;
+        break;
+
+    case FieldType::Integer:
+        column.integers[row] = value.toLongLong();
+        break;
+
+    case FieldType::Double:
+        column.doubles[row] = value.toDouble();
+        break;
+
+    case FieldType::String:
+    {
+        const QString text = value.toString();
+        auto stringIndex = m_stringIndices.constFind(text);
+        if (m_stringIndices.constEnd() == stringIndex)
+        {
+            m_strings.append(text);
+            stringIndex = m_stringIndices.insert(text, static_cast<quint32>(m_strings.size() - 1));
+        }
+        column.strings[row] = stringIndex.value();
+        break;
+    }
+
+    default:
+        column.variants[row] = value;
+        break;
+    }
+}
+
+QVariant AttributeTable::value(const Column& column, qsizetype row) const
+{
+    if (CellState::Null == column.states.at(row))
+    {
+        return QVariant::fromValue(nullptr);
+    }
+
+    switch (column.type)
+    {
+    case FieldType::Boolean:
+        return QVariant(0 != column.integers.at(row));
+
+    case FieldType::Integer:
+        return QVariant(column.integers.at(row));
+
+    case FieldType::Double:
+        return QVariant(column.doubles.at(row));
+
+    case FieldType::String:
+        return QVariant(m_strings.at(column.strings.at(row)));
+
+    default:
+        return column.variants.at(row);
+    }
+}
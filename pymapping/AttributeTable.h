@@ -0,0 +1,105 @@
+// geoint-mapping offers core mapping and Geospatial Intelligence capabilities for Python.
+// Copyright (C) 2024 Jan Tschada (gisfromscratch@live.de)
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// Additional permission under GNU LGPL version 3 section 4 and 5
+// If you modify this Program, or any covered work, by linking or combining
+// it with ArcGIS Runtime for Qt (or a modified version of that library),
+// containing parts covered by the terms of ArcGIS Runtime for Qt,
+// the licensors of this Program grant you additional permission to convey the resulting work.
+// See <https://developers.arcgis.com/qt/> for further information.
+//
+
+#ifndef ATTRIBUTETABLE_H
+#define ATTRIBUTETABLE_H
+
+#include <QHash>
+#include <QList>
+#include <QString>
+#include <QStringList>
+#include <QVariant>
+#include <QVariantMap>
+
+/*!
+ * \brief Columnar store of the attributes of many features.
+ *
+ * Every attribute name becomes a column whose type is inferred from the
+ * values appended so far. Booleans, integers and doubles are stored
+ * unboxed, strings are dictionary-encoded. Columns mixing integers and
+ * doubles are widened to doubles, any other mix falls back to variants.
+ * The attribute maps of a row are decoded on request and share the names
+ * and strings with the store.
+ */
+class AttributeTable
+{
+public:
+    enum class FieldType : quint8
+    {
+        Null,
+        Boolean,
+        Integer,
+        Double,
+        String,
+        Variant
+    };
+
+    void append(const QVariantMap& attributes);
+    void clear();
+    void squeeze();
+
+    qsizetype size() const;
+    qsizetype fieldCount() const;
+    QString fieldName(qsizetype fieldIndex) const;
+    FieldType fieldType(qsizetype fieldIndex) const;
+
+    QVariantMap attributes(qsizetype row) const;
+
+private:
+    enum class CellState : quint8
+    {
+        Absent,
+        Null,
+        Value
+    };
+
+    struct Column
+    {
+        FieldType type = FieldType::Null;
+        QList<CellState> states;
+        // Only the storage of the column type is used
+        QList<qint64> integers;
+        QList<double> doubles;
+        QList<quint32> strings;
+        QList<QVariant> variants;
+    };
+
+    static FieldType valueType(const QVariant& value);
+    static FieldType mergedType(FieldType columnType, FieldType valueType);
+    static void resizeStorage(Column& column, qsizetype rowCount);
+
+    qsizetype field(const QString& name);
+    void convert(Column& column, FieldType fieldType);
+    void setValue(Column& column, qsizetype row, const QVariant& value);
+    QVariant value(const Column& column, qsizetype row) const;
+
+    qsizetype m_rowCount = 0;
+    QStringList m_fieldNames;
+    QHash<QString, qsizetype> m_fieldIndices;
+    QList<Column> m_columns;
+    QStringList m_strings;
+    QHash<QString, quint32> m_stringIndices;
+};
+
+#endif // ATTRIBUTETABLE_H
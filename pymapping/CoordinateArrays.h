@@ -0,0 +1,74 @@
+// geoint-mapping offers core mapping and Geospatial Intelligence capabilities for Python.
+// Copyright (C) 2024 Jan Tschada (gisfromscratch@live.de)
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// Additional permission under GNU LGPL version 3 section 4 and 5
+// If you modify this Program, or any covered work, by linking or combining
+// it with ArcGIS Runtime for Qt (or a modified version of that library),
+// containing parts covered by the terms of ArcGIS Runtime for Qt,
+// the licensors of this Program grant you additional permission to convey the resulting work.
+// See <https://developers.arcgis.com/qt/> for further information.
+//
+
+#ifndef COORDINATEARRAYS_H
+#define COORDINATEARRAYS_H
+
+#include <QtGlobal>
+
+/*!
+ * \brief Non-owning view on columnar coordinate buffers like NumPy arrays.
+ *
+ * Vertex i is (x[i], y[i]) with optional z[i] and m[i]. Part p spans the
+ * vertices [partOffsets[p], partOffsets[p + 1]) and geometry g spans the
+ * parts [geometryOffsets[g], geometryOffsets[g + 1]). Without geometry
+ * offsets every part is a geometry of its own, without part offsets every
+ * vertex is a point geometry of its own.
+ */
+struct CoordinateArrays
+{
+    const double* x = nullptr;
+    const double* y = nullptr;
+    const double* z = nullptr;
+    const double* m = nullptr;
+    qsizetype pointCount = 0;
+
+    const qint64* partOffsets = nullptr;
+    qsizetype partCount = 0;
+
+    const qint64* geometryOffsets = nullptr;
+    qsizetype geometryCount = 0;
+
+    qsizetype partBegin(qsizetype geometryIndex) const
+    {
+        return geometryOffsets ? geometryOffsets[geometryIndex] : geometryIndex;
+    }
+
+    qsizetype partEnd(qsizetype geometryIndex) const
+    {
+        return geometryOffsets ? geometryOffsets[geometryIndex + 1] : geometryIndex + 1;
+    }
+
+    qsizetype vertexBegin(qsizetype partIndex) const
+    {
+        return partOffsets ? partOffsets[partIndex] : partIndex;
+    }
+
+    qsizetype vertexEnd(qsizetype partIndex) const
+    {
+        return partOffsets ? partOffsets[partIndex + 1] : partIndex + 1;
+    }
+};
+
+#endif // COORDINATEARRAYS_H
@@ -0,0 +1,407 @@
+// geoint-mapping offers core mapping and Geospatial Intelligence capabilities for Python.
+// Copyright (C) 2024 Jan Tschada (gisfromscratch@live.de)
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// Additional permission under GNU LGPL version 3 section 4 and 5
+// If you modify this Program, or any covered work, by linking or combining
+// it with ArcGIS Runtime for Qt (or a modified version of that library),
+// containing parts covered by the terms of ArcGIS Runtime for Qt,
+// the licensors of this Program grant you additional permission to convey the resulting work.
+// See <https://developers.arcgis.com/qt/> for further information.
+//
+
+#include "EsriJsonGeometryReader.h"
+
+#include <limits>
+
+using namespace Esri::ArcGISRuntime;
+
+static constexpr double NaN = std::numeric_limits<double>::quiet_NaN();
+
+EsriJsonGeometryReader::EsriJsonGeometryReader(const QByteArray& json) :
+    m_json(json),
+    m_reader(m_json)
+{
+}
+
+bool EsriJsonGeometryReader::readNextGeometry(EsriJsonGeometry& geometry)
+{
+    if (!m_insideGeometries && !findGeometries())
+    {
+        return false;
+    }
+
+    JsonStreamReader::TokenType tokenType = m_reader.readNext();
+    while (JsonStreamReader::StartObject != tokenType)
+    {
+        if (JsonStreamReader::EndArray == tokenType || m_reader.atEnd() || m_reader.hasError())
+        {
+            m_insideGeometries = false;
+            m_finished = true;
+            return false;
+        }
+
+        // Anything else than an object is not a geometry
+        m_reader.skipCurrentValue();
+        tokenType = m_reader.readNext();
+    }
+
+    readGeometry(geometry);
+    return !m_reader.hasError();
+}
+
+qsizetype EsriJsonGeometryReader::readGeometries(QList<EsriJsonGeometry>& geometries, qsizetype maximumCount)
+{
+    qsizetype geometryCount = 0;
+    geometries.reserve(geometries.size() + maximumCount);
+    while (geometryCount < maximumCount)
+    {
+        EsriJsonGeometry& geometry = geometries.emplaceBack();
+        if (!readNextGeometry(geometry))
+        {
+            geometries.removeLast();
+            break;
+        }
+        geometryCount++;
+    }
+
+    return geometryCount;
+}
+
+bool EsriJsonGeometryReader::hasError() const
+{
+    return m_reader.hasError() || !m_errorString.isEmpty();
+}
+
+QString EsriJsonGeometryReader::errorString() const
+{
+    return m_reader.hasError() ? m_reader.errorString() : m_errorString;
+}
+
+bool EsriJsonGeometryReader::findGeometries()
+{
+    if (m_finished)
+    {
+        return false;
+    }
+
+    m_finished = true;
+    if (JsonStreamReader::StartArray != m_reader.readNext())
+    {
+        if (!m_reader.hasError())
+        {
+            m_errorString = "JSON document is not an array!";
+        }
+        return false;
+    }
+
+    m_insideGeometries = true;
+    m_finished = false;
+    return true;
+}
+
+void EsriJsonGeometryReader::readGeometry(EsriJsonGeometry& geometry)
+{
+    // The opening brace was consumed with the start of the object
+    const qint64 geometryBegin = m_reader.bytesConsumed() - 1;
+    geometry.clear();
+    double point[4] = { NaN, NaN, NaN, NaN };
+    bool isPoint = false;
+    bool hasPointZ = false;
+    bool hasPointM = false;
+    double envelope[4] = { NaN, NaN, NaN, NaN };
+    bool isEnvelope = false;
+    bool hasCurves = false;
+    while (JsonStreamReader::Name == m_reader.readNext())
+    {
+        const QByteArray name = m_reader.utf8Text();
+        if ("x" == name)
+        {
+            isPoint = true;
+            point[0] = readCoordinate();
+        }
+        else if ("y" == name)
+        {
+            point[1] = readCoordinate();
+        }
+        else if ("z" == name)
+        {
+            hasPointZ = true;
+            point[2] = readCoordinate();
+        }
+        else if ("m" == name)
+        {
+            hasPointM = true;
+            point[3] = readCoordinate();
+        }
+        else if ("xmin" == name)
+        {
+            isEnvelope = true;
+            envelope[0] = readCoordinate();
+        }
+        else if ("ymin" == name)
+        {
+            envelope[1] = readCoordinate();
+        }
+        else if ("xmax" == name)
+        {
+            envelope[2] = readCoordinate();
+        }
+        else if ("ymax" == name)
+        {
+            envelope[3] = readCoordinate();
+        }
+        else if ("points" == name || "paths" == name || "rings" == name)
+        {
+            geometry.type = "points" == name ? GeometryType::Multipoint : ("paths" == name ? GeometryType::Polyline : GeometryType::Polygon);
+            if (JsonStreamReader::StartArray != m_reader.readNext())
+            {
+                m_reader.skipCurrentValue();
+            }
+            else if (GeometryType::Multipoint == geometry.type)
+            {
+                readPositions(geometry);
+            }
+            else
+            {
+                readParts(geometry);
+            }
+        }
+        else if ("hasZ" == name)
+        {
+            geometry.hasZ = readFlag();
+        }
+        else if ("hasM" == name)
+        {
+            geometry.hasM = readFlag();
+        }
+        else if ("spatialReference" == name)
+        {
+            if (JsonStreamReader::StartObject == m_reader.readNext())
+            {
+                readSpatialReference(geometry);
+            }
+            else
+            {
+                m_reader.skipCurrentValue();
+            }
+        }
+        else
+        {
+            hasCurves = hasCurves || "curvePaths" == name || "curveRings" == name;
+            m_reader.skipCurrentValue();
+        }
+    }
+
+    if (hasCurves)
+    {
+        // Curves are left to the runtime
+        geometry.json = m_json.mid(geometryBegin, m_reader.bytesConsumed() - geometryBegin);
+        return;
+    }
+
+    if (GeometryType::Unknown == geometry.type && isPoint)
+    {
+        geometry.type = GeometryType::Point;
+        geometry.x = { point[0] };
+        geometry.y = { point[1] };
+        if (hasPointZ)
+        {
+            geometry.z = { point[2] };
+        }
+        if (hasPointM)
+        {
+            geometry.m = { point[3] };
+        }
+        return;
+    }
+
+    if (GeometryType::Unknown == geometry.type && isEnvelope)
+    {
+        geometry.type = GeometryType::Envelope;
+        geometry.x = { envelope[0], envelope[2] };
+        geometry.y = { envelope[1], envelope[3] };
+        return;
+    }
+
+    finishGeometry(geometry);
+}
+
+void EsriJsonGeometryReader::readSpatialReference(EsriJsonGeometry& geometry)
+{
+    int latestWkid = 0;
+    while (JsonStreamReader::Name == m_reader.readNext())
+    {
+        const QByteArray name = m_reader.utf8Text();
+        const JsonStreamReader::TokenType tokenType = m_reader.readNext();
+        if ("wkid" == name && JsonStreamReader::Number == tokenType)
+        {
+            geometry.wkid = static_cast<int>(m_reader.number());
+        }
+        else if ("latestWkid" == name && JsonStreamReader::Number == tokenType)
+        {
+            latestWkid = static_cast<int>(m_reader.number());
+        }
+        else if ("wkt" == name && JsonStreamReader::String == tokenType)
+        {
+            geometry.wkt = m_reader.text();
+        }
+        else
+        {
+            m_reader.skipCurrentValue();
+        }
+    }
+
+    if (geometry.wkid <= 0)
+    {
+        geometry.wkid = latestWkid;
+    }
+}
+
+void EsriJsonGeometryReader::readPositions(EsriJsonGeometry& geometry)
+{
+    // The meaning of the third and fourth value depends on hasZ and hasM,
+    // which may follow the coordinates, they are sorted out when finishing
+    for (JsonStreamReader::TokenType tokenType = m_reader.readNext();
+         JsonStreamReader::EndArray != tokenType && !m_reader.atEnd();
+         tokenType = m_reader.readNext())
+    {
+        if (JsonStreamReader::StartArray != tokenType)
+        {
+            m_reader.skipCurrentValue();
+            continue;
+        }
+
+        double values[4] = { NaN, NaN, NaN, NaN };
+        int dimension = 0;
+        for (tokenType = m_reader.readNext(); JsonStreamReader::EndArray != tokenType && !m_reader.atEnd(); tokenType = m_reader.readNext())
+        {
+            if (dimension < 4 && JsonStreamReader::Number == tokenType)
+            {
+                values[dimension] = m_reader.number();
+            }
+            m_reader.skipCurrentValue();
+            dimension++;
+        }
+
+        if (dimension < 2)
+        {
+            continue;
+        }
+
+        geometry.x.append(values[0]);
+        geometry.y.append(values[1]);
+        if (2 < dimension)
+        {
+            geometry.z.resize(geometry.x.size() - 1, NaN);
+            geometry.z.append(values[2]);
+        }
+        if (3 < dimension)
+        {
+            geometry.m.resize(geometry.x.size() - 1, NaN);
+            geometry.m.append(values[3]);
+        }
+    }
+}
+
+void EsriJsonGeometryReader::readParts(EsriJsonGeometry& geometry)
+{
+    for (JsonStreamReader::TokenType tokenType = m_reader.readNext();
+         JsonStreamReader::EndArray != tokenType && !m_reader.atEnd();
+         tokenType = m_reader.readNext())
+    {
+        if (JsonStreamReader::StartArray != tokenType)
+        {
+            m_reader.skipCurrentValue();
+            continue;
+        }
+
+        const qsizetype firstVertex = geometry.x.size();
+        readPositions(geometry);
+        if (firstVertex < geometry.x.size())
+        {
+            geometry.partOffsets.append(firstVertex);
+        }
+    }
+}
+
+void EsriJsonGeometryReader::finishGeometry(EsriJsonGeometry& geometry)
+{
+    const qsizetype pointCount = geometry.x.size();
+    if (GeometryType::Multipoint == geometry.type && 0 < pointCount)
+    {
+        geometry.partOffsets.append(0);
+    }
+    if (!geometry.partOffsets.isEmpty())
+    {
+        geometry.partOffsets.append(pointCount);
+    }
+    geometry.geometryOffsets[1] = qMax<qsizetype>(0, geometry.partOffsets.size() - 1);
+
+    // Positions having less values than others are completed with NaN
+    if (!geometry.z.isEmpty())
+    {
+        geometry.z.resize(pointCount, NaN);
+    }
+    if (!geometry.m.isEmpty())
+    {
+        geometry.m.resize(pointCount, NaN);
+    }
+
+    // Without z the third value of a position is the m value
+    if (!geometry.hasZ && geometry.hasM)
+    {
+        geometry.m = geometry.z;
+    }
+    if (!geometry.hasZ)
+    {
+        geometry.z.clear();
+    }
+    if (!geometry.hasM)
+    {
+        geometry.m.clear();
+    }
+    if (geometry.hasZ && geometry.z.isEmpty() && 0 < pointCount)
+    {
+        geometry.z.fill(NaN, pointCount);
+    }
+    if (geometry.hasM && geometry.m.isEmpty() && 0 < pointCount)
+    {
+        geometry.m.fill(NaN, pointCount);
+    }
+}
+
+bool EsriJsonGeometryReader::readFlag()
+{
+    if (JsonStreamReader::Bool == m_reader.readNext())
+    {
+        return m_reader.boolean();
+    }
+
+    m_reader.skipCurrentValue();
+    return false;
+}
+
+double EsriJsonGeometryReader::readCoordinate()
+{
+    // Empty geometries use null or "NaN" as coordinates
+    if (JsonStreamReader::Number == m_reader.readNext())
+    {
+        return m_reader.number();
+    }
+
+    m_reader.skipCurrentValue();
+    return NaN;
+}
@@ -0,0 +1,127 @@
+// geoint-mapping offers core mapping and Geospatial Intelligence capabilities for Python.
+// Copyright (C) 2024 Jan Tschada (gisfromscratch@live.de)
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// Additional permission under GNU LGPL version 3 section 4 and 5
+// If you modify this Program, or any covered work, by linking or combining
+// it with ArcGIS Runtime for Qt (or a modified version of that library),
+// containing parts covered by the terms of ArcGIS Runtime for Qt,
+// the licensors of this Program grant you additional permission to convey the resulting work.
+// See <https://developers.arcgis.com/qt/> for further information.
+//
+
+#ifndef ESRIJSONGEOMETRYREADER_H
+#define ESRIJSONGEOMETRYREADER_H
+
+#include "CoordinateArrays.h"
+#include "JsonStreamReader.h"
+
+#include <GeometryTypes.h>
+
+#include <QByteArray>
+#include <QList>
+#include <QString>
+
+/*!
+ * \brief The coordinates of an Esri JSON geometry decoded into columnar buffers.
+ *
+ * Points, multipoints, polylines, polygons and envelopes are decoded with
+ * their z and m values. The parts offsets contain the index of the first
+ * vertex of every path or ring followed by the number of vertices.
+ * Geometries the decoder does not support, like curves, keep their JSON.
+ */
+struct EsriJsonGeometry
+{
+    Esri::ArcGISRuntime::GeometryType type = Esri::ArcGISRuntime::GeometryType::Unknown;
+    int wkid = 0;
+    QString wkt;
+    bool hasZ = false;
+    bool hasM = false;
+    QList<double> x;
+    QList<double> y;
+    QList<double> z;
+    QList<double> m;
+    QList<qint64> partOffsets;
+    qint64 geometryOffsets[2] = { 0, 0 };
+    QByteArray json;
+
+    void clear()
+    {
+        type = Esri::ArcGISRuntime::GeometryType::Unknown;
+        wkid = 0;
+        wkt.clear();
+        hasZ = false;
+        hasM = false;
+        x.clear();
+        y.clear();
+        z.clear();
+        m.clear();
+        partOffsets.clear();
+        geometryOffsets[1] = 0;
+        json.clear();
+    }
+
+    // Views the buffers as the only geometry of the arrays
+    CoordinateArrays coordinates() const
+    {
+        CoordinateArrays coordinates;
+        coordinates.x = x.constData();
+        coordinates.y = y.constData();
+        coordinates.z = z.isEmpty() ? nullptr : z.constData();
+        coordinates.m = m.isEmpty() ? nullptr : m.constData();
+        coordinates.pointCount = x.size();
+        coordinates.partOffsets = partOffsets.constData();
+        coordinates.partCount = qMax<qsizetype>(0, partOffsets.size() - 1);
+        coordinates.geometryOffsets = geometryOffsets;
+        coordinates.geometryCount = 1;
+        return coordinates;
+    }
+};
+
+/*!
+ * \brief Reads the geometries of an Esri JSON array one by one.
+ *
+ * The coordinates are decoded straight from the JSON tokens, no
+ * QJsonDocument is built and no geometry is serialized again.
+ */
+class EsriJsonGeometryReader
+{
+public:
+    explicit EsriJsonGeometryReader(const QByteArray& json);
+
+    bool readNextGeometry(EsriJsonGeometry& geometry);
+    qsizetype readGeometries(QList<EsriJsonGeometry>& geometries, qsizetype maximumCount);
+
+    bool hasError() const;
+    QString errorString() const;
+
+private:
+    bool findGeometries();
+    void readGeometry(EsriJsonGeometry& geometry);
+    void readSpatialReference(EsriJsonGeometry& geometry);
+    void readPositions(EsriJsonGeometry& geometry);
+    void readParts(EsriJsonGeometry& geometry);
+    void finishGeometry(EsriJsonGeometry& geometry);
+    bool readFlag();
+    double readCoordinate();
+
+    QByteArray m_json;
+    JsonStreamReader m_reader;
+    bool m_insideGeometries = false;
+    bool m_finished = false;
+    QString m_errorString;
+};
+
+#endif // ESRIJSONGEOMETRYREADER_H
@@ -0,0 +1,83 @@
+// geoint-mapping offers core mapping and Geospatial Intelligence capabilities for Python.
+// Copyright (C) 2024 Jan Tschada (gisfromscratch@live.de)
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// Additional permission under GNU LGPL version 3 section 4 and 5
+// If you modify this Program, or any covered work, by linking or combining
+// it with ArcGIS Runtime for Qt (or a modified version of that library),
+// containing parts covered by the terms of ArcGIS Runtime for Qt,
+// the licensors of this Program grant you additional permission to convey the resulting work.
+// See <https://developers.arcgis.com/qt/> for further information.
+//
+
+#ifndef FEATUREBINARYFORMAT_H
+#define FEATUREBINARYFORMAT_H
+
+#include <QtGlobal>
+
+/*!
+ * \brief Layout of the binary feature files.
+ *
+ * A file starts with the header, followed by the node boxes of a packed
+ * R-tree, the offset of every feature record and the feature records. The
+ * features are stored in the order of the tree leaves, so features being
+ * close in space are close in the file. All values are little-endian and
+ * every section is aligned to 8 bytes, so the tree and the coordinates can
+ * be used directly from a mapped file. Coordinates are WGS84.
+ *
+ * A feature record is the record header, the interleaved x/y coordinates,
+ * the part and polygon offsets like GeoJsonGeometry and the properties
+ * encoded as CBOR map.
+ */
+namespace FeatureBinaryFormat
+{
+constexpr char Magic[4] = { 'G', 'M', 'F', 'B' };
+constexpr quint32 Version = 1;
+
+struct FileHeader
+{
+    char magic[4];
+    quint32 version;
+    quint64 featureCount;
+    double minX;
+    double minY;
+    double maxX;
+    double maxY;
+    quint64 nodeCount;
+    quint64 reserved;
+};
+
+struct RecordHeader
+{
+    quint8 geometryType;
+    quint8 reserved[3];
+    quint32 pointCount;
+    quint32 partCount;
+    quint32 polygonCount;
+    quint32 propertiesSize;
+    quint32 padding;
+};
+
+static_assert(64 == sizeof(FileHeader), "The file header must not be padded");
+static_assert(Q_BYTE_ORDER == Q_LITTLE_ENDIAN, "Mapped files are used without swapping bytes");
+static_assert(24 == sizeof(RecordHeader), "The record header must not be padded");
+
+constexpr quint64 alignedSize(quint64 size)
+{
+    return (size + 7) & ~quint64(7);
+}
+}
+
+#endif // FEATUREBINARYFORMAT_H
@@ -0,0 +1,208 @@
+// geoint-mapping offers core mapping and Geospatial Intelligence capabilities for Python.
+// Copyright (C) 2024 Jan Tschada (gisfromscratch@live.de)
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// Additional permission under GNU LGPL version 3 section 4 and 5
+// If you modify this Program, or any covered work, by linking or combining
+// it with ArcGIS Runtime for Qt (or a modified version of that library),
+// containing parts covered by the terms of ArcGIS Runtime for Qt,
+// the licensors of this Program grant you additional permission to convey the resulting work.
+// See <https://developers.arcgis.com/qt/> for further information.
+//
+
+#include "FeatureBinaryReader.h"
+#include "FeatureBinaryFormat.h"
+
+#include <QCborMap>
+#include <QCborValue>
+
+#include <algorithm>
+#include <cstring>
+
+using namespace FeatureBinaryFormat;
+
+FeatureBinaryReader::~FeatureBinaryReader()
+{
+    close();
+}
+
+bool FeatureBinaryReader::open(const QString& filePath)
+{
+    close();
+    if (!m_file.open(filePath))
+    {
+        return fail(m_file.errorString());
+    }
+
+    m_data = reinterpret_cast<const uchar*>(m_file.data().constData());
+    m_dataSize = m_file.data().size();
+
+    FileHeader header;
+    if (m_dataSize < qint64(sizeof(header)))
+    {
+        return fail(QStringLiteral("The file is too small!"));
+    }
+    std::memcpy(&header, m_data, sizeof(header));
+    if (0 != std::memcmp(header.magic, Magic, sizeof(Magic)) || Version != header.version)
+    {
+        return fail(QStringLiteral("The file is not a binary feature file of version %1!").arg(Version));
+    }
+
+    const quint64 featureCount = header.featureCount;
+    if (quint64(m_dataSize) / sizeof(quint64) <= featureCount || quint64(m_dataSize) / sizeof(PackedRTree::Box) < header.nodeCount)
+    {
+        return fail(QStringLiteral("The index of the file is corrupt!"));
+    }
+
+    const quint64 nodesBegin = sizeof(header);
+    const quint64 offsetsBegin = nodesBegin + header.nodeCount * sizeof(PackedRTree::Box);
+    const quint64 recordsBegin = offsetsBegin + (featureCount + 1) * sizeof(quint64);
+    if (quint64(PackedRTree::nodeCount(featureCount)) != header.nodeCount || quint64(m_dataSize) < recordsBegin)
+    {
+        return fail(QStringLiteral("The index of the file is corrupt!"));
+    }
+
+    m_recordOffsets = reinterpret_cast<const quint64*>(m_data + offsetsBegin);
+    m_recordsBegin = recordsBegin;
+
+    // Records follow each other, so every record ends within the last one
+    for (quint64 featureIndex = 0; featureIndex < featureCount; featureIndex++)
+    {
+        if (m_recordOffsets[featureIndex + 1] < m_recordOffsets[featureIndex])
+        {
+            return fail(QStringLiteral("The record offsets of the file are corrupt!"));
+        }
+    }
+    if (quint64(m_dataSize) - recordsBegin < m_recordOffsets[featureCount])
+    {
+        return fail(QStringLiteral("The file is truncated!"));
+    }
+
+    m_featureCount = featureCount;
+    m_extent = PackedRTree::Box{ header.minX, header.minY, header.maxX, header.maxY };
+    m_tree = PackedRTree::fromNodes(m_featureCount, reinterpret_cast<const PackedRTree::Box*>(m_data + nodesBegin), header.nodeCount);
+    return true;
+}
+
+void FeatureBinaryReader::close()
+{
+    m_tree = PackedRTree();
+    m_featureCount = 0;
+    m_recordOffsets = nullptr;
+    m_recordsBegin = 0;
+    m_extent = PackedRTree::Box();
+    m_data = nullptr;
+    m_dataSize = 0;
+    m_file.close();
+}
+
+bool FeatureBinaryReader::isOpen() const
+{
+    return nullptr != m_data;
+}
+
+QString FeatureBinaryReader::errorString() const
+{
+    return m_errorString;
+}
+
+qsizetype FeatureBinaryReader::size() const
+{
+    return m_featureCount;
+}
+
+PackedRTree::Box FeatureBinaryReader::extent() const
+{
+    return m_extent;
+}
+
+QList<qsizetype> FeatureBinaryReader::search(const PackedRTree::Box& box) const
+{
+    QList<qsizetype> featureIndices = m_tree.search(box);
+    std::sort(featureIndices.begin(), featureIndices.end());
+    return featureIndices;
+}
+
+bool FeatureBinaryReader::feature(qsizetype featureIndex, GeoJsonFeature& feature) const
+{
+    feature.clear();
+    if (featureIndex < 0 || m_featureCount <= featureIndex)
+    {
+        return false;
+    }
+
+    const quint64 recordBegin = m_recordOffsets[featureIndex];
+    const quint64 recordEnd = m_recordOffsets[featureIndex + 1];
+    RecordHeader header;
+    if (recordEnd < recordBegin || recordEnd - recordBegin < sizeof(header))
+    {
+        return false;
+    }
+
+    const uchar* record = m_data + m_recordsBegin + recordBegin;
+    std::memcpy(&header, record, sizeof(header));
+    const quint64 coordinatesSize = 2 * quint64(header.pointCount) * sizeof(double);
+    const quint64 offsetsSize = (quint64(header.partCount) + header.polygonCount) * sizeof(quint32);
+    if (recordEnd - recordBegin < sizeof(header) + coordinatesSize + offsetsSize + header.propertiesSize
+        || quint8(GeoJsonGeometryType::MultiPolygon) < header.geometryType)
+    {
+        return false;
+    }
+
+    GeoJsonGeometry& geometry = feature.geometry;
+    geometry.type = static_cast<GeoJsonGeometryType>(header.geometryType);
+    const uchar* position = record + sizeof(header);
+    geometry.coordinates.resize(2 * header.pointCount);
+    std::memcpy(geometry.coordinates.data(), position, coordinatesSize);
+    position += coordinatesSize;
+
+    const quint32* offsets = reinterpret_cast<const quint32*>(position);
+    geometry.parts.reserve(header.partCount);
+    for (quint32 partIndex = 0; partIndex < header.partCount; partIndex++)
+    {
+        if (header.pointCount < offsets[partIndex])
+        {
+            feature.clear();
+            return false;
+        }
+        geometry.parts.append(offsets[partIndex]);
+    }
+    offsets += header.partCount;
+    geometry.polygons.reserve(header.polygonCount);
+    for (quint32 polygonIndex = 0; polygonIndex < header.polygonCount; polygonIndex++)
+    {
+        if (header.partCount < offsets[polygonIndex])
+        {
+            feature.clear();
+            return false;
+        }
+        geometry.polygons.append(offsets[polygonIndex]);
+    }
+    position += offsetsSize;
+
+    if (0 < header.propertiesSize)
+    {
+        const QByteArray properties = QByteArray::fromRawData(reinterpret_cast<const char*>(position), header.propertiesSize);
+        feature.properties = QCborValue::fromCbor(properties).toMap().toVariantMap();
+    }
+    return true;
+}
+
+bool FeatureBinaryReader::fail(const QString& errorString)
+{
+    close();
+    m_errorString = errorString;
+    return false;
+}
@@ -0,0 +1,76 @@
+// geoint-mapping offers core mapping and Geospatial Intelligence capabilities for Python.
+// Copyright (C) 2024 Jan Tschada (gisfromscratch@live.de)
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// Additional permission under GNU LGPL version 3 section 4 and 5
+// If you modify this Program, or any covered work, by linking or combining
+// it with ArcGIS Runtime for Qt (or a modified version of that library),
+// containing parts covered by the terms of ArcGIS Runtime for Qt,
+// the licensors of this Program grant you additional permission to convey the resulting work.
+// See <https://developers.arcgis.com/qt/> for further information.
+//
+
+#ifndef FEATUREBINARYREADER_H
+#define FEATUREBINARYREADER_H
+
+#include "GeoJsonFeature.h"
+#include "MappedFile.h"
+#include "PackedRTree.h"
+
+#include <QList>
+#include <QString>
+
+/*!
+ * \brief Reads features from a file in the binary feature format.
+ *
+ * The file is mapped into memory and the spatial index is searched in
+ * place, so a filtered read only touches the pages of the index nodes and
+ * of the records being decoded. Decoding features is thread-safe.
+ */
+class FeatureBinaryReader
+{
+public:
+    FeatureBinaryReader() = default;
+    ~FeatureBinaryReader();
+
+    bool open(const QString& filePath);
+    void close();
+    bool isOpen() const;
+    QString errorString() const;
+
+    qsizetype size() const;
+    PackedRTree::Box extent() const;
+
+    // The features are returned in file order
+    QList<qsizetype> search(const PackedRTree::Box& box) const;
+    bool feature(qsizetype featureIndex, GeoJsonFeature& feature) const;
+
+private:
+    Q_DISABLE_COPY(FeatureBinaryReader)
+
+    bool fail(const QString& errorString);
+
+    MappedFile m_file;
+    const uchar* m_data = nullptr;
+    qint64 m_dataSize = 0;
+    qsizetype m_featureCount = 0;
+    const quint64* m_recordOffsets = nullptr;
+    qint64 m_recordsBegin = 0;
+    PackedRTree::Box m_extent;
+    PackedRTree m_tree;
+    QString m_errorString;
+};
+
+#endif // FEATUREBINARYREADER_H
@@ -0,0 +1,335 @@
+// geoint-mapping offers core mapping and Geospatial Intelligence capabilities for Python.
+// Copyright (C) 2024 Jan Tschada (gisfromscratch@live.de)
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// Additional permission under GNU LGPL version 3 section 4 and 5
+// If you modify this Program, or any covered work, by linking or combining
+// it with ArcGIS Runtime for Qt (or a modified version of that library),
+// containing parts covered by the terms of ArcGIS Runtime for Qt,
+// the licensors of this Program grant you additional permission to convey the resulting work.
+// See <https://developers.arcgis.com/qt/> for further information.
+//
+
+#include "FeatureBinaryWriter.h"
+#include "FeatureBinaryFormat.h"
+#include "GraphicsFactory.h"
+
+#include <AttributeListModel.h>
+#include <Geometry.h>
+#include <GeometryEngine.h>
+#include <Graphic.h>
+#include <GraphicListModel.h>
+#include <GraphicsOverlay.h>
+#include <ImmutablePart.h>
+#include <ImmutablePartCollection.h>
+#include <ImmutablePointCollection.h>
+#include <Multipart.h>
+#include <Multipoint.h>
+#include <Point.h>
+#include <SpatialReference.h>
+
+#include <QCborMap>
+#include <QIODevice>
+#include <QSaveFile>
+
+#include <cstring>
+
+using namespace Esri::ArcGISRuntime;
+using namespace FeatureBinaryFormat;
+
+static bool writeRecord(QIODevice* device, const GeoJsonFeature& feature, QByteArray& record, quint64& recordSize)
+{
+    const GeoJsonGeometry& geometry = feature.geometry;
+    const QByteArray properties = feature.properties.isEmpty() ? QByteArray() : QCborMap::fromVariantMap(feature.properties).toCborValue().toCbor();
+
+    RecordHeader header = {};
+    header.geometryType = static_cast<quint8>(geometry.type);
+    header.pointCount = geometry.pointCount();
+    header.partCount = geometry.partCount();
+    header.polygonCount = geometry.polygonCount();
+    header.propertiesSize = properties.size();
+
+    // The record is assembled in a reused buffer and written at once
+    const qsizetype coordinatesSize = geometry.coordinates.size() * sizeof(double);
+    const qsizetype offsetsSize = (geometry.partCount() + geometry.polygonCount()) * sizeof(quint32);
+    recordSize = alignedSize(sizeof(header) + coordinatesSize + offsetsSize + properties.size());
+    record.resize(recordSize);
+    record.fill('\0');
+    char* position = record.data();
+    std::memcpy(position, &header, sizeof(header));
+    position += sizeof(header);
+    std::memcpy(position, geometry.coordinates.constData(), coordinatesSize);
+    position += coordinatesSize;
+
+    quint32* offsets = reinterpret_cast<quint32*>(position);
+    for (qsizetype part : geometry.parts)
+    {
+        *offsets++ = part;
+    }
+    for (qsizetype polygon : geometry.polygons)
+    {
+        *offsets++ = polygon;
+    }
+    position += offsetsSize;
+    std::memcpy(position, properties.constData(), properties.size());
+
+    return record.size() == device->write(record);
+}
+
+static void appendVertex(GeoJsonGeometry& geometry, const Point& point)
+{
+    geometry.coordinates.append(point.x());
+    geometry.coordinates.append(point.y());
+}
+
+void FeatureBinaryWriter::append(const GeoJsonFeature& feature)
+{
+    m_features.append(feature);
+}
+
+qsizetype FeatureBinaryWriter::append(const GraphicsOverlay* overlay)
+{
+    qsizetype appendedCount = 0;
+    if (nullptr == overlay)
+    {
+        return appendedCount;
+    }
+
+    GraphicListModel* graphics = overlay->graphics();
+    GeoJsonFeature feature;
+    for (int row = 0; row < graphics->size(); row++)
+    {
+        const Graphic* graphic = graphics->at(row);
+        feature.clear();
+        if (!toGeoJsonGeometry(GraphicsFactory::fullGeometry(graphic), feature.geometry))
+        {
+            continue;
+        }
+
+        feature.properties = graphic->attributes()->attributesMap();
+        m_features.append(feature);
+        appendedCount++;
+    }
+
+    return appendedCount;
+}
+
+qsizetype FeatureBinaryWriter::size() const
+{
+    return m_features.size();
+}
+
+bool FeatureBinaryWriter::write(const QString& filePath)
+{
+    // The previous file stays intact until the new one is complete
+    QSaveFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly))
+    {
+        m_errorString = file.errorString();
+        return false;
+    }
+    if (!write(&file))
+    {
+        file.cancelWriting();
+        return false;
+    }
+    if (!file.commit())
+    {
+        m_errorString = file.errorString();
+        return false;
+    }
+
+    return true;
+}
+
+bool FeatureBinaryWriter::write(QIODevice* device)
+{
+    if (nullptr == device || !device->isWritable() || device->isSequential())
+    {
+        m_errorString = QStringLiteral("The device must be writable and support seeking!");
+        return false;
+    }
+
+    const qsizetype featureCount = m_features.size();
+    QList<PackedRTree::Box> boxes;
+    boxes.reserve(featureCount);
+    for (qsizetype featureIndex = 0; featureIndex < featureCount; featureIndex++)
+    {
+        boxes.append(m_features.box(featureIndex));
+    }
+    const PackedRTree tree(boxes);
+    const PackedRTree::Box extent = tree.extent();
+
+    FileHeader header = {};
+    std::memcpy(header.magic, Magic, sizeof(Magic));
+    header.version = Version;
+    header.featureCount = featureCount;
+    header.minX = extent.minX;
+    header.minY = extent.minY;
+    header.maxX = extent.maxX;
+    header.maxY = extent.maxY;
+    header.nodeCount = tree.nodeCount();
+    const qint64 nodesSize = tree.nodeCount() * sizeof(PackedRTree::Box);
+    if (qint64(sizeof(header)) != device->write(reinterpret_cast<const char*>(&header), sizeof(header))
+        || nodesSize != device->write(reinterpret_cast<const char*>(tree.nodes()), nodesSize))
+    {
+        m_errorString = device->errorString();
+        return false;
+    }
+
+    // The offsets are written after the records they point to
+    const qint64 offsetsPosition = device->pos();
+    QList<quint64> recordOffsets(featureCount + 1, 0);
+    const qint64 offsetsSize = recordOffsets.size() * sizeof(quint64);
+    if (offsetsSize != device->write(QByteArray(offsetsSize, '\0')))
+    {
+        m_errorString = device->errorString();
+        return false;
+    }
+
+    // Records follow the leaves of the tree, so the file is spatially ordered
+    GeoJsonFeature feature;
+    QByteArray record;
+    quint64 recordOffset = 0;
+    for (qsizetype leafIndex = 0; leafIndex < featureCount; leafIndex++)
+    {
+        m_features.feature(tree.itemIndex(leafIndex), feature);
+        quint64 recordSize = 0;
+        if (!writeRecord(device, feature, record, recordSize))
+        {
+            m_errorString = device->errorString();
+            return false;
+        }
+        recordOffsets[leafIndex] = recordOffset;
+        recordOffset += recordSize;
+    }
+    recordOffsets[featureCount] = recordOffset;
+
+    const qint64 endPosition = device->pos();
+    if (!device->seek(offsetsPosition)
+        || offsetsSize != device->write(reinterpret_cast<const char*>(recordOffsets.constData()), offsetsSize)
+        || !device->seek(endPosition))
+    {
+        m_errorString = device->errorString();
+        return false;
+    }
+
+    return true;
+}
+
+QString FeatureBinaryWriter::errorString() const
+{
+    return m_errorString;
+}
+
+bool FeatureBinaryWriter::toGeoJsonGeometry(const Geometry& geometry, GeoJsonGeometry& geojsonGeometry)
+{
+    if (geometry.isEmpty())
+    {
+        return false;
+    }
+
+    // The format stores WGS84 coordinates like GeoJSON
+    const SpatialReference wgs84 = SpatialReference::wgs84();
+    const Geometry wgs84Geometry = wgs84 == geometry.spatialReference() ? geometry : GeometryEngine::project(geometry, wgs84);
+    switch (wgs84Geometry.geometryType())
+    {
+    case GeometryType::Point:
+        geojsonGeometry.type = GeoJsonGeometryType::Point;
+        appendVertex(geojsonGeometry, geometry_cast<Point>(wgs84Geometry));
+        return true;
+
+    case GeometryType::Multipoint:
+    {
+        geojsonGeometry.type = GeoJsonGeometryType::MultiPoint;
+        geojsonGeometry.parts.append(0);
+        const ImmutablePointCollection points = geometry_cast<Multipoint>(wgs84Geometry).points();
+        for (qsizetype pointIndex = 0; pointIndex < points.size(); pointIndex++)
+        {
+            appendVertex(geojsonGeometry, points.point(pointIndex));
+        }
+        return true;
+    }
+
+    case GeometryType::Polyline:
+    {
+        const ImmutablePartCollection parts = geometry_cast<Multipart>(wgs84Geometry).parts();
+        for (int partIndex = 0; partIndex < parts.size(); partIndex++)
+        {
+            const ImmutablePart part = parts.part(partIndex);
+            geojsonGeometry.parts.append(geojsonGeometry.pointCount());
+            for (qsizetype pointIndex = 0; pointIndex < part.pointCount(); pointIndex++)
+            {
+                appendVertex(geojsonGeometry, part.point(pointIndex));
+            }
+        }
+
+        geojsonGeometry.type = 1 == parts.size() ? GeoJsonGeometryType::LineString : GeoJsonGeometryType::MultiLineString;
+        if (1 < parts.size())
+        {
+            geojsonGeometry.polygons.append(0);
+        }
+        return true;
+    }
+
+    case GeometryType::Polygon:
+    {
+        // Clockwise rings start a new polygon, counterclockwise rings are its holes
+        const ImmutablePartCollection parts = geometry_cast<Multipart>(wgs84Geometry).parts();
+        for (int partIndex = 0; partIndex < parts.size(); partIndex++)
+        {
+            const ImmutablePart part = parts.part(partIndex);
+            const qsizetype pointCount = part.pointCount();
+            if (0 == pointCount)
+            {
+                continue;
+            }
+
+            const qsizetype firstPoint = geojsonGeometry.pointCount();
+            double signedArea = 0.0;
+            for (qsizetype pointIndex = 0; pointIndex < pointCount; pointIndex++)
+            {
+                const Point point = part.point(pointIndex);
+                const Point nextPoint = part.point((pointIndex + 1) % pointCount);
+                signedArea += point.x() * nextPoint.y() - nextPoint.x() * point.y();
+                appendVertex(geojsonGeometry, point);
+            }
+
+            // GeoJSON rings repeat their first vertex
+            const double* first = geojsonGeometry.vertex(firstPoint);
+            const double* last = geojsonGeometry.vertex(geojsonGeometry.pointCount() - 1);
+            if (first[0] != last[0] || first[1] != last[1])
+            {
+                const double x = first[0];
+                const double y = first[1];
+                geojsonGeometry.coordinates.append(x);
+                geojsonGeometry.coordinates.append(y);
+            }
+
+            if (signedArea < 0.0 || geojsonGeometry.polygons.isEmpty())
+            {
+                geojsonGeometry.polygons.append(geojsonGeometry.partCount());
+            }
+            geojsonGeometry.parts.append(firstPoint);
+        }
+
+        geojsonGeometry.type = 1 < geojsonGeometry.polygonCount() ? GeoJsonGeometryType::MultiPolygon : GeoJsonGeometryType::Polygon;
+        return 0 < geojsonGeometry.pointCount();
+    }
+
+    default:
+        return false;
+    }
+}
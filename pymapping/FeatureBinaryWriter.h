@@ -0,0 +1,71 @@
+// geoint-mapping offers core mapping and Geospatial Intelligence capabilities for Python.
+// Copyright (C) 2024 Jan Tschada (gisfromscratch@live.de)
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// Additional permission under GNU LGPL version 3 section 4 and 5
+// If you modify this Program, or any covered work, by linking or combining
+// it with ArcGIS Runtime for Qt (or a modified version of that library),
+// containing parts covered by the terms of ArcGIS Runtime for Qt,
+// the licensors of this Program grant you additional permission to convey the resulting work.
+// See <https://developers.arcgis.com/qt/> for further information.
+//
+
+#ifndef FEATUREBINARYWRITER_H
+#define FEATUREBINARYWRITER_H
+
+#include "GeoJsonFeatureStore.h"
+
+namespace Esri
+{
+namespace ArcGISRuntime
+{
+class Geometry;
+class GraphicsOverlay;
+}
+}
+
+#include <QString>
+
+class QIODevice;
+
+/*!
+ * \brief Writes features into the binary feature format.
+ *
+ * The features are collected first, because the spatial index and the
+ * order of the records are only known when all features are present.
+ * Graphics are converted into features having their attributes as
+ * properties and their full geometry, not the level of detail shown.
+ */
+class FeatureBinaryWriter
+{
+public:
+    void append(const GeoJsonFeature& feature);
+    qsizetype append(const Esri::ArcGISRuntime::GraphicsOverlay* overlay);
+    qsizetype size() const;
+
+    bool write(const QString& filePath);
+    bool write(QIODevice* device);
+    QString errorString() const;
+
+    // Graphics of any spatial reference become WGS84 GeoJSON geometries
+    static bool toGeoJsonGeometry(const Esri::ArcGISRuntime::Geometry& geometry, GeoJsonGeometry& geojsonGeometry);
+
+private:
+
+    GeoJsonFeatureStore m_features;
+    QString m_errorString;
+};
+
+#endif // FEATUREBINARYWRITER_H
@@ -0,0 +1,92 @@
+// geoint-mapping offers core mapping and Geospatial Intelligence capabilities for Python.
+// Copyright (C) 2024 Jan Tschada (gisfromscratch@live.de)
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// Additional permission under GNU LGPL version 3 section 4 and 5
+// If you modify this Program, or any covered work, by linking or combining
+// it with ArcGIS Runtime for Qt (or a modified version of that library),
+// containing parts covered by the terms of ArcGIS Runtime for Qt,
+// the licensors of this Program grant you additional permission to convey the resulting work.
+// See <https://developers.arcgis.com/qt/> for further information.
+//
+
+#ifndef GEOELEMENTCOLUMNS_H
+#define GEOELEMENTCOLUMNS_H
+
+#include <GeometryTypes.h>
+
+#include <QList>
+#include <QString>
+#include <QStringList>
+
+/*!
+ * \brief The value type of an attribute column.
+ *
+ * Mixed columns are widened in this order, booleans become integers,
+ * integers become doubles and everything else becomes a string.
+ */
+enum class GeoElementColumnType
+{
+    Null,
+    Boolean,
+    Integer,
+    Double,
+    String
+};
+
+/*!
+ * \brief One attribute of all geoelements stored as a typed array.
+ *
+ * Only the buffer matching the type is filled. Missing values are marked
+ * in the nulls buffer, which stays empty when there are none.
+ */
+struct GeoElementColumn
+{
+    QString name;
+    GeoElementColumnType type = GeoElementColumnType::Null;
+    QList<quint8> booleans;
+    QList<qint64> integers;
+    QList<double> doubles;
+    QStringList strings;
+    QList<quint8> nulls;
+    qsizetype nullCount = 0;
+};
+
+/*!
+ * \brief Columnar copy of the geoelements of a graphics overlay.
+ *
+ * The coordinates use the layout of CoordinateArrays, so the buffers can be
+ * handed back to the array based entry points without any conversion.
+ * Points have no offsets, multipoints have one part per geoelement,
+ * polylines and polygons have a geometry offset for every geoelement.
+ * Geoelements without a geometry of the overlay type have no parts or
+ * NaN coordinates in case of points.
+ */
+struct GeoElementColumns
+{
+    Esri::ArcGISRuntime::GeometryType geometryType = Esri::ArcGISRuntime::GeometryType::Unknown;
+    qsizetype rowCount = 0;
+    bool hasZ = false;
+
+    QList<double> x;
+    QList<double> y;
+    QList<double> z;
+    QList<qint64> partOffsets;
+    QList<qint64> geometryOffsets;
+
+    QList<GeoElementColumn> attributes;
+};
+
+#endif // GEOELEMENTCOLUMNS_H
@@ -2,11 +2,23 @@
 
 #include <AttributeListModel.h>
 #include <GeoElement.h>
+#include <Envelope.h>
 #include <Geometry.h>
+#include <GeometryEngine.h>
 #include <Graphic.h>
 #include <GraphicListModel.h>
 #include <GraphicsOverlay.h>
 #include <GraphicsOverlayListModel.h>
+#include <ImmutablePart.h>
+#include <ImmutablePartCollection.h>
+#include <ImmutablePointCollection.h>
+#include <Multipart.h>
+#include <Multipoint.h>
+#include <Point.h>
+
+#include <QHash>
+
+#include <algorithm>
 
 using namespace Esri::ArcGISRuntime;
 
@@ -36,31 +48,369 @@ int GeoElementsOverlayModel::count() const
     return m_overlayListModel->rowCount();
 }
 
-QVariantList GeoElementsOverlayModel::toDict(int index) const
+GraphicsOverlay* GeoElementsOverlayModel::overlayAt(int index) const
 {
-    QVariantList geoElements;
     if (index < 0 || this->count() <= index)
     {
-        return geoElements;
+        return nullptr;
     }
     if (nullptr == m_overlayListModel)
     {
         qWarning() << "Model has no valid instance of GeoElementsOverlayModel!";
+        return nullptr;
+    }
+
+    return m_overlayListModel->at(index);
+}
+
+int GeoElementsOverlayModel::getElementCount(int index) const
+{
+    GraphicsOverlay* overlay = overlayAt(index);
+    if (nullptr == overlay)
+    {
+        return -1;
+    }
+
+    return overlay->graphics()->size();
+}
+
+QVariantList GeoElementsOverlayModel::toDict(int index) const
+{
+    return toDictRange(index, 0, -1);
+}
+
+static Geometry simplifyGeometry(const Geometry& geometry, double maxDeviation)
+{
+    switch (geometry.geometryType())
+    {
+    case GeometryType::Polyline:
+    case GeometryType::Polygon:
+        break;
+    default:
+        return geometry;
+    }
+
+    if (maxDeviation <= 0.0)
+    {
+        // Keep the shape recognizable at the size of the geometry itself
+        const Envelope extent = geometry.extent();
+        maxDeviation = qMax(extent.width(), extent.height()) / 1000.0;
+    }
+    if (maxDeviation <= 0.0)
+    {
+        return geometry;
+    }
+
+    return GeometryEngine::generalize(geometry, maxDeviation, true);
+}
+
+QVariantList GeoElementsOverlayModel::toDictRange(int index, int offset, int limit,
+                                                  const QStringList& fields,
+                                                  GeometryOutput geometryOutput,
+                                                  double maxDeviation) const
+{
+    QVariantList geoElements;
+    GraphicsOverlay* overlay = overlayAt(index);
+    if (nullptr == overlay || offset < 0)
+    {
         return geoElements;
     }
 
-    GraphicsOverlay* overlay = m_overlayListModel->at(index);
+    // Only the graphics of the requested page are visited
     GraphicListModel* graphics = overlay->graphics();
-    QList<GeoElement*> graphicsList;
-    graphicsList.reserve(graphics->size());
-    std::for_each(graphics->begin(), graphics->end(), [&geoElements](Graphic* graphic)
+    const int graphicsCount = graphics->size();
+    const int end = (limit < 0) ? graphicsCount : static_cast<int>(qMin<qint64>(graphicsCount, static_cast<qint64>(offset) + limit));
+    if (end <= offset)
     {
+        return geoElements;
+    }
+
+    geoElements.reserve(end - offset);
+    for (int graphicIndex = offset; graphicIndex < end; graphicIndex++)
+    {
+        Graphic* graphic = graphics->at(graphicIndex);
         AttributeListModel* attributes = graphic->attributes();
-        QVariantMap attributesMap = attributes->attributesMap();
-        Geometry geometry = graphic->geometry();
-        attributesMap.insert("geometry", geometry.toJson());
-        geoElements.append(attributesMap);
-    });
+        QVariantMap geoElement;
+        if (fields.isEmpty())
+        {
+            geoElement = attributes->attributesMap();
+        }
+        else
+        {
+            for (const QString& field : fields)
+            {
+                if (attributes->containsAttribute(field))
+                {
+                    geoElement.insert(field, attributes->attributeValue(field));
+                }
+            }
+        }
+
+        switch (geometryOutput)
+        {
+        case GeometryOutput::FullGeometry:
+            geoElement.insert("geometry", graphic->geometry().toJson());
+            break;
+        case GeometryOutput::SimplifiedGeometry:
+            geoElement.insert("geometry", simplifyGeometry(graphic->geometry(), maxDeviation).toJson());
+            break;
+        case GeometryOutput::NoGeometry:
+            break;
+        }
+        geoElements.append(geoElement);
+    }
 
     return geoElements;
 }
+
+static void appendVertex(GeoElementColumns& columns, const Point& point)
+{
+    columns.x.append(point.x());
+    columns.y.append(point.y());
+    if (columns.hasZ)
+    {
+        columns.z.append(point.hasZ() ? point.z() : qQNaN());
+    }
+}
+
+static void appendParts(GeoElementColumns& columns, const Multipart& multipart)
+{
+    const ImmutablePartCollection parts = multipart.parts();
+    for (int partIndex = 0; partIndex < parts.size(); partIndex++)
+    {
+        const ImmutablePart part = parts.part(partIndex);
+        const qsizetype pointCount = part.pointCount();
+        for (qsizetype pointIndex = 0; pointIndex < pointCount; pointIndex++)
+        {
+            appendVertex(columns, part.point(pointIndex));
+        }
+        columns.partOffsets.append(columns.x.size());
+    }
+}
+
+static void appendGeometry(GeoElementColumns& columns, const Geometry& geometry)
+{
+    const bool matchesType = !geometry.isEmpty() && columns.geometryType == geometry.geometryType();
+    switch (columns.geometryType)
+    {
+    case GeometryType::Point:
+        if (matchesType)
+        {
+            appendVertex(columns, geometry_cast<Point>(geometry));
+        }
+        else
+        {
+            columns.x.append(qQNaN());
+            columns.y.append(qQNaN());
+            if (columns.hasZ)
+            {
+                columns.z.append(qQNaN());
+            }
+        }
+        break;
+
+    case GeometryType::Multipoint:
+        if (matchesType)
+        {
+            const ImmutablePointCollection points = geometry_cast<Multipoint>(geometry).points();
+            for (qsizetype pointIndex = 0; pointIndex < points.size(); pointIndex++)
+            {
+                appendVertex(columns, points.point(pointIndex));
+            }
+        }
+        columns.partOffsets.append(columns.x.size());
+        break;
+
+    case GeometryType::Polyline:
+    case GeometryType::Polygon:
+        if (matchesType)
+        {
+            appendParts(columns, geometry_cast<Multipart>(geometry));
+        }
+        columns.geometryOffsets.append(columns.partOffsets.size() - 1);
+        break;
+
+    default:
+        break;
+    }
+}
+
+static GeoElementColumnType columnType(const QVariant& value)
+{
+    switch (value.typeId())
+    {
+    case QMetaType::Bool:
+        return GeoElementColumnType::Boolean;
+
+    case QMetaType::Char:
+    case QMetaType::SChar:
+    case QMetaType::UChar:
+    case QMetaType::Short:
+    case QMetaType::UShort:
+    case QMetaType::Int:
+    case QMetaType::UInt:
+    case QMetaType::Long:
+    case QMetaType::ULong:
+    case QMetaType::LongLong:
+    case QMetaType::ULongLong:
+        return GeoElementColumnType::Integer;
+
+    case QMetaType::Float:
+    case QMetaType::Double:
+        return GeoElementColumnType::Double;
+
+    default:
+        return GeoElementColumnType::String;
+    }
+}
+
+static bool isNull(const QVariant& value)
+{
+    return !value.isValid() || value.isNull();
+}
+
+static void fillColumn(GeoElementColumn& column, const QVariantList& values)
+{
+    // The widest type of all values decides the column type
+    for (const QVariant& value : values)
+    {
+        if (isNull(value))
+        {
+            column.nullCount++;
+        }
+        else
+        {
+            column.type = std::max(column.type, columnType(value));
+        }
+    }
+
+    const qsizetype rowCount = values.size();
+    if (0 < column.nullCount)
+    {
+        column.nulls.resize(rowCount);
+    }
+    switch (column.type)
+    {
+    case GeoElementColumnType::Boolean:
+        column.booleans.resize(rowCount);
+        break;
+    case GeoElementColumnType::Integer:
+        column.integers.resize(rowCount);
+        break;
+    case GeoElementColumnType::Null:
+    case GeoElementColumnType::Double:
+        column.doubles.resize(rowCount);
+        break;
+    case GeoElementColumnType::String:
+        column.strings.resize(rowCount);
+        break;
+    }
+
+    for (qsizetype row = 0; row < rowCount; row++)
+    {
+        const QVariant& value = values.at(row);
+        if (isNull(value))
+        {
+            column.nulls[row] = 1;
+            if (!column.doubles.isEmpty())
+            {
+                column.doubles[row] = qQNaN();
+            }
+            continue;
+        }
+
+        switch (column.type)
+        {
+        case GeoElementColumnType::Boolean:
+            column.booleans[row] = value.toBool() ? 1 : 0;
+            break;
+        case GeoElementColumnType::Integer:
+            column.integers[row] = value.toLongLong();
+            break;
+        case GeoElementColumnType::Null:
+        case GeoElementColumnType::Double:
+            column.doubles[row] = value.toDouble();
+            break;
+        case GeoElementColumnType::String:
+            column.strings[row] = value.toString();
+            break;
+        }
+    }
+}
+
+GeoElementColumns GeoElementsOverlayModel::toColumns(int index) const
+{
+    GeoElementColumns columns;
+    GraphicsOverlay* overlay = overlayAt(index);
+    if (nullptr == overlay)
+    {
+        return columns;
+    }
+
+    GraphicListModel* graphics = overlay->graphics();
+    const qsizetype rowCount = graphics->size();
+    columns.rowCount = rowCount;
+
+    // The first non-empty geometry decides the layout of the coordinates
+    auto firstGeometry = std::find_if(graphics->begin(), graphics->end(), [](Graphic* graphic)
+    {
+        return !graphic->geometry().isEmpty();
+    });
+    if (graphics->end() != firstGeometry)
+    {
+        Geometry geometry = (*firstGeometry)->geometry();
+        columns.geometryType = geometry.geometryType();
+        columns.hasZ = geometry.hasZ();
+    }
+    switch (columns.geometryType)
+    {
+    case GeometryType::Point:
+        columns.x.reserve(rowCount);
+        columns.y.reserve(rowCount);
+        columns.z.reserve(columns.hasZ ? rowCount : 0);
+        break;
+    case GeometryType::Multipoint:
+        columns.partOffsets.reserve(rowCount + 1);
+        columns.partOffsets.append(0);
+        break;
+    case GeometryType::Polyline:
+    case GeometryType::Polygon:
+        columns.partOffsets.append(0);
+        columns.geometryOffsets.reserve(rowCount + 1);
+        columns.geometryOffsets.append(0);
+        break;
+    default:
+        break;
+    }
+
+    QHash<QString, qsizetype> columnIndices;
+    QList<QVariantList> columnValues;
+    qsizetype row = 0;
+    std::for_each(graphics->begin(), graphics->end(), [&](Graphic* graphic)
+    {
+        appendGeometry(columns, graphic->geometry());
+
+        const QVariantMap attributesMap = graphic->attributes()->attributesMap();
+        for (auto attribute = attributesMap.cbegin(); attribute != attributesMap.cend(); attribute++)
+        {
+            auto columnIndex = columnIndices.constFind(attribute.key());
+            if (columnIndices.cend() == columnIndex)
+            {
+                // Geoelements without this attribute are marked as null
+                columnIndex = columnIndices.insert(attribute.key(), columns.attributes.size());
+                columns.attributes.append(GeoElementColumn{attribute.key()});
+                columnValues.append(QVariantList(rowCount));
+            }
+            columnValues[columnIndex.value()][row] = attribute.value();
+        }
+        row++;
+    });
+
+    for (qsizetype columnIndex = 0; columnIndex < columns.attributes.size(); columnIndex++)
+    {
+        fillColumn(columns.attributes[columnIndex], columnValues.at(columnIndex));
+        columnValues[columnIndex].clear();
+    }
+
+    return columns;
+}
@@ -1,11 +1,15 @@
 #ifndef GEOELEMENTOVERLAYMODEL_H
 #define GEOELEMENTOVERLAYMODEL_H
 
+#include "GeoElementColumns.h"
+
 #include <QObject>
+#include <QStringList>
 #include <QVariantList>
 #include <QQmlEngine>
 
 namespace Esri::ArcGISRuntime {
+class GraphicsOverlay;
 class GraphicsOverlayListModel;
 } // namespace Esri::ArcGISRuntime
 
@@ -18,16 +22,33 @@ class GeoElementsOverlayModel : public QObject
 public:
     explicit GeoElementsOverlayModel(QObject *parent = nullptr);
 
+    enum class GeometryOutput {
+        FullGeometry,
+        SimplifiedGeometry,
+        NoGeometry
+    };
+
+    Q_ENUM(GeometryOutput)
+
     void init(Esri::ArcGISRuntime::GraphicsOverlayListModel* overlayListModel);
 
     Q_INVOKABLE int getCount() const;
 
+    Q_INVOKABLE int getElementCount(int index) const;
+
     Q_INVOKABLE QVariantList toDict(int index) const;
+    Q_INVOKABLE QVariantList toDictRange(int index, int offset, int limit,
+                                         const QStringList& fields = QStringList(),
+                                         GeometryOutput geometryOutput = GeometryOutput::FullGeometry,
+                                         double maxDeviation = 0.0) const;
+
+    GeoElementColumns toColumns(int index) const;
 
 signals:
 
 private:
     int count() const;
+    Esri::ArcGISRuntime::GraphicsOverlay* overlayAt(int index) const;
 
     Esri::ArcGISRuntime::GraphicsOverlayListModel* m_overlayListModel;
 };
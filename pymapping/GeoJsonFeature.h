@@ -0,0 +1,117 @@
+// geoint-mapping offers core mapping and Geospatial Intelligence capabilities for Python.
+// Copyright (C) 2024 Jan Tschada (gisfromscratch@live.de)
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// Additional permission under GNU LGPL version 3 section 4 and 5
+// If you modify this Program, or any covered work, by linking or combining
+// it with ArcGIS Runtime for Qt (or a modified version of that library),
+// containing parts covered by the terms of ArcGIS Runtime for Qt,
+// the licensors of this Program grant you additional permission to convey the resulting work.
+// See <https://developers.arcgis.com/qt/> for further information.
+//
+
+#ifndef GEOJSONFEATURE_H
+#define GEOJSONFEATURE_H
+
+#include <QList>
+#include <QVariantMap>
+
+enum class GeoJsonGeometryType
+{
+    Unknown,
+    Point,
+    MultiPoint,
+    LineString,
+    MultiLineString,
+    Polygon,
+    MultiPolygon
+};
+
+/*!
+ * \brief The coordinates of a GeoJSON geometry decoded into contiguous buffers.
+ *
+ * All vertices are stored as interleaved x/y pairs. The parts list contains
+ * the index of the first vertex of every line string or ring, the polygons
+ * list contains the index of the first part of every polygon.
+ */
+struct GeoJsonGeometry
+{
+    GeoJsonGeometryType type = GeoJsonGeometryType::Unknown;
+    QList<double> coordinates;
+    QList<qsizetype> parts;
+    QList<qsizetype> polygons;
+
+    void clear()
+    {
+        type = GeoJsonGeometryType::Unknown;
+        coordinates.clear();
+        parts.clear();
+        polygons.clear();
+    }
+
+    qsizetype pointCount() const
+    {
+        return coordinates.size() / 2;
+    }
+
+    const double* vertex(qsizetype pointIndex) const
+    {
+        return coordinates.constData() + 2 * pointIndex;
+    }
+
+    qsizetype partCount() const
+    {
+        return parts.size();
+    }
+
+    qsizetype partBegin(qsizetype partIndex) const
+    {
+        return parts.at(partIndex);
+    }
+
+    qsizetype partEnd(qsizetype partIndex) const
+    {
+        return (partIndex + 1 < parts.size()) ? parts.at(partIndex + 1) : pointCount();
+    }
+
+    qsizetype polygonCount() const
+    {
+        return polygons.size();
+    }
+
+    qsizetype polygonBegin(qsizetype polygonIndex) const
+    {
+        return polygons.at(polygonIndex);
+    }
+
+    qsizetype polygonEnd(qsizetype polygonIndex) const
+    {
+        return (polygonIndex + 1 < polygons.size()) ? polygons.at(polygonIndex + 1) : partCount();
+    }
+};
+
+struct GeoJsonFeature
+{
+    GeoJsonGeometry geometry;
+    QVariantMap properties;
+
+    void clear()
+    {
+        geometry.clear();
+        properties.clear();
+    }
+};
+
+#endif // GEOJSONFEATURE_H
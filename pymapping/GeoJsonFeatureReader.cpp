@@ -0,0 +1,286 @@
+// geoint-mapping offers core mapping and Geospatial Intelligence capabilities for Python.
+// Copyright (C) 2024 Jan Tschada (gisfromscratch@live.de)
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// Additional permission under GNU LGPL version 3 section 4 and 5
+// If you modify this Program, or any covered work, by linking or combining
+// it with ArcGIS Runtime for Qt (or a modified version of that library),
+// containing parts covered by the terms of ArcGIS Runtime for Qt,
+// the licensors of this Program grant you additional permission to convey the resulting work.
+// See <https://developers.arcgis.com/qt/> for further information.
+//
+#include "GeoJsonFeatureReader.h"
+
+#include "JsonStreamReader.h"
+
+static GeoJsonGeometryType toGeometryType(const QByteArray& geometryType)
+{
+    if ("Point" == geometryType)
+    {
+        return GeoJsonGeometryType::Point;
+    }
+    if ("MultiPoint" == geometryType)
+    {
+        return GeoJsonGeometryType::MultiPoint;
+    }
+    if ("LineString" == geometryType)
+    {
+        return GeoJsonGeometryType::LineString;
+    }
+    if ("MultiLineString" == geometryType)
+    {
+        return GeoJsonGeometryType::MultiLineString;
+    }
+    if ("Polygon" == geometryType)
+    {
+        return GeoJsonGeometryType::Polygon;
+    }
+    if ("MultiPolygon" == geometryType)
+    {
+        return GeoJsonGeometryType::MultiPolygon;
+    }
+
+    return GeoJsonGeometryType::Unknown;
+}
+
+GeoJsonFeatureReader::GeoJsonFeatureReader(JsonStreamReader& reader) :
+    m_reader(reader)
+{
+}
+
+bool GeoJsonFeatureReader::readNextFeature(GeoJsonFeature& feature)
+{
+    if (!m_insideFeatures && !findFeatures())
+    {
+        return false;
+    }
+
+    JsonStreamReader::TokenType tokenType = m_reader.readNext();
+    while (JsonStreamReader::StartObject != tokenType)
+    {
+        if (JsonStreamReader::EndArray == tokenType || m_reader.atEnd())
+        {
+            m_insideFeatures = false;
+            m_finished = true;
+            return false;
+        }
+
+        // Anything else than an object is not a feature
+        m_reader.skipCurrentValue();
+        tokenType = m_reader.readNext();
+    }
+
+    readFeature(feature);
+    return !m_reader.hasError();
+}
+
+qsizetype GeoJsonFeatureReader::readFeatures(QList<GeoJsonFeature>& features, qsizetype maximumCount)
+{
+    qsizetype featureCount = 0;
+    features.reserve(features.size() + maximumCount);
+    while (featureCount < maximumCount)
+    {
+        GeoJsonFeature& feature = features.emplaceBack();
+        if (!readNextFeature(feature))
+        {
+            features.removeLast();
+            break;
+        }
+        featureCount++;
+    }
+
+    return featureCount;
+}
+
+bool GeoJsonFeatureReader::hasError() const
+{
+    return m_reader.hasError() || !m_errorString.isEmpty();
+}
+
+QString GeoJsonFeatureReader::errorString() const
+{
+    return m_reader.hasError() ? m_reader.errorString() : m_errorString;
+}
+
+bool GeoJsonFeatureReader::findFeatures()
+{
+    if (m_finished)
+    {
+        return false;
+    }
+
+    // A feature collection contains exactly one features array
+    m_finished = true;
+    if (JsonStreamReader::StartObject != m_reader.readNext())
+    {
+        m_errorString = "JSON document is not an object!";
+        return false;
+    }
+
+    while (JsonStreamReader::Name == m_reader.readNext())
+    {
+        if ("features" == m_reader.utf8Text())
+        {
+            if (JsonStreamReader::StartArray == m_reader.readNext())
+            {
+                m_insideFeatures = true;
+                m_finished = false;
+                return true;
+            }
+        }
+        m_reader.skipCurrentValue();
+    }
+
+    return false;
+}
+
+void GeoJsonFeatureReader::readFeature(GeoJsonFeature& feature)
+{
+    feature.clear();
+    while (JsonStreamReader::Name == m_reader.readNext())
+    {
+        if ("geometry" == m_reader.utf8Text())
+        {
+            if (JsonStreamReader::StartObject == m_reader.readNext())
+            {
+                readGeometry(feature.geometry);
+            }
+            else
+            {
+                m_reader.skipCurrentValue();
+            }
+        }
+        else if ("properties" == m_reader.utf8Text())
+        {
+            if (JsonStreamReader::StartObject == m_reader.readNext())
+            {
+                feature.properties = m_reader.readCurrentVariant().toMap();
+            }
+            else
+            {
+                m_reader.skipCurrentValue();
+            }
+        }
+        else
+        {
+            m_reader.skipCurrentValue();
+        }
+    }
+}
+
+void GeoJsonFeatureReader::readGeometry(GeoJsonGeometry& geometry)
+{
+    while (JsonStreamReader::Name == m_reader.readNext())
+    {
+        if ("type" == m_reader.utf8Text())
+        {
+            if (JsonStreamReader::String == m_reader.readNext())
+            {
+                geometry.type = toGeometryType(m_reader.utf8Text());
+            }
+            else
+            {
+                m_reader.skipCurrentValue();
+            }
+        }
+        else if ("coordinates" == m_reader.utf8Text())
+        {
+            if (JsonStreamReader::StartArray != m_reader.readNext())
+            {
+                m_reader.skipCurrentValue();
+                continue;
+            }
+
+            // The nesting depth tells which offsets the outermost array contributes
+            switch (readCoordinates(geometry))
+            {
+            case 2:
+                geometry.parts.append(0);
+                break;
+            case 3:
+                geometry.polygons.append(0);
+                break;
+            default:
+                break;
+            }
+        }
+        else
+        {
+            m_reader.skipCurrentValue();
+        }
+    }
+}
+
+int GeoJsonFeatureReader::readCoordinates(GeoJsonGeometry& geometry)
+{
+    JsonStreamReader::TokenType tokenType = m_reader.readNext();
+    if (JsonStreamReader::Number == tokenType)
+    {
+        // A position, only x and y are kept
+        double x = m_reader.number();
+        double y = 0;
+        int dimension = 1;
+        for (tokenType = m_reader.readNext(); JsonStreamReader::Number == tokenType; tokenType = m_reader.readNext())
+        {
+            if (1 == dimension)
+            {
+                y = m_reader.number();
+            }
+            dimension++;
+        }
+        skipToEndOfArray();
+
+        if (1 < dimension)
+        {
+            geometry.coordinates.append(x);
+            geometry.coordinates.append(y);
+        }
+        return 1;
+    }
+
+    int depth = 0;
+    for (; JsonStreamReader::StartArray == tokenType; tokenType = m_reader.readNext())
+    {
+        qsizetype firstPoint = geometry.pointCount();
+        qsizetype firstPart = geometry.partCount();
+        int childDepth = readCoordinates(geometry);
+        if (2 == childDepth)
+        {
+            geometry.parts.append(firstPoint);
+        }
+        else if (3 == childDepth)
+        {
+            geometry.polygons.append(firstPart);
+        }
+
+        if (0 < childDepth)
+        {
+            depth = qMax(depth, childDepth + 1);
+        }
+    }
+    skipToEndOfArray();
+
+    return depth;
+}
+
+void GeoJsonFeatureReader::skipToEndOfArray()
+{
+    JsonStreamReader::TokenType tokenType = m_reader.tokenType();
+    while (JsonStreamReader::EndArray != tokenType && !m_reader.atEnd())
+    {
+        m_reader.skipCurrentValue();
+        tokenType = m_reader.readNext();
+    }
+}
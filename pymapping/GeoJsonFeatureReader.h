@@ -0,0 +1,66 @@
+// geoint-mapping offers core mapping and Geospatial Intelligence capabilities for Python.
+// Copyright (C) 2024 Jan Tschada (gisfromscratch@live.de)
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// Additional permission under GNU LGPL version 3 section 4 and 5
+// If you modify this Program, or any covered work, by linking or combining
+// it with ArcGIS Runtime for Qt (or a modified version of that library),
+// containing parts covered by the terms of ArcGIS Runtime for Qt,
+// the licensors of this Program grant you additional permission to convey the resulting work.
+// See <https://developers.arcgis.com/qt/> for further information.
+//
+
+#ifndef GEOJSONFEATUREREADER_H
+#define GEOJSONFEATUREREADER_H
+
+#include "GeoJsonFeature.h"
+
+#include <QString>
+
+class JsonStreamReader;
+
+/*!
+ * \brief Reads the features of a GeoJSON feature collection one by one.
+ *
+ * The coordinates are decoded straight from the JSON tokens into the
+ * contiguous buffers of a GeoJsonFeature without any QJsonValue in between.
+ * The same feature instance should be reused, so that its buffers are only
+ * allocated once.
+ */
+class GeoJsonFeatureReader
+{
+public:
+    explicit GeoJsonFeatureReader(JsonStreamReader& reader);
+
+    bool readNextFeature(GeoJsonFeature& feature);
+    qsizetype readFeatures(QList<GeoJsonFeature>& features, qsizetype maximumCount);
+
+    bool hasError() const;
+    QString errorString() const;
+
+private:
+    bool findFeatures();
+    void readFeature(GeoJsonFeature& feature);
+    void readGeometry(GeoJsonGeometry& geometry);
+    int readCoordinates(GeoJsonGeometry& geometry);
+    void skipToEndOfArray();
+
+    JsonStreamReader& m_reader;
+    bool m_insideFeatures = false;
+    bool m_finished = false;
+    QString m_errorString;
+};
+
+#endif // GEOJSONFEATUREREADER_H
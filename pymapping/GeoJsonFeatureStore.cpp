@@ -0,0 +1,126 @@
+// geoint-mapping offers core mapping and Geospatial Intelligence capabilities for Python.
+// Copyright (C) 2024 Jan Tschada (gisfromscratch@live.de)
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// Additional permission under GNU LGPL version 3 section 4 and 5
+// If you modify this Program, or any covered work, by linking or combining
+// it with ArcGIS Runtime for Qt (or a modified version of that library),
+// containing parts covered by the terms of ArcGIS Runtime for Qt,
+// the licensors of this Program grant you additional permission to convey the resulting work.
+// See <https://developers.arcgis.com/qt/> for further information.
+//
+
+#include "GeoJsonFeatureStore.h"
+
+void GeoJsonFeatureStore::append(const GeoJsonFeature& feature)
+{
+    const GeoJsonGeometry& geometry = feature.geometry;
+    FeatureRecord record;
+    record.type = geometry.type;
+    record.coordinatesBegin = m_coordinates.size();
+    record.partsBegin = m_parts.size();
+    record.polygonsBegin = m_polygons.size();
+    m_records.append(record);
+
+    // Offsets stay relative to the feature
+    m_coordinates.append(geometry.coordinates);
+    m_parts.append(geometry.parts);
+    m_polygons.append(geometry.polygons);
+    m_properties.append(feature.properties);
+
+    PackedRTree::Box box;
+    for (qsizetype pointIndex = 0; pointIndex < geometry.pointCount(); pointIndex++)
+    {
+        const double* vertex = geometry.vertex(pointIndex);
+        box.expand(PackedRTree::Box{ vertex[0], vertex[1], vertex[0], vertex[1] });
+    }
+    m_boxes.append(box);
+}
+
+void GeoJsonFeatureStore::buildIndex()
+{
+    m_coordinates.squeeze();
+    m_parts.squeeze();
+    m_polygons.squeeze();
+    m_properties.squeeze();
+    m_tree = PackedRTree(m_boxes);
+}
+
+void GeoJsonFeatureStore::clear()
+{
+    m_records.clear();
+    m_coordinates.clear();
+    m_parts.clear();
+    m_polygons.clear();
+    m_properties.clear();
+    m_boxes.clear();
+    m_tree = PackedRTree();
+}
+
+qsizetype GeoJsonFeatureStore::size() const
+{
+    return m_records.size();
+}
+
+bool GeoJsonFeatureStore::isEmpty() const
+{
+    return m_records.isEmpty();
+}
+
+PackedRTree::Box GeoJsonFeatureStore::extent() const
+{
+    return m_tree.extent();
+}
+
+GeoJsonGeometryType GeoJsonFeatureStore::geometryType(qsizetype featureIndex) const
+{
+    return m_records.at(featureIndex).type;
+}
+
+PackedRTree::Box GeoJsonFeatureStore::box(qsizetype featureIndex) const
+{
+    return m_boxes.at(featureIndex);
+}
+
+void GeoJsonFeatureStore::feature(qsizetype featureIndex, GeoJsonFeature& feature) const
+{
+    const FeatureRecord& record = m_records.at(featureIndex);
+    const FeatureRecord end = recordEnd(featureIndex);
+    GeoJsonGeometry& geometry = feature.geometry;
+    geometry.type = record.type;
+    geometry.coordinates = m_coordinates.mid(record.coordinatesBegin, end.coordinatesBegin - record.coordinatesBegin);
+    geometry.parts = m_parts.mid(record.partsBegin, end.partsBegin - record.partsBegin);
+    geometry.polygons = m_polygons.mid(record.polygonsBegin, end.polygonsBegin - record.polygonsBegin);
+    feature.properties = m_properties.attributes(featureIndex);
+}
+
+QList<qsizetype> GeoJsonFeatureStore::search(const PackedRTree::Box& box) const
+{
+    return m_tree.search(box);
+}
+
+GeoJsonFeatureStore::FeatureRecord GeoJsonFeatureStore::recordEnd(qsizetype featureIndex) const
+{
+    if (featureIndex + 1 < m_records.size())
+    {
+        return m_records.at(featureIndex + 1);
+    }
+
+    FeatureRecord end;
+    end.coordinatesBegin = m_coordinates.size();
+    end.partsBegin = m_parts.size();
+    end.polygonsBegin = m_polygons.size();
+    return end;
+}
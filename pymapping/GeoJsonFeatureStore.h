@@ -0,0 +1,82 @@
+// geoint-mapping offers core mapping and Geospatial Intelligence capabilities for Python.
+// Copyright (C) 2024 Jan Tschada (gisfromscratch@live.de)
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// Additional permission under GNU LGPL version 3 section 4 and 5
+// If you modify this Program, or any covered work, by linking or combining
+// it with ArcGIS Runtime for Qt (or a modified version of that library),
+// containing parts covered by the terms of ArcGIS Runtime for Qt,
+// the licensors of this Program grant you additional permission to convey the resulting work.
+// See <https://developers.arcgis.com/qt/> for further information.
+//
+
+#ifndef GEOJSONFEATURESTORE_H
+#define GEOJSONFEATURESTORE_H
+
+#include "AttributeTable.h"
+#include "GeoJsonFeature.h"
+#include "PackedRTree.h"
+
+#include <QList>
+
+/*!
+ * \brief Compact in-memory store of parsed GeoJSON features.
+ *
+ * The coordinates and offsets of all features are kept in shared buffers,
+ * the properties in a columnar attribute table, and the features are
+ * spatially indexed by their bounding boxes. A
+ * feature is decoded back into a GeoJsonFeature only when its graphics
+ * are needed.
+ */
+class GeoJsonFeatureStore
+{
+public:
+    void append(const GeoJsonFeature& feature);
+    void buildIndex();
+    void clear();
+
+    qsizetype size() const;
+    bool isEmpty() const;
+    PackedRTree::Box extent() const;
+
+    GeoJsonGeometryType geometryType(qsizetype featureIndex) const;
+    PackedRTree::Box box(qsizetype featureIndex) const;
+    void feature(qsizetype featureIndex, GeoJsonFeature& feature) const;
+
+    // Features appended after the last buildIndex are not found
+    QList<qsizetype> search(const PackedRTree::Box& box) const;
+
+private:
+    // The feature owns the buffer entries up to the start of the next feature
+    struct FeatureRecord
+    {
+        GeoJsonGeometryType type = GeoJsonGeometryType::Unknown;
+        qsizetype coordinatesBegin = 0;
+        qsizetype partsBegin = 0;
+        qsizetype polygonsBegin = 0;
+    };
+
+    FeatureRecord recordEnd(qsizetype featureIndex) const;
+
+    QList<FeatureRecord> m_records;
+    QList<double> m_coordinates;
+    QList<qsizetype> m_parts;
+    QList<qsizetype> m_polygons;
+    AttributeTable m_properties;
+    QList<PackedRTree::Box> m_boxes;
+    PackedRTree m_tree;
+};
+
+#endif // GEOJSONFEATURESTORE_H
@@ -0,0 +1,214 @@
+// geoint-mapping offers core mapping and Geospatial Intelligence capabilities for Python.
+// Copyright (C) 2024 Jan Tschada (gisfromscratch@live.de)
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// Additional permission under GNU LGPL version 3 section 4 and 5
+// If you modify this Program, or any covered work, by linking or combining
+// it with ArcGIS Runtime for Qt (or a modified version of that library),
+// containing parts covered by the terms of ArcGIS Runtime for Qt,
+// the licensors of this Program grant you additional permission to convey the resulting work.
+// See <https://developers.arcgis.com/qt/> for further information.
+//
+#include "GeoJsonLoadJob.h"
+
+#include "GeoJsonFeatureReader.h"
+#include "GraphicsFactory.h"
+#include "JsonStreamReader.h"
+#include "SimpleGeoJsonLayer.h"
+
+#include <QtConcurrent>
+
+// Number of batches which may wait for the owning thread
+static const int MaximumPendingBatches = 4;
+
+GeoJsonLoadJob::GeoJsonLoadJob(const QByteArray& geoJson, SimpleGeoJsonLayer* geojsonLayer) :
+    QObject(geojsonLayer),
+    m_geojsonLayer(geojsonLayer),
+    m_geoJson(geoJson),
+    m_freeBatchSlots(MaximumPendingBatches),
+    m_metrics(new LoadMetrics("loadAsync"))
+{
+    m_parserPool.setMaxThreadCount(1);
+}
+
+GeoJsonLoadJob::GeoJsonLoadJob(const QString& filePath, SimpleGeoJsonLayer* geojsonLayer) :
+    QObject(geojsonLayer),
+    m_geojsonLayer(geojsonLayer),
+    m_freeBatchSlots(MaximumPendingBatches),
+    m_metrics(new LoadMetrics("loadFileAsync"))
+{
+    m_parserPool.setMaxThreadCount(1);
+
+    // The reader parses the mapped pages directly
+    if (m_geoJsonFile.open(filePath))
+    {
+        m_geoJson = m_geoJsonFile.data();
+    }
+    else
+    {
+        m_errorString = m_geoJsonFile.errorString();
+    }
+}
+
+GeoJsonLoadJob::~GeoJsonLoadJob()
+{
+    // The worker must not outlive the job
+    cancel();
+    m_future.waitForFinished();
+}
+
+void GeoJsonLoadJob::start()
+{
+    if (m_running)
+    {
+        return;
+    }
+
+    m_running = true;
+    if (!m_errorString.isEmpty())
+    {
+        // The file could not be opened, the job fails without running
+        const QString errorString = m_errorString;
+        QMetaObject::invokeMethod(this, [this, errorString]()
+        {
+            complete(errorString);
+        }, Qt::QueuedConnection);
+        return;
+    }
+
+    m_future = QtConcurrent::run(&m_parserPool, [this]()
+    {
+        run();
+    });
+}
+
+void GeoJsonLoadJob::cancel()
+{
+    // Wakes the parser waiting for a free batch slot
+    m_canceled = true;
+    m_freeBatchSlots.release();
+}
+
+qint64 GeoJsonLoadJob::featuresParsed() const
+{
+    return m_featuresParsed;
+}
+
+qint64 GeoJsonLoadJob::bytesConsumed() const
+{
+    return m_bytesConsumed;
+}
+
+qint64 GeoJsonLoadJob::totalBytes() const
+{
+    return m_geoJson.size();
+}
+
+bool GeoJsonLoadJob::isRunning() const
+{
+    return m_running;
+}
+
+bool GeoJsonLoadJob::isCanceled() const
+{
+    return m_canceled;
+}
+
+QString GeoJsonLoadJob::errorString() const
+{
+    return m_errorString;
+}
+
+QSharedPointer<LoadMetrics> GeoJsonLoadJob::metrics() const
+{
+    return m_metrics;
+}
+
+void GeoJsonLoadJob::run()
+{
+    // Runs on the parser thread of the job
+    LoadMetrics::Scope metricsScope(m_metrics.data());
+    JsonStreamReader reader(m_geoJson);
+    GeoJsonFeatureReader featureReader(reader);
+    qint64 featuresParsed = 0;
+    bool moreFeatures = true;
+    while (moreFeatures && !m_canceled)
+    {
+        QList<GeoJsonFeature> featureBatch;
+        {
+            ScopedLoadStage parseStage("parse");
+            moreFeatures = GraphicsFactory::FeatureBatchSize == featureReader.readFeatures(featureBatch, GraphicsFactory::FeatureBatchSize);
+        }
+        featuresParsed += featureBatch.size();
+        LoadMetrics::count(LoadCounter::FeaturesParsed, featureBatch.size());
+        QList<GeoJsonFeatureGeometries> batchGeometries;
+        {
+            ScopedLoadStage geometryWaitStage("geometryWait");
+            batchGeometries = QtConcurrent::blockingMapped(featureBatch, &GraphicsFactory::createGeometries);
+        }
+
+        // Do not run ahead of the owning thread
+        m_freeBatchSlots.acquire();
+        if (m_canceled)
+        {
+            break;
+        }
+
+        qint64 bytesConsumed = reader.bytesConsumed();
+        QMetaObject::invokeMethod(this, [this, batchGeometries, featuresParsed, bytesConsumed]()
+        {
+            deliverBatch(batchGeometries, featuresParsed, bytesConsumed);
+        }, Qt::QueuedConnection);
+    }
+
+    LoadMetrics::count(LoadCounter::BytesProcessed, reader.bytesConsumed());
+    QString errorString;
+    if (featureReader.hasError())
+    {
+        errorString = featureReader.errorString();
+    }
+    QMetaObject::invokeMethod(this, [this, errorString]()
+    {
+        complete(errorString);
+    }, Qt::QueuedConnection);
+}
+
+void GeoJsonLoadJob::deliverBatch(const QList<GeoJsonFeatureGeometries>& batchGeometries, qint64 featuresParsed, qint64 bytesConsumed)
+{
+    m_freeBatchSlots.release();
+    if (m_canceled)
+    {
+        return;
+    }
+
+    LoadMetrics::Scope metricsScope(m_metrics.data());
+    m_geojsonLayer->appendGeometries(batchGeometries);
+    m_featuresParsed = featuresParsed;
+    m_bytesConsumed = bytesConsumed;
+    emit progressChanged(m_featuresParsed, m_bytesConsumed);
+}
+
+void GeoJsonLoadJob::complete(const QString& errorString)
+{
+    m_running = false;
+    m_errorString = errorString;
+    m_metrics->finish();
+    if (!m_errorString.isEmpty())
+    {
+        qDebug() << "JSON is invalid!" << m_errorString;
+    }
+
+    emit finished(!m_canceled && m_errorString.isEmpty());
+}
@@ -0,0 +1,106 @@
+// geoint-mapping offers core mapping and Geospatial Intelligence capabilities for Python.
+// Copyright (C) 2024 Jan Tschada (gisfromscratch@live.de)
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// Additional permission under GNU LGPL version 3 section 4 and 5
+// If you modify this Program, or any covered work, by linking or combining
+// it with ArcGIS Runtime for Qt (or a modified version of that library),
+// containing parts covered by the terms of ArcGIS Runtime for Qt,
+// the licensors of this Program grant you additional permission to convey the resulting work.
+// See <https://developers.arcgis.com/qt/> for further information.
+//
+
+#ifndef GEOJSONLOADJOB_H
+#define GEOJSONLOADJOB_H
+
+#include "LoadMetrics.h"
+#include "MappedFile.h"
+
+class SimpleGeoJsonLayer;
+struct GeoJsonFeatureGeometries;
+
+#include <QByteArray>
+#include <QFuture>
+#include <QList>
+#include <QObject>
+#include <QSemaphore>
+#include <QSharedPointer>
+#include <QString>
+#include <QThreadPool>
+
+#include <atomic>
+
+/*!
+ * \brief Handle of a GeoJSON layer being loaded in the background.
+ *
+ * Parsing runs on a thread of the job and the geometries are built on the
+ * global thread pool, so waiting for the pool never occupies one of its
+ * threads. The graphics are appended batch by batch on the thread owning
+ * the layer, so that the event loop keeps running while a large document
+ * is loaded.
+ */
+class GeoJsonLoadJob : public QObject
+{
+    Q_OBJECT
+
+    Q_PROPERTY(qint64 featuresParsed READ featuresParsed NOTIFY progressChanged)
+    Q_PROPERTY(qint64 bytesConsumed READ bytesConsumed NOTIFY progressChanged)
+    Q_PROPERTY(qint64 totalBytes READ totalBytes CONSTANT)
+    Q_PROPERTY(bool running READ isRunning NOTIFY finished)
+    Q_PROPERTY(bool canceled READ isCanceled NOTIFY finished)
+    Q_PROPERTY(QString errorString READ errorString NOTIFY finished)
+
+public:
+    GeoJsonLoadJob(const QByteArray& geoJson, SimpleGeoJsonLayer* geojsonLayer);
+    GeoJsonLoadJob(const QString& filePath, SimpleGeoJsonLayer* geojsonLayer);
+    ~GeoJsonLoadJob() override;
+
+    void start();
+    Q_INVOKABLE void cancel();
+
+    qint64 featuresParsed() const;
+    qint64 bytesConsumed() const;
+    qint64 totalBytes() const;
+    bool isRunning() const;
+    bool isCanceled() const;
+    QString errorString() const;
+    // Complete once the job has finished
+    QSharedPointer<LoadMetrics> metrics() const;
+
+signals:
+    void progressChanged(qint64 featuresParsed, qint64 bytesConsumed);
+    void finished(bool succeeded);
+
+private:
+    void run();
+    void deliverBatch(const QList<GeoJsonFeatureGeometries>& batchGeometries, qint64 featuresParsed, qint64 bytesConsumed);
+    void complete(const QString& errorString);
+
+    SimpleGeoJsonLayer* m_geojsonLayer = nullptr;
+    MappedFile m_geoJsonFile;
+    QByteArray m_geoJson;
+    // Runs the parser, it waits for the global pool and the owning thread
+    QThreadPool m_parserPool;
+    QFuture<void> m_future;
+    std::atomic_bool m_canceled{false};
+    QSemaphore m_freeBatchSlots;
+    qint64 m_featuresParsed = 0;
+    qint64 m_bytesConsumed = 0;
+    bool m_running = false;
+    QString m_errorString;
+    QSharedPointer<LoadMetrics> m_metrics;
+};
+
+#endif // GEOJSONLOADJOB_H
@@ -0,0 +1,244 @@
+// geoint-mapping offers core mapping and Geospatial Intelligence capabilities for Python.
+// Copyright (C) 2024 Jan Tschada (gisfromscratch@live.de)
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// Additional permission under GNU LGPL version 3 section 4 and 5
+// If you modify this Program, or any covered work, by linking or combining
+// it with ArcGIS Runtime for Qt (or a modified version of that library),
+// containing parts covered by the terms of ArcGIS Runtime for Qt,
+// the licensors of this Program grant you additional permission to convey the resulting work.
+// See <https://developers.arcgis.com/qt/> for further information.
+//
+#include "GeoPackagePrefetchJob.h"
+
+#include "WorkspaceCache.h"
+
+#include <Error.h>
+#include <GeoPackage.h>
+#include <GeoPackageFeatureTable.h>
+#include <QueryParameters.h>
+
+#include <QDebug>
+#include <QFuture>
+
+using namespace Esri::ArcGISRuntime;
+
+GeoPackagePrefetchJob::GeoPackagePrefetchJob(GeoPackage* geopackage,
+                                             const QStringList& tableNames,
+                                             const Envelope& extent,
+                                             QObject *parent) :
+    QObject(parent),
+    m_geopackage(geopackage),
+    m_tableNames(tableNames),
+    m_extent(extent)
+{
+}
+
+void GeoPackagePrefetchJob::start()
+{
+    if (m_running)
+    {
+        return;
+    }
+
+    m_running = true;
+    WorkspaceCache::whenLoaded(m_geopackage, this, [this](const Error& error)
+    {
+        onGeoPackageLoaded(error);
+    });
+}
+
+void GeoPackagePrefetchJob::cancel()
+{
+    if (!m_running)
+    {
+        return;
+    }
+
+    // Pending loads and queries are ignored when they are done
+    m_canceled = true;
+    complete(QString());
+}
+
+int GeoPackagePrefetchJob::tablesCompleted() const
+{
+    return m_tablesCompleted;
+}
+
+int GeoPackagePrefetchJob::tableCount() const
+{
+    return m_tables.size();
+}
+
+qint64 GeoPackagePrefetchJob::featuresQueried() const
+{
+    return m_featuresQueried;
+}
+
+bool GeoPackagePrefetchJob::isRunning() const
+{
+    return m_running;
+}
+
+bool GeoPackagePrefetchJob::isCanceled() const
+{
+    return m_canceled;
+}
+
+QString GeoPackagePrefetchJob::errorString() const
+{
+    return m_errorString;
+}
+
+GeoPackage* GeoPackagePrefetchJob::geoPackage() const
+{
+    return m_geopackage;
+}
+
+QList<GeoPackageFeatureTable*> GeoPackagePrefetchJob::featureTables() const
+{
+    QList<GeoPackageFeatureTable*> featureTables;
+    for (GeoPackageFeatureTable* table : m_tables)
+    {
+        if (m_loadedTables.contains(table))
+        {
+            featureTables.append(table);
+        }
+    }
+    return featureTables;
+}
+
+void GeoPackagePrefetchJob::onGeoPackageLoaded(const Error& error)
+{
+    if (!m_running)
+    {
+        return;
+    }
+    if (!error.isEmpty())
+    {
+        complete(error.message());
+        return;
+    }
+
+    const QList<GeoPackageFeatureTable*> featureTables = m_geopackage->geoPackageFeatureTables();
+    for (GeoPackageFeatureTable* table : featureTables)
+    {
+        if (m_tableNames.isEmpty() || m_tableNames.contains(table->tableName()))
+        {
+            m_tables.append(table);
+        }
+    }
+    if (m_tables.isEmpty())
+    {
+        complete(QStringLiteral("The GeoPackage has no matching feature table!"));
+        return;
+    }
+
+    // The runtime loads all tables concurrently
+    emit progressChanged(m_tablesCompleted, m_tables.size());
+    for (GeoPackageFeatureTable* table : m_tables)
+    {
+        WorkspaceCache::whenLoaded(table, this, [this, table](const Error& tableError)
+        {
+            onTableLoaded(table, tableError);
+        });
+    }
+}
+
+void GeoPackagePrefetchJob::onTableLoaded(GeoPackageFeatureTable* table, const Error& error)
+{
+    if (!m_running)
+    {
+        return;
+    }
+    if (!error.isEmpty())
+    {
+        qWarning() << "Failed to load GeoPackage table:" << table->tableName() << error.message();
+        m_failedTables.append(table->tableName());
+        completeTable();
+        return;
+    }
+
+    m_loadedTables.insert(table);
+    if (m_extent.isEmpty())
+    {
+        completeTable();
+        return;
+    }
+
+    m_pendingQueries.append(table);
+    queryNextTables();
+}
+
+void GeoPackagePrefetchJob::queryNextTables()
+{
+    while (m_activeQueries < MaximumConcurrentQueries && !m_pendingQueries.isEmpty())
+    {
+        GeoPackageFeatureTable* table = m_pendingQueries.takeFirst();
+        QueryParameters queryParameters;
+        queryParameters.setGeometry(m_extent);
+        queryParameters.setSpatialRelationship(SpatialRelationship::Intersects);
+        m_activeQueries++;
+        // Counting walks the spatial index without creating a feature per row,
+        // the layers read the features themselves when they draw
+        table->queryFeatureCountAsync(queryParameters).then(this, [this](quint64 featureCount)
+        {
+            m_activeQueries--;
+            m_featuresQueried += static_cast<qint64>(featureCount);
+            completeTable();
+        }).onFailed(this, [this]()
+        {
+            // The layer of the table is added anyway, it queries on its own
+            m_activeQueries--;
+            completeTable();
+        });
+    }
+}
+
+void GeoPackagePrefetchJob::completeTable()
+{
+    if (!m_running)
+    {
+        return;
+    }
+
+    m_tablesCompleted++;
+    emit progressChanged(m_tablesCompleted, m_tables.size());
+    if (m_tablesCompleted < m_tables.size())
+    {
+        queryNextTables();
+        return;
+    }
+
+    QString errorString;
+    if (!m_failedTables.isEmpty())
+    {
+        errorString = QStringLiteral("Failed to load the tables %1!").arg(m_failedTables.join(", "));
+    }
+    complete(errorString);
+}
+
+void GeoPackagePrefetchJob::complete(const QString& errorString)
+{
+    m_running = false;
+    m_errorString = errorString;
+    if (!m_errorString.isEmpty())
+    {
+        qWarning() << "GeoPackage prefetch:" << m_errorString;
+    }
+
+    // Tables failing to load do not fail the job as long as one table was loaded
+    emit finished(!m_canceled && !m_loadedTables.isEmpty());
+}
@@ -0,0 +1,117 @@
+// geoint-mapping offers core mapping and Geospatial Intelligence capabilities for Python.
+// Copyright (C) 2024 Jan Tschada (gisfromscratch@live.de)
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// Additional permission under GNU LGPL version 3 section 4 and 5
+// If you modify this Program, or any covered work, by linking or combining
+// it with ArcGIS Runtime for Qt (or a modified version of that library),
+// containing parts covered by the terms of ArcGIS Runtime for Qt,
+// the licensors of this Program grant you additional permission to convey the resulting work.
+// See <https://developers.arcgis.com/qt/> for further information.
+//
+
+#ifndef GEOPACKAGEPREFETCHJOB_H
+#define GEOPACKAGEPREFETCHJOB_H
+
+namespace Esri
+{
+namespace ArcGISRuntime
+{
+class Error;
+class GeoPackage;
+class GeoPackageFeatureTable;
+}
+}
+
+#include <Envelope.h>
+
+#include <QList>
+#include <QObject>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+
+/*!
+ * \brief Handle of GeoPackage feature tables being prefetched in the background.
+ *
+ * All selected tables are loaded at once and the features of every loaded
+ * table within the prefetch extent are counted. Counting only warms the
+ * spatial index pages of the GeoPackage, no feature is created, the layers
+ * query their features when they draw. The progress counts the tables
+ * being done. The loaded tables are handed out together once the job has
+ * finished.
+ */
+class GeoPackagePrefetchJob : public QObject
+{
+    Q_OBJECT
+
+    Q_PROPERTY(int tablesCompleted READ tablesCompleted NOTIFY progressChanged)
+    Q_PROPERTY(int tableCount READ tableCount NOTIFY progressChanged)
+    Q_PROPERTY(qint64 featuresQueried READ featuresQueried NOTIFY progressChanged)
+    Q_PROPERTY(bool running READ isRunning NOTIFY finished)
+    Q_PROPERTY(bool canceled READ isCanceled NOTIFY finished)
+    Q_PROPERTY(QString errorString READ errorString NOTIFY finished)
+
+public:
+    // Number of tables being queried at the same time
+    static constexpr int MaximumConcurrentQueries = 8;
+
+    // An empty extent only loads the tables, empty table names select all tables
+    GeoPackagePrefetchJob(Esri::ArcGISRuntime::GeoPackage* geopackage,
+                          const QStringList& tableNames,
+                          const Esri::ArcGISRuntime::Envelope& extent,
+                          QObject *parent = nullptr);
+
+    void start();
+    Q_INVOKABLE void cancel();
+
+    int tablesCompleted() const;
+    int tableCount() const;
+    qint64 featuresQueried() const;
+    bool isRunning() const;
+    bool isCanceled() const;
+    QString errorString() const;
+
+    Esri::ArcGISRuntime::GeoPackage* geoPackage() const;
+    // The tables being loaded in the order of the GeoPackage
+    QList<Esri::ArcGISRuntime::GeoPackageFeatureTable*> featureTables() const;
+
+signals:
+    void progressChanged(int tablesCompleted, int tableCount);
+    void finished(bool succeeded);
+
+private:
+    void onGeoPackageLoaded(const Esri::ArcGISRuntime::Error& error);
+    void onTableLoaded(Esri::ArcGISRuntime::GeoPackageFeatureTable* table, const Esri::ArcGISRuntime::Error& error);
+    void queryNextTables();
+    void completeTable();
+    void complete(const QString& errorString);
+
+    Esri::ArcGISRuntime::GeoPackage* m_geopackage = nullptr;
+    QStringList m_tableNames;
+    Esri::ArcGISRuntime::Envelope m_extent;
+    QList<Esri::ArcGISRuntime::GeoPackageFeatureTable*> m_tables;
+    QSet<Esri::ArcGISRuntime::GeoPackageFeatureTable*> m_loadedTables;
+    QList<Esri::ArcGISRuntime::GeoPackageFeatureTable*> m_pendingQueries;
+    QStringList m_failedTables;
+    int m_activeQueries = 0;
+    int m_tablesCompleted = 0;
+    qint64 m_featuresQueried = 0;
+    bool m_running = false;
+    bool m_canceled = false;
+    QString m_errorString;
+};
+
+#endif // GEOPACKAGEPREFETCHJOB_H
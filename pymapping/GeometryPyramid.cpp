@@ -0,0 +1,163 @@
+// geoint-mapping offers core mapping and Geospatial Intelligence capabilities for Python.
+// Copyright (C) 2024 Jan Tschada (gisfromscratch@live.de)
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// Additional permission under GNU LGPL version 3 section 4 and 5
+// If you modify this Program, or any covered work, by linking or combining
+// it with ArcGIS Runtime for Qt (or a modified version of that library),
+// containing parts covered by the terms of ArcGIS Runtime for Qt,
+// the licensors of this Program grant you additional permission to convey the resulting work.
+// See <https://developers.arcgis.com/qt/> for further information.
+//
+
+#include "GeometryPyramid.h"
+
+#include <QList>
+#include <QPair>
+
+// Ground size of a screen pixel at scale 1, in degrees at the equator
+static constexpr double DegreesPerPixelAtScaleOne = 0.0254 / 96.0 / 111320.0;
+
+int GeometryPyramid::levelForScale(double mapScale)
+{
+    // The coarsest level deviating less than one pixel
+    const double pixelSize = mapScale * DegreesPerPixelAtScaleOne;
+    int level = 0;
+    while (level < static_cast<int>(LevelTolerances.size()) && LevelTolerances.at(level) <= pixelSize)
+    {
+        level++;
+    }
+
+    return level;
+}
+
+double GeometryPyramid::tolerance(int level)
+{
+    return (0 < level && level < LevelCount) ? LevelTolerances.at(level - 1) : 0.0;
+}
+
+GeoJsonGeometry GeometryPyramid::simplify(const GeoJsonGeometry& geometry, double tolerance)
+{
+    if (tolerance <= 0.0 || geometry.pointCount() < MinimumPointCount)
+    {
+        return geometry;
+    }
+
+    GeoJsonGeometry simplifiedGeometry;
+    simplifiedGeometry.type = geometry.type;
+    simplifiedGeometry.polygons = geometry.polygons;
+    simplifiedGeometry.parts.reserve(geometry.partCount());
+    for (qsizetype partIndex = 0; partIndex < geometry.partCount(); partIndex++)
+    {
+        simplifiedGeometry.parts.append(simplifiedGeometry.pointCount());
+        simplifyPart(geometry, partIndex, tolerance * tolerance, simplifiedGeometry.coordinates);
+    }
+
+    return simplifiedGeometry;
+}
+
+static double squaredSegmentDistance(const double* vertex, const double* first, const double* last)
+{
+    double x = first[0];
+    double y = first[1];
+    const double dx = last[0] - x;
+    const double dy = last[1] - y;
+    if (0.0 != dx || 0.0 != dy)
+    {
+        const double t = ((vertex[0] - x) * dx + (vertex[1] - y) * dy) / (dx * dx + dy * dy);
+        if (1.0 < t)
+        {
+            x = last[0];
+            y = last[1];
+        }
+        else if (0.0 < t)
+        {
+            x += dx * t;
+            y += dy * t;
+        }
+    }
+
+    const double distanceX = vertex[0] - x;
+    const double distanceY = vertex[1] - y;
+    return distanceX * distanceX + distanceY * distanceY;
+}
+
+void GeometryPyramid::simplifyPart(const GeoJsonGeometry& geometry, qsizetype partIndex, double squaredTolerance, QList<double>& coordinates)
+{
+    const qsizetype partBegin = geometry.partBegin(partIndex);
+    const qsizetype pointCount = geometry.partEnd(partIndex) - partBegin;
+    const double* vertices = geometry.vertex(partBegin);
+
+    // Rings need four vertices, line strings need two
+    const bool isRing = GeoJsonGeometryType::Polygon == geometry.type || GeoJsonGeometryType::MultiPolygon == geometry.type;
+    const qsizetype minimumCount = isRing ? 4 : 2;
+    if (pointCount < minimumCount)
+    {
+        // Degenerated parts are kept as they are
+        for (qsizetype index = 0; index < 2 * pointCount; index++)
+        {
+            coordinates.append(vertices[index]);
+        }
+        return;
+    }
+
+    QList<bool> keep(pointCount, false);
+    keep[0] = true;
+    keep[pointCount - 1] = true;
+    qsizetype keptCount = 2;
+
+    // Split every range at its farthest vertex until all vertices are close enough
+    QList<QPair<qsizetype, qsizetype>> ranges;
+    ranges.append(qMakePair(qsizetype(0), pointCount - 1));
+    while (!ranges.isEmpty())
+    {
+        const QPair<qsizetype, qsizetype> range = ranges.takeLast();
+        double maximumDistance = 0.0;
+        qsizetype farthest = -1;
+        for (qsizetype index = range.first + 1; index < range.second; index++)
+        {
+            const double distance = squaredSegmentDistance(vertices + 2 * index, vertices + 2 * range.first, vertices + 2 * range.second);
+            if (maximumDistance < distance)
+            {
+                maximumDistance = distance;
+                farthest = index;
+            }
+        }
+
+        if (squaredTolerance < maximumDistance)
+        {
+            keep[farthest] = true;
+            keptCount++;
+            ranges.append(qMakePair(range.first, farthest));
+            ranges.append(qMakePair(farthest, range.second));
+        }
+    }
+
+    if (keptCount < minimumCount)
+    {
+        // Collapsed rings become a triangle spanning the ring, closed by the last vertex
+        keep[pointCount / 3] = true;
+        keep[2 * pointCount / 3] = true;
+    }
+
+    for (qsizetype index = 0; index < pointCount; index++)
+    {
+        if (keep.at(index))
+        {
+            coordinates.append(vertices[2 * index]);
+            coordinates.append(vertices[2 * index + 1]);
+        }
+    }
+}
@@ -0,0 +1,57 @@
+// geoint-mapping offers core mapping and Geospatial Intelligence capabilities for Python.
+// Copyright (C) 2024 Jan Tschada (gisfromscratch@live.de)
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// Additional permission under GNU LGPL version 3 section 4 and 5
+// If you modify this Program, or any covered work, by linking or combining
+// it with ArcGIS Runtime for Qt (or a modified version of that library),
+// containing parts covered by the terms of ArcGIS Runtime for Qt,
+// the licensors of this Program grant you additional permission to convey the resulting work.
+// See <https://developers.arcgis.com/qt/> for further information.
+//
+
+#ifndef GEOMETRYPYRAMID_H
+#define GEOMETRYPYRAMID_H
+
+#include "GeoJsonFeature.h"
+
+#include <array>
+
+/*!
+ * \brief Douglas-Peucker simplification of GeoJSON geometries at fixed levels of detail.
+ *
+ * Level 0 is the full resolution, every further level allows ten times
+ * the deviation of the previous one. The tolerances are in degrees,
+ * because GeoJSON coordinates are WGS84.
+ */
+class GeometryPyramid
+{
+public:
+    static constexpr std::array<double, 4> LevelTolerances = { 0.00005, 0.0005, 0.005, 0.05 };
+    static constexpr int LevelCount = static_cast<int>(LevelTolerances.size()) + 1;
+
+    // Geometries with fewer vertices are always drawn at full resolution
+    static constexpr qsizetype MinimumPointCount = 64;
+
+    static int levelForScale(double mapScale);
+    static double tolerance(int level);
+
+    static GeoJsonGeometry simplify(const GeoJsonGeometry& geometry, double tolerance);
+
+private:
+    static void simplifyPart(const GeoJsonGeometry& geometry, qsizetype partIndex, double squaredTolerance, QList<double>& coordinates);
+};
+
+#endif // GEOMETRYPYRAMID_H
@@ -23,223 +23,809 @@
 //
 #include "GraphicsFactory.h"
 
+#include "EsriJsonGeometryReader.h"
+#include "FeatureBinaryReader.h"
+#include "GeoJsonFeatureReader.h"
+#include "GeometryPyramid.h"
+#include "GraphicsOverlayIndex.h"
+#include "LoadMetrics.h"
+
+#include <AttributeListModel.h>
+#include <Envelope.h>
 #include <GeometryEngine.h>
 #include <Graphic.h>
 #include <GraphicListModel.h>
 #include <GraphicsOverlay.h>
+#include <MultipointBuilder.h>
 #include <Part.h>
 #include <PartCollection.h>
 #include <Point.h>
+#include <PointCollection.h>
 #include <PolygonBuilder.h>
 #include <PolylineBuilder.h>
 #include <SpatialReference.h>
 
-#include <QJsonObject>
+#include <QSet>
+#include <QtConcurrent>
+
+#include <algorithm>
+#include <deque>
 
 using namespace Esri::ArcGISRuntime;
 
+// Feeds the vertices of one part straight from the coordinate buffer
+template <typename PartBuilder>
+static void addVertices(PartBuilder& builder, const GeoJsonGeometry& geometry, qsizetype partIndex)
+{
+    const double* vertex = geometry.vertex(geometry.partBegin(partIndex));
+    const double* lastVertex = geometry.vertex(geometry.partEnd(partIndex));
+    for (; vertex != lastVertex; vertex += 2)
+    {
+        builder.addPoint(vertex[0], vertex[1]);
+    }
+}
+
+static bool isClockwise(const GeoJsonGeometry& geometry, qsizetype partIndex)
+{
+    double signedArea = 0.0;
+    const qsizetype partEnd = geometry.partEnd(partIndex);
+    for (qsizetype pointIndex = geometry.partBegin(partIndex); pointIndex + 1 < partEnd; pointIndex++)
+    {
+        const double* vertex = geometry.vertex(pointIndex);
+        signedArea += vertex[0] * vertex[3] - vertex[2] * vertex[1];
+    }
+    return signedArea < 0.0;
+}
+
+// Esri polygons expect clockwise exterior rings and counterclockwise holes,
+// GeoJSON rings may have either orientation
+template <typename PartBuilder>
+static void addRing(PartBuilder& builder, const GeoJsonGeometry& geometry, qsizetype partIndex, bool clockwise)
+{
+    if (clockwise == isClockwise(geometry, partIndex))
+    {
+        addVertices(builder, geometry, partIndex);
+        return;
+    }
+
+    const double* firstVertex = geometry.vertex(geometry.partBegin(partIndex));
+    const double* vertex = geometry.vertex(geometry.partEnd(partIndex));
+    while (vertex != firstVertex)
+    {
+        vertex -= 2;
+        builder.addPoint(vertex[0], vertex[1]);
+    }
+}
+
+// Single part geometries are built without any part objects. Otherwise the
+// parts are constructed in one arena on the stack, which is released as soon
+// as the geometry is built. The builder is declared last, so it goes first.
+template <typename Builder, typename FillPart>
+static Geometry buildMultipart(const SpatialReference& spatialReference, qsizetype partCount, FillPart fillPart)
+{
+    if (1 == partCount)
+    {
+        Builder builder(spatialReference);
+        fillPart(builder, 0);
+        return builder.toGeometry();
+    }
+
+    std::deque<Part> parts;
+    PartCollection partCollection(spatialReference);
+    Builder builder(spatialReference);
+    for (qsizetype partIndex = 0; partIndex < partCount; partIndex++)
+    {
+        Part& part = parts.emplace_back(spatialReference);
+        fillPart(part, partIndex);
+        if (!part.isEmpty())
+        {
+            partCollection.addPart(&part);
+        }
+    }
+
+    builder.setParts(&partCollection);
+    return builder.toGeometry();
+}
+
+// Feeds the vertices of one part straight from the coordinate arrays
+template <typename PartBuilder>
+static void addVertices(PartBuilder& builder, const CoordinateArrays& coordinates, const SpatialReference& spatialReference, qsizetype firstVertex, qsizetype lastVertex)
+{
+    if (coordinates.m)
+    {
+        for (qsizetype index = firstVertex; index < lastVertex; index++)
+        {
+            builder.addPoint(coordinates.z
+                             ? Point(coordinates.x[index], coordinates.y[index], coordinates.z[index], coordinates.m[index], spatialReference)
+                             : Point::createWithM(coordinates.x[index], coordinates.y[index], coordinates.m[index], spatialReference));
+        }
+    }
+    else if (coordinates.z)
+    {
+        for (qsizetype index = firstVertex; index < lastVertex; index++)
+        {
+            builder.addPoint(coordinates.x[index], coordinates.y[index], coordinates.z[index]);
+        }
+    }
+    else
+    {
+        for (qsizetype index = firstVertex; index < lastVertex; index++)
+        {
+            builder.addPoint(coordinates.x[index], coordinates.y[index]);
+        }
+    }
+}
+
+static void validatePolygon(const Polygon& polygon)
+{
+    if (!polygon.isValid())
+    {
+        qWarning() << "Polygon not valid!";
+    }
+    else if (polygon.isEmpty())
+    {
+        qWarning() << "Polygon is empty!";
+    }
+}
+
 GraphicsFactory::GraphicsFactory(QObject *parent) : QObject(parent)
 {
 
 }
 
-bool GraphicsFactory::createGraphics(const QJsonArray &featuresArray,
+bool GraphicsFactory::createGraphics(GeoJsonFeatureReader& featureReader,
                                      Esri::ArcGISRuntime::GraphicsOverlay *pointsOverlay,
                                      Esri::ArcGISRuntime::GraphicsOverlay *linesOverlay,
                                      Esri::ArcGISRuntime::GraphicsOverlay *areasOverlay)
 {
+    // The calling thread parses the next batch of features while the
+    // thread pool builds the geometries of the previous batch.
+    // Mapped results keep the order of the features.
     bool added = false;
-    foreach (const QJsonValue& featureValue, featuresArray)
+    QFuture<GeoJsonFeatureGeometries> pendingBatch;
+    bool moreFeatures = true;
+    while (moreFeatures)
     {
-        if (featureValue.isObject())
+        QList<GeoJsonFeature> featureBatch;
         {
-            QJsonObject geojsonFeature = featureValue.toObject();
-            QJsonObject geojsonGeometry = geojsonFeature["geometry"].toObject();
-            QJsonValue geometryTypeValue = geojsonGeometry["type"];
-            if (geometryTypeValue.isString())
-            {
-                QJsonValue coordinatesValue = geojsonGeometry["coordinates"];
-                if (coordinatesValue.isArray())
-                {
-                    QJsonObject properties = geojsonFeature["properties"].toObject();
-                    QVariantMap propertyMap = properties.toVariantMap();
-
-                    QJsonArray coordinatesArray = coordinatesValue.toArray();
-                    QString geometryType = geometryTypeValue.toString();
-                    if (0 == QString::compare("Point", geometryType))
-                    {
-                        QJsonArray coordinatesArray = coordinatesValue.toArray();
-                        if (1 < coordinatesArray.count())
-                        {
-                            double x = coordinatesArray[0].toDouble();
-                            double y = coordinatesArray[1].toDouble();
-                            Point location(x, y, SpatialReference::wgs84());
-                            Graphic* graphic = new Graphic(location, propertyMap, this);
-                            pointsOverlay->graphics()->append(graphic);
-                            added = true;
-                        }
-                    }
-                    // TODO: MultiPoint, Polyline and so on implementations
-                    else if (0 == QString::compare("LineString", geometryType))
-                    {
-                        Polyline polyline = createPolyline(coordinatesArray);
-                        Graphic* geojsonGraphic = new Graphic(polyline, propertyMap, this);
-                        linesOverlay->graphics()->append(geojsonGraphic);
-                        added = true;
-                    }
-                    else if (0 == QString::compare("MultiLineString", geometryType))
-                    {
-                        // Coordinates represents arrays of polylines
-                        foreach (const QJsonValue& polylineValue, coordinatesArray)
-                        {
-                            if (polylineValue.isArray())
-                            {
-                                QJsonArray polylineCoordinatesArray = polylineValue.toArray();
-                                Polyline polyline = createPolyline(polylineCoordinatesArray);
-                                Graphic* geojsonGraphic = new Graphic(polyline, propertyMap, this);
-                                linesOverlay->graphics()->append(geojsonGraphic);
-                                added = true;
-                            }
-                        }
-                    }
-                    else if (0 == QString::compare("Polygon", geometryType))
-                    {
-                        Polygon polygon = createPolygon(coordinatesArray);
-                        if (!polygon.isValid())
-                        {
-                            qWarning() << "Polygon not valid!";
-                        }
-                        else if (polygon.isEmpty())
-                        {
-                            qWarning() << "Polygon is empty!";
-                        }
-                        Graphic* geojsonGraphic = new Graphic(polygon, propertyMap, this);
-                        areasOverlay->graphics()->append(geojsonGraphic);
-                        added = true;
-                    }
-                    else if (0 == QString::compare("MultiPolygon", geometryType))
-                    {
-                        // Coordinates represents arrays of polygons
-                        foreach (const QJsonValue& polygonValue, coordinatesArray)
-                        {
-                            if (polygonValue.isArray())
-                            {
-                                QJsonArray polygonCoordinatesArray = polygonValue.toArray();
-                                Polygon polygon = createMultiPolygon(polygonCoordinatesArray);
-                                if (!polygon.isValid())
-                                {
-                                    qWarning() << "Polygon not valid!";
-                                }
-                                else if (polygon.isEmpty())
-                                {
-                                    qWarning() << "Polygon is empty!";
-                                }
-                                Graphic* geojsonGraphic = new Graphic(polygon, propertyMap, this);
-                                areasOverlay->graphics()->append(geojsonGraphic);
-                                added = true;
-                            }
-                        }
-                    }
-                }
-            }
+            ScopedLoadStage parseStage("parse");
+            moreFeatures = FeatureBatchSize == featureReader.readFeatures(featureBatch, FeatureBatchSize);
+        }
+        LoadMetrics::count(LoadCounter::FeaturesParsed, featureBatch.size());
+        if (mergeBatch(pendingBatch, pointsOverlay, linesOverlay, areasOverlay))
+        {
+            added = true;
         }
+        pendingBatch = QtConcurrent::mapped(std::move(featureBatch), &GraphicsFactory::createGeometries);
+    }
+
+    if (mergeBatch(pendingBatch, pointsOverlay, linesOverlay, areasOverlay))
+    {
+        added = true;
     }
 
     return added;
 }
 
-Polygon GraphicsFactory::createPolygon(const QJsonArray &coordinatesArray)
+bool GraphicsFactory::createGraphics(const FeatureBinaryReader& featureReader,
+                                     const QList<qsizetype>& featureIndices,
+                                     Esri::ArcGISRuntime::GraphicsOverlay *pointsOverlay,
+                                     Esri::ArcGISRuntime::GraphicsOverlay *linesOverlay,
+                                     Esri::ArcGISRuntime::GraphicsOverlay *areasOverlay)
 {
-    PolygonBuilder polygonBuilder(SpatialReference::wgs84());
-    bool interiorRing = false;
-    foreach (const QJsonValue& ringValue, coordinatesArray)
+    // Decoding a record only copies it out of the mapped file,
+    // so the thread pool decodes the records as well
+    auto createRecordGeometries = [&featureReader](qsizetype featureIndex)
+    {
+        GeoJsonFeature feature;
+        featureReader.feature(featureIndex, feature);
+        return createGeometries(feature);
+    };
+
+    LoadMetrics::count(LoadCounter::FeaturesParsed, featureIndices.size());
+    bool added = false;
+    QFuture<GeoJsonFeatureGeometries> pendingBatch;
+    for (qsizetype batchBegin = 0; batchBegin < featureIndices.size(); batchBegin += FeatureBatchSize)
     {
-        if (ringValue.isArray())
+        QFuture<GeoJsonFeatureGeometries> featureBatch = QtConcurrent::mapped(featureIndices.mid(batchBegin, FeatureBatchSize), createRecordGeometries);
+        if (mergeBatch(pendingBatch, pointsOverlay, linesOverlay, areasOverlay))
         {
-            QJsonArray ringsArray = ringValue.toArray();
-            foreach (const QJsonValue& verticesValue, ringsArray)
-            {
-                if (verticesValue.isArray())
-                {
-                    QJsonArray verticesArray = verticesValue.toArray();
-                    if (1 < verticesArray.count())
-                    {
-                        double x = verticesArray[0].toDouble();
-                        double y = verticesArray[1].toDouble();
-                        polygonBuilder.addPoint(x, y);
-                    }
-                }
-            }
+            added = true;
+        }
+        pendingBatch = featureBatch;
+    }
+
+    if (mergeBatch(pendingBatch, pointsOverlay, linesOverlay, areasOverlay))
+    {
+        added = true;
+    }
 
-            if (!interiorRing)
+    return added;
+}
+
+bool GraphicsFactory::createGraphics(const QList<GeoJsonFeatureGeometries>& batchGeometries,
+                                     Esri::ArcGISRuntime::GraphicsOverlay *pointsOverlay,
+                                     Esri::ArcGISRuntime::GraphicsOverlay *linesOverlay,
+                                     Esri::ArcGISRuntime::GraphicsOverlay *areasOverlay)
+{
+    // Every overlay receives the graphics of a batch at once
+    QList<Graphic*> pointGraphics;
+    QList<Graphic*> lineGraphics;
+    QList<Graphic*> areaGraphics;
+    qsizetype pointCount = 0;
+    {
+        ScopedLoadStage graphicsStage("graphics");
+        for (const GeoJsonFeatureGeometries& featureGeometries : batchGeometries)
+        {
+            QList<Graphic*>* graphics = nullptr;
+            switch (featureGeometries.type)
             {
-                // The first ring must be the exterior ring
-                interiorRing = true;
+            case GeoJsonGeometryType::Point:
+            case GeoJsonGeometryType::MultiPoint:
+                graphics = &pointGraphics;
+                break;
 
-                // TODO: Implement polygon holes
-                if (1 < coordinatesArray.count())
-                {
-                    qDebug() << (coordinatesArray.count() - 1) << " interior rings are thrown away!";
-                }
+            case GeoJsonGeometryType::LineString:
+            case GeoJsonGeometryType::MultiLineString:
+                graphics = &lineGraphics;
                 break;
+
+            case GeoJsonGeometryType::Polygon:
+            case GeoJsonGeometryType::MultiPolygon:
+                graphics = &areaGraphics;
+                break;
+
+            default:
+                continue;
             }
+
+            graphics->append(createFeatureGraphics(featureGeometries));
+            pointCount += featureGeometries.pointCount;
+        }
+    }
+    LoadMetrics::count(LoadCounter::VerticesBuilt, pointCount);
+
+    appendGraphics(pointsOverlay, pointGraphics);
+    appendGraphics(linesOverlay, lineGraphics);
+    appendGraphics(areasOverlay, areaGraphics);
+    return !pointGraphics.isEmpty() || !lineGraphics.isEmpty() || !areaGraphics.isEmpty();
+}
+
+bool GraphicsFactory::mergeBatch(QFuture<GeoJsonFeatureGeometries>& pendingBatch,
+                                 Esri::ArcGISRuntime::GraphicsOverlay *pointsOverlay,
+                                 Esri::ArcGISRuntime::GraphicsOverlay *linesOverlay,
+                                 Esri::ArcGISRuntime::GraphicsOverlay *areasOverlay)
+{
+    if (!pendingBatch.isValid())
+    {
+        return false;
+    }
+
+    // Waits for the worker threads, the graphics are created by the calling thread
+    {
+        ScopedLoadStage geometryWaitStage("geometryWait");
+        pendingBatch.waitForFinished();
+    }
+    return createGraphics(pendingBatch.results(), pointsOverlay, linesOverlay, areasOverlay);
+}
+
+QList<Graphic*> GraphicsFactory::createFeatureGraphics(const GeoJsonFeatureGeometries& featureGeometries)
+{
+    QList<Graphic*> graphics;
+    graphics.reserve(featureGeometries.geometries.size());
+    for (qsizetype geometryIndex = 0; geometryIndex < featureGeometries.geometries.size(); geometryIndex++)
+    {
+        const Geometry& geometry = featureGeometries.geometries.at(geometryIndex);
+        if (featureGeometries.levels.isEmpty())
+        {
+            graphics.append(new Graphic(geometry, featureGeometries.properties, this));
+            continue;
+        }
+
+        // The graphic starts with the active level of detail
+        const LevelGeometries graphicLevels = levelGeometries(featureGeometries, geometryIndex);
+        Graphic* graphic = new Graphic(graphicLevels.geometries.at(graphicLevels.level), featureGeometries.properties, this);
+        m_levelGeometries.insert(graphic, graphicLevels);
+        graphics.append(graphic);
+    }
+
+    return graphics;
+}
+
+bool GraphicsFactory::updateFeatureGraphics(const QList<Graphic*>& graphics, const GeoJsonFeatureGeometries& featureGeometries)
+{
+    // Graphics can only be reused when the feature keeps its number of parts
+    if (graphics.size() != featureGeometries.geometries.size())
+    {
+        return false;
+    }
+
+    for (qsizetype geometryIndex = 0; geometryIndex < graphics.size(); geometryIndex++)
+    {
+        Graphic* graphic = graphics.at(geometryIndex);
+        const Geometry& geometry = featureGeometries.geometries.at(geometryIndex);
+        if (featureGeometries.levels.isEmpty())
+        {
+            m_levelGeometries.remove(graphic);
+            graphic->setGeometry(geometry);
+        }
+        else
+        {
+            const LevelGeometries graphicLevels = levelGeometries(featureGeometries, geometryIndex);
+            graphic->setGeometry(graphicLevels.geometries.at(graphicLevels.level));
+            m_levelGeometries.insert(graphic, graphicLevels);
         }
+
+        updateAttributes(graphic, featureGeometries.properties);
+    }
+
+    return true;
+}
+
+void GraphicsFactory::releaseGraphics(const QList<Graphic*>& graphics)
+{
+    // The graphics must have been removed from their overlay
+    for (Graphic* graphic : graphics)
+    {
+        m_levelGeometries.remove(graphic);
+        delete graphic;
+    }
+}
+
+bool GraphicsFactory::hasLevelsOfDetail() const
+{
+    return !m_levelGeometries.isEmpty();
+}
+
+int GraphicsFactory::levelOfDetail() const
+{
+    return m_levelOfDetail;
+}
+
+void GraphicsFactory::setLevelOfDetail(int level)
+{
+    m_levelOfDetail = level;
+}
+
+void GraphicsFactory::applyLevelOfDetail(GraphicsOverlay* overlay, const Envelope& extent)
+{
+    // Only the graphics within the extent are swapped, the others follow when they get into view
+    const GraphicsOverlayIndex* overlayIndex = GraphicsOverlayIndex::find(overlay);
+    if (m_levelGeometries.isEmpty() || nullptr == overlayIndex)
+    {
+        return;
     }
 
-    return polygonBuilder.toPolygon();
+    GraphicListModel* graphics = overlay->graphics();
+    const QList<qsizetype> rows = overlayIndex->query(extent);
+    for (qsizetype row : rows)
+    {
+        Graphic* graphic = graphics->at(static_cast<int>(row));
+        auto graphicLevels = m_levelGeometries.find(graphic);
+        if (graphicLevels == m_levelGeometries.end())
+        {
+            continue;
+        }
+
+        const int level = qMin<int>(m_levelOfDetail, graphicLevels->geometries.size() - 1);
+        if (level != graphicLevels->level)
+        {
+            graphic->setGeometry(graphicLevels->geometries.at(level));
+            graphicLevels->level = level;
+        }
+    }
 }
 
-Polygon GraphicsFactory::createMultiPolygon(const QJsonArray &coordinatesArray)
+Geometry GraphicsFactory::fullGeometry(const Graphic* graphic)
 {
-    PolygonBuilder polygonBuilder(SpatialReference::wgs84());
-    PartCollection* partCollection = new PartCollection(polygonBuilder.spatialReference(), this);
-    bool interiorRing = false;
-    foreach (const QJsonValue& ringValue, coordinatesArray)
+    // Graphics having levels of detail are children of their factory
+    const GraphicsFactory* graphicsFactory = qobject_cast<const GraphicsFactory*>(graphic->parent());
+    if (nullptr != graphicsFactory)
     {
-        if (ringValue.isArray())
+        auto graphicLevels = graphicsFactory->m_levelGeometries.constFind(const_cast<Graphic*>(graphic));
+        if (graphicLevels != graphicsFactory->m_levelGeometries.cend())
         {
-            QJsonArray ringsArray = ringValue.toArray();
-            Part* polygonPart = new Part(polygonBuilder.spatialReference(), this);
-            foreach (const QJsonValue& verticesValue, ringsArray)
+            return graphicLevels->geometries.first();
+        }
+    }
+
+    return graphic->geometry();
+}
+
+GraphicsFactory::LevelGeometries GraphicsFactory::levelGeometries(const GeoJsonFeatureGeometries& featureGeometries, qsizetype geometryIndex) const
+{
+    LevelGeometries graphicLevels;
+    graphicLevels.geometries.reserve(1 + featureGeometries.levels.size());
+    graphicLevels.geometries.append(featureGeometries.geometries.at(geometryIndex));
+    for (const QList<Geometry>& level : featureGeometries.levels)
+    {
+        graphicLevels.geometries.append(level.at(geometryIndex));
+    }
+    graphicLevels.level = qMin<int>(m_levelOfDetail, graphicLevels.geometries.size() - 1);
+    return graphicLevels;
+}
+
+void GraphicsFactory::appendGraphics(Esri::ArcGISRuntime::GraphicsOverlay* overlay, const QList<Esri::ArcGISRuntime::Graphic*>& graphics)
+{
+    if (graphics.isEmpty())
+    {
+        return;
+    }
+
+    // The overlay model emits one change and the renderer updates once
+    ScopedLoadStage appendStage("append");
+    overlay->graphics()->append(graphics);
+    LoadMetrics::count(LoadCounter::GraphicsAppended, graphics.size());
+}
+
+void GraphicsFactory::removeGraphics(Esri::ArcGISRuntime::GraphicsOverlay* overlay, const QList<Esri::ArcGISRuntime::Graphic*>& graphics)
+{
+    if (graphics.isEmpty())
+    {
+        return;
+    }
+
+    GraphicListModel* graphicListModel = overlay->graphics();
+    const QSet<Graphic*> removedGraphics(graphics.cbegin(), graphics.cend());
+
+    // One scan finds the rows in ascending order
+    const int rowCount = graphicListModel->rowCount();
+    QList<int> removedRows;
+    removedRows.reserve(removedGraphics.size());
+    for (int row = 0; row < rowCount; row++)
+    {
+        if (removedGraphics.contains(graphicListModel->at(row)))
+        {
+            removedRows.append(row);
+        }
+    }
+
+    if (removedRows.isEmpty())
+    {
+        return;
+    }
+
+    // Removing most of the overlay is cheaper as one reset and one append
+    if (2 * removedRows.size() > rowCount)
+    {
+        QList<Graphic*> keptGraphics;
+        keptGraphics.reserve(rowCount - removedRows.size());
+        for (int row = 0, removedIndex = 0; row < rowCount; row++)
+        {
+            if (removedIndex < removedRows.size() && removedRows.at(removedIndex) == row)
+            {
+                removedIndex++;
+                continue;
+            }
+            keptGraphics.append(graphicListModel->at(row));
+        }
+
+        graphicListModel->clear();
+        appendGraphics(overlay, keptGraphics);
+        return;
+    }
+
+    // Contiguous rows are removed as one range starting from the back, so the rows
+    // in front stay valid and the spatial index only drops the boxes of each range
+    qsizetype lastIndex = removedRows.size() - 1;
+    while (lastIndex >= 0)
+    {
+        qsizetype firstIndex = lastIndex;
+        while (firstIndex > 0 && removedRows.at(firstIndex - 1) == removedRows.at(firstIndex) - 1)
+        {
+            firstIndex--;
+        }
+
+        const int firstRow = removedRows.at(firstIndex);
+        graphicListModel->removeRows(firstRow, removedRows.at(lastIndex) - firstRow + 1);
+        lastIndex = firstIndex - 1;
+    }
+}
+
+GeoJsonFeatureGeometries GraphicsFactory::createGeometries(const GeoJsonFeature& geojsonFeature)
+{
+    // Must not touch any QObject owned by another thread, because
+    // it is called by the worker threads
+    GeoJsonFeatureGeometries featureGeometries;
+    const GeoJsonGeometry& geometry = geojsonFeature.geometry;
+    featureGeometries.type = geometry.type;
+    featureGeometries.pointCount = geometry.pointCount();
+    featureGeometries.properties = geojsonFeature.properties;
+    featureGeometries.geometries = createFeatureGeometries(geometry, true);
+
+    // Dense lines and areas are simplified for every level of detail
+    switch (geometry.type)
+    {
+    case GeoJsonGeometryType::LineString:
+    case GeoJsonGeometryType::MultiLineString:
+    case GeoJsonGeometryType::Polygon:
+    case GeoJsonGeometryType::MultiPolygon:
+        if (GeometryPyramid::MinimumPointCount <= geometry.pointCount())
+        {
+            qsizetype previousPointCount = geometry.pointCount();
+            for (int level = 1; level < GeometryPyramid::LevelCount; level++)
             {
-                if (verticesValue.isArray())
+                const GeoJsonGeometry simplifiedGeometry = GeometryPyramid::simplify(geometry, GeometryPyramid::tolerance(level));
+                if (simplifiedGeometry.pointCount() == previousPointCount)
                 {
-                    QJsonArray verticesArray = verticesValue.toArray();
-                    if (1 < verticesArray.count())
-                    {
-                        double x = verticesArray[0].toDouble();
-                        double y = verticesArray[1].toDouble();
-                        polygonPart->addPoint(x, y);
-                    }
+                    // Nothing more to simplify, the previous level is shared
+                    featureGeometries.levels.append(featureGeometries.levels.isEmpty() ? featureGeometries.geometries : featureGeometries.levels.last());
+                    continue;
                 }
+
+                featureGeometries.levels.append(createFeatureGeometries(simplifiedGeometry, false));
+                previousPointCount = simplifiedGeometry.pointCount();
             }
-            if (!polygonPart->isEmpty())
+        }
+        break;
+
+    default:
+        break;
+    }
+
+    return featureGeometries;
+}
+
+QList<Geometry> GraphicsFactory::createFeatureGeometries(const GeoJsonGeometry& geometry, bool validate)
+{
+    QList<Geometry> geometries;
+    switch (geometry.type)
+    {
+    case GeoJsonGeometryType::Point:
+        if (0 < geometry.pointCount())
+        {
+            const double* vertex = geometry.vertex(0);
+            geometries.append(Point(vertex[0], vertex[1], SpatialReference::wgs84()));
+        }
+        break;
+
+    case GeoJsonGeometryType::MultiPoint:
+        if (0 < geometry.pointCount())
+        {
+            geometries.append(createMultipoint(geometry));
+        }
+        break;
+
+    case GeoJsonGeometryType::LineString:
+    case GeoJsonGeometryType::MultiLineString:
+        // Every line string becomes a polyline
+        for (qsizetype partIndex = 0; partIndex < geometry.partCount(); partIndex++)
+        {
+            geometries.append(createPolyline(geometry, partIndex));
+        }
+        break;
+
+    case GeoJsonGeometryType::Polygon:
+    case GeoJsonGeometryType::MultiPolygon:
+        // Every polygon becomes one graphic having all of its rings
+        for (qsizetype polygonIndex = 0; polygonIndex < geometry.polygonCount(); polygonIndex++)
+        {
+            Polygon polygon = createPolygon(geometry, polygonIndex);
+            if (validate)
             {
-                partCollection->addPart(polygonPart);
+                validatePolygon(polygon);
             }
+            geometries.append(polygon);
+        }
+        break;
+
+    default:
+        break;
+    }
+
+    return geometries;
+}
+
+QList<Geometry> GraphicsFactory::createArrayGeometries(GeometryType geometryType,
+                                                      const CoordinateArrays& coordinates,
+                                                      const SpatialReference& spatialReference)
+{
+    // Ranges of geometries are built on the thread pool
+    QList<QPair<qsizetype, qsizetype>> geometryRanges;
+    for (qsizetype firstGeometry = 0; firstGeometry < coordinates.geometryCount; firstGeometry += FeatureBatchSize)
+    {
+        geometryRanges.append(qMakePair(firstGeometry, qMin(firstGeometry + FeatureBatchSize, coordinates.geometryCount)));
+    }
+
+    const QList<QList<Geometry>> rangeGeometries = QtConcurrent::blockingMapped<QList<QList<Geometry>>>(geometryRanges,
+        [geometryType, &coordinates, &spatialReference](const QPair<qsizetype, qsizetype>& geometryRange)
+    {
+        QList<Geometry> geometries;
+        geometries.reserve(geometryRange.second - geometryRange.first);
+        for (qsizetype geometryIndex = geometryRange.first; geometryIndex < geometryRange.second; geometryIndex++)
+        {
+            geometries.append(createGeometry(geometryType, coordinates, spatialReference, geometryIndex));
+        }
+        return geometries;
+    });
+
+    QList<Geometry> geometries;
+    geometries.reserve(coordinates.geometryCount);
+    for (const QList<Geometry>& rangeGeometry : rangeGeometries)
+    {
+        geometries.append(rangeGeometry);
+    }
+
+    return geometries;
+}
+
+QList<Geometry> GraphicsFactory::createEsriJsonGeometries(EsriJsonGeometryReader& geometryReader)
+{
+    // Like the GeoJSON features, the calling thread decodes the next batch
+    // while the thread pool builds the geometries of the previous batch.
+    QList<Geometry> geometries;
+    QFuture<Geometry> pendingBatch;
+    auto mergeGeometries = [&geometries, &pendingBatch]()
+    {
+        {
+            ScopedLoadStage geometryWaitStage("geometryWait");
+            pendingBatch.waitForFinished();
+        }
+        geometries.append(pendingBatch.results());
+        pendingBatch = QFuture<Geometry>();
+    };
+
+    bool moreGeometries = true;
+    while (moreGeometries)
+    {
+        QList<EsriJsonGeometry> geometryBatch;
+        {
+            ScopedLoadStage parseStage("parse");
+            moreGeometries = FeatureBatchSize == geometryReader.readGeometries(geometryBatch, FeatureBatchSize);
+        }
+        LoadMetrics::count(LoadCounter::FeaturesParsed, geometryBatch.size());
+        for (const EsriJsonGeometry& geometry : geometryBatch)
+        {
+            LoadMetrics::count(LoadCounter::VerticesBuilt, geometry.x.size());
+        }
+
+        mergeGeometries();
+        pendingBatch = QtConcurrent::mapped(std::move(geometryBatch), &GraphicsFactory::createEsriJsonGeometry);
+    }
+
+    mergeGeometries();
+    return geometries;
+}
+
+Geometry GraphicsFactory::createEsriJsonGeometry(const EsriJsonGeometry& geometry)
+{
+    if (!geometry.json.isEmpty())
+    {
+        return Geometry::fromJson(QString::fromUtf8(geometry.json));
+    }
+
+    SpatialReference spatialReference;
+    if (0 < geometry.wkid)
+    {
+        spatialReference = SpatialReference(geometry.wkid);
+    }
+    else if (!geometry.wkt.isEmpty())
+    {
+        spatialReference = SpatialReference(geometry.wkt);
+    }
+
+    switch (geometry.type)
+    {
+    case GeometryType::Envelope:
+        return Envelope(geometry.x.at(0), geometry.y.at(0), geometry.x.at(1), geometry.y.at(1), spatialReference);
+    case GeometryType::Point:
+    case GeometryType::Multipoint:
+    case GeometryType::Polyline:
+    case GeometryType::Polygon:
+        return createGeometry(geometry.type, geometry.coordinates(), spatialReference, 0);
+    default:
+        return Geometry();
+    }
+}
+
+Geometry GraphicsFactory::createGeometry(GeometryType geometryType,
+                                         const CoordinateArrays& coordinates,
+                                         const SpatialReference& spatialReference,
+                                         qsizetype geometryIndex)
+{
+    if (GeometryType::Point == geometryType)
+    {
+        double x = coordinates.x[geometryIndex];
+        double y = coordinates.y[geometryIndex];
+        if (coordinates.z && coordinates.m)
+        {
+            return Point(x, y, coordinates.z[geometryIndex], coordinates.m[geometryIndex], spatialReference);
+        }
+        if (coordinates.z)
+        {
+            return Point(x, y, coordinates.z[geometryIndex], spatialReference);
+        }
+        if (coordinates.m)
+        {
+            return Point::createWithM(x, y, coordinates.m[geometryIndex], spatialReference);
         }
+        return Point(x, y, spatialReference);
+    }
+
+    const qsizetype firstPart = coordinates.partBegin(geometryIndex);
+    const qsizetype partCount = coordinates.partEnd(geometryIndex) - firstPart;
+    auto fillPart = [&coordinates, &spatialReference, firstPart](auto& part, qsizetype partIndex)
+    {
+        addVertices(part, coordinates, spatialReference, coordinates.vertexBegin(firstPart + partIndex), coordinates.vertexEnd(firstPart + partIndex));
+    };
+
+    if (GeometryType::Multipoint == geometryType)
+    {
+        // The parts of a multipoint only group its points
+        MultipointBuilder multipointBuilder(spatialReference);
+        for (qsizetype partIndex = 0; partIndex < partCount; partIndex++)
+        {
+            fillPart(*multipointBuilder.points(), partIndex);
+        }
+        return multipointBuilder.toGeometry();
+    }
+
+    if (GeometryType::Polyline == geometryType)
+    {
+        return buildMultipart<PolylineBuilder>(spatialReference, partCount, fillPart);
+    }
+
+    const Polygon polygon = geometry_cast<Polygon>(buildMultipart<PolygonBuilder>(spatialReference, partCount, fillPart));
+    validatePolygon(polygon);
+    return polygon;
+}
+
+Multipoint GraphicsFactory::createMultipoint(const GeoJsonGeometry& geometry)
+{
+    MultipointBuilder multipointBuilder(SpatialReference::wgs84());
+    PointCollection* points = multipointBuilder.points();
+    for (qsizetype pointIndex = 0; pointIndex < geometry.pointCount(); pointIndex++)
+    {
+        const double* vertex = geometry.vertex(pointIndex);
+        points->addPoint(vertex[0], vertex[1]);
     }
 
-    polygonBuilder.setParts(partCollection);
-    return polygonBuilder.toPolygon();
+    return multipointBuilder.toMultipoint();
+}
+
+Polygon GraphicsFactory::createPolygon(const GeoJsonGeometry& geometry, qsizetype polygonIndex)
+{
+    // The first ring is the exterior ring, all others are holes
+    const qsizetype firstPart = geometry.polygonBegin(polygonIndex);
+    const qsizetype ringCount = geometry.polygonEnd(polygonIndex) - firstPart;
+    return geometry_cast<Polygon>(buildMultipart<PolygonBuilder>(SpatialReference::wgs84(), ringCount, [&geometry, firstPart](auto& ring, qsizetype ringIndex)
+    {
+        addRing(ring, geometry, firstPart + ringIndex, 0 == ringIndex);
+    }));
 }
 
-Polyline GraphicsFactory::createPolyline(const QJsonArray &coordinatesArray)
+Polyline GraphicsFactory::createPolyline(const GeoJsonGeometry& geometry, qsizetype partIndex)
 {
     PolylineBuilder polylineBuilder(SpatialReference::wgs84());
-    foreach (const QJsonValue& verticesValue, coordinatesArray)
+    addVertices(polylineBuilder, geometry, partIndex);
+    return polylineBuilder.toPolyline();
+}
+
+void GraphicsFactory::updateAttributes(Graphic* graphic, const QVariantMap& properties)
+{
+    // Only changed attributes are written, every write notifies the renderer
+    AttributeListModel* attributes = graphic->attributes();
+    for (auto property = properties.cbegin(); property != properties.cend(); property++)
     {
-        if (verticesValue.isArray())
+        if (!attributes->containsAttribute(property.key()))
         {
-            QJsonArray verticesArray = verticesValue.toArray();
-            if (1 < verticesArray.count())
+            attributes->insertAttribute(property.key(), property.value());
+        }
+        else if (attributes->attributeValue(property.key()) != property.value())
+        {
+            attributes->replaceAttribute(property.key(), property.value());
+        }
+    }
+
+    if (attributes->size() != properties.size())
+    {
+        const QStringList attributeNames = attributes->attributeNames();
+        for (const QString& attributeName : attributeNames)
+        {
+            if (!properties.contains(attributeName))
             {
-                double x = verticesArray[0].toDouble();
-                double y = verticesArray[1].toDouble();
-                polylineBuilder.addPoint(x, y);
+                attributes->removeAttribute(attributeName);
             }
         }
     }
-
-    return polylineBuilder.toPolyline();
 }
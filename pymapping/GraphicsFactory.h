@@ -24,37 +24,129 @@
 #ifndef GRAPHICSFACTORY_H
 #define GRAPHICSFACTORY_H
 
+#include "CoordinateArrays.h"
+#include "GeoJsonFeature.h"
+
+#include "Geometry.h"
+#include "GeometryTypes.h"
+#include "Multipoint.h"
 #include "Polygon.h"
 #include "Polyline.h"
 
+class EsriJsonGeometryReader;
+class FeatureBinaryReader;
+struct EsriJsonGeometry;
+class GeoJsonFeatureReader;
+
 namespace Esri
 {
 namespace ArcGISRuntime
 {
+class Envelope;
+class Graphic;
 class GraphicsOverlay;
+class SpatialReference;
 }
 }
 
-#include <QJsonArray>
+#include <QFuture>
+#include <QHash>
+#include <QList>
 #include <QObject>
+#include <QVariantMap>
+
+/*!
+ * \brief The geometries built from one GeoJSON feature.
+ *
+ * Every geometry becomes one graphic sharing the properties of the feature.
+ * Dense lines and areas also carry their simplified geometries, one list
+ * per level of detail above the full resolution.
+ */
+struct GeoJsonFeatureGeometries
+{
+    GeoJsonGeometryType type = GeoJsonGeometryType::Unknown;
+    QList<Esri::ArcGISRuntime::Geometry> geometries;
+    QList<QList<Esri::ArcGISRuntime::Geometry>> levels;
+    QVariantMap properties;
+    qsizetype pointCount = 0;
+};
 
 class GraphicsFactory : public QObject
 {
     Q_OBJECT
 public:
+    // Number of features handed over to the worker threads at once
+    static constexpr qsizetype FeatureBatchSize = 2048;
+
     explicit GraphicsFactory(QObject *parent = nullptr);
 
-    bool createGraphics(const QJsonArray& featuresArray,
+    bool createGraphics(GeoJsonFeatureReader& featureReader,
+                        Esri::ArcGISRuntime::GraphicsOverlay* pointsOverlay,
+                        Esri::ArcGISRuntime::GraphicsOverlay* linesOverlay,
+                        Esri::ArcGISRuntime::GraphicsOverlay* areasOverlay);
+
+    bool createGraphics(const FeatureBinaryReader& featureReader,
+                        const QList<qsizetype>& featureIndices,
+                        Esri::ArcGISRuntime::GraphicsOverlay* pointsOverlay,
+                        Esri::ArcGISRuntime::GraphicsOverlay* linesOverlay,
+                        Esri::ArcGISRuntime::GraphicsOverlay* areasOverlay);
+
+    bool createGraphics(const QList<GeoJsonFeatureGeometries>& batchGeometries,
                         Esri::ArcGISRuntime::GraphicsOverlay* pointsOverlay,
                         Esri::ArcGISRuntime::GraphicsOverlay* linesOverlay,
                         Esri::ArcGISRuntime::GraphicsOverlay* areasOverlay);
 
+    QList<Esri::ArcGISRuntime::Graphic*> createFeatureGraphics(const GeoJsonFeatureGeometries& featureGeometries);
+    bool updateFeatureGraphics(const QList<Esri::ArcGISRuntime::Graphic*>& graphics, const GeoJsonFeatureGeometries& featureGeometries);
+    void releaseGraphics(const QList<Esri::ArcGISRuntime::Graphic*>& graphics);
+
+    bool hasLevelsOfDetail() const;
+    int levelOfDetail() const;
+    // Graphics take the level when they are created or applied within an extent
+    void setLevelOfDetail(int level);
+    void applyLevelOfDetail(Esri::ArcGISRuntime::GraphicsOverlay* overlay, const Esri::ArcGISRuntime::Envelope& extent);
+
+    static void appendGraphics(Esri::ArcGISRuntime::GraphicsOverlay* overlay, const QList<Esri::ArcGISRuntime::Graphic*>& graphics);
+    static void removeGraphics(Esri::ArcGISRuntime::GraphicsOverlay* overlay, const QList<Esri::ArcGISRuntime::Graphic*>& graphics);
+
+    static GeoJsonFeatureGeometries createGeometries(const GeoJsonFeature& geojsonFeature);
+    static QList<Esri::ArcGISRuntime::Geometry> createArrayGeometries(Esri::ArcGISRuntime::GeometryType geometryType,
+                                                                      const CoordinateArrays& coordinates,
+                                                                      const Esri::ArcGISRuntime::SpatialReference& spatialReference);
+    static QList<Esri::ArcGISRuntime::Geometry> createEsriJsonGeometries(EsriJsonGeometryReader& geometryReader);
+    static Esri::ArcGISRuntime::Geometry createEsriJsonGeometry(const EsriJsonGeometry& geometry);
+    static void updateAttributes(Esri::ArcGISRuntime::Graphic* graphic, const QVariantMap& properties);
+    // The geometry without simplification, even when a coarser level of detail is shown
+    static Esri::ArcGISRuntime::Geometry fullGeometry(const Esri::ArcGISRuntime::Graphic* graphic);
+
 signals:
 
 private:
-    Esri::ArcGISRuntime::Polygon createPolygon(const QJsonArray& coordinatesArray);
-    Esri::ArcGISRuntime::Polygon createMultiPolygon(const QJsonArray& coordinatesArray);
-    Esri::ArcGISRuntime::Polyline createPolyline(const QJsonArray& coordinatesArray);
+    bool mergeBatch(QFuture<GeoJsonFeatureGeometries>& pendingBatch,
+                    Esri::ArcGISRuntime::GraphicsOverlay* pointsOverlay,
+                    Esri::ArcGISRuntime::GraphicsOverlay* linesOverlay,
+                    Esri::ArcGISRuntime::GraphicsOverlay* areasOverlay);
+
+    static Esri::ArcGISRuntime::Geometry createGeometry(Esri::ArcGISRuntime::GeometryType geometryType,
+                                                        const CoordinateArrays& coordinates,
+                                                        const Esri::ArcGISRuntime::SpatialReference& spatialReference,
+                                                        qsizetype geometryIndex);
+    static QList<Esri::ArcGISRuntime::Geometry> createFeatureGeometries(const GeoJsonGeometry& geometry, bool validate);
+    static Esri::ArcGISRuntime::Multipoint createMultipoint(const GeoJsonGeometry& geometry);
+    static Esri::ArcGISRuntime::Polygon createPolygon(const GeoJsonGeometry& geometry, qsizetype polygonIndex);
+    static Esri::ArcGISRuntime::Polyline createPolyline(const GeoJsonGeometry& geometry, qsizetype partIndex);
+
+    struct LevelGeometries
+    {
+        QList<Esri::ArcGISRuntime::Geometry> geometries;
+        int level = 0;
+    };
+
+    LevelGeometries levelGeometries(const GeoJsonFeatureGeometries& featureGeometries, qsizetype geometryIndex) const;
+
+    // Every level of detail of the graphics having simplified geometries
+    QHash<Esri::ArcGISRuntime::Graphic*, LevelGeometries> m_levelGeometries;
+    int m_levelOfDetail = 0;
 };
 
 #endif // GRAPHICSFACTORY_H
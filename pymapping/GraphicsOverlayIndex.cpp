@@ -0,0 +1,331 @@
+// geoint-mapping offers core mapping and Geospatial Intelligence capabilities for Python.
+// Copyright (C) 2024 Jan Tschada (gisfromscratch@live.de)
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// Additional permission under GNU LGPL version 3 section 4 and 5
+// If you modify this Program, or any covered work, by linking or combining
+// it with ArcGIS Runtime for Qt (or a modified version of that library),
+// containing parts covered by the terms of ArcGIS Runtime for Qt,
+// the licensors of this Program grant you additional permission to convey the resulting work.
+// See <https://developers.arcgis.com/qt/> for further information.
+//
+
+#include "GraphicsOverlayIndex.h"
+
+#include <Envelope.h>
+#include <GeometryEngine.h>
+#include <Graphic.h>
+#include <GraphicListModel.h>
+#include <GraphicsOverlay.h>
+#include <Point.h>
+
+#include <QtConcurrent>
+
+#include <algorithm>
+#include <utility>
+
+using namespace Esri::ArcGISRuntime;
+
+GraphicsOverlayIndex::GraphicsOverlayIndex(GraphicsOverlay* overlay) :
+    QObject(overlay),
+    m_overlay(overlay)
+{
+    GraphicListModel* graphics = m_overlay->graphics();
+    connect(graphics, &QAbstractItemModel::rowsInserted, this, &GraphicsOverlayIndex::onRowsInserted);
+    connect(graphics, &QAbstractItemModel::rowsRemoved, this, &GraphicsOverlayIndex::onRowsRemoved);
+    connect(graphics, &QAbstractItemModel::modelReset, this, &GraphicsOverlayIndex::reset);
+    reset();
+}
+
+GraphicsOverlayIndex* GraphicsOverlayIndex::attach(GraphicsOverlay* overlay)
+{
+    if (nullptr == overlay)
+    {
+        return nullptr;
+    }
+
+    GraphicsOverlayIndex* overlayIndex = find(overlay);
+    if (nullptr == overlayIndex)
+    {
+        // The overlay owns its index
+        overlayIndex = new GraphicsOverlayIndex(overlay);
+    }
+
+    return overlayIndex;
+}
+
+GraphicsOverlayIndex* GraphicsOverlayIndex::find(const GraphicsOverlay* overlay)
+{
+    if (nullptr == overlay)
+    {
+        return nullptr;
+    }
+
+    return overlay->findChild<GraphicsOverlayIndex*>(QString(), Qt::FindDirectChildrenOnly);
+}
+
+template <typename Visitor>
+void GraphicsOverlayIndex::visit(const PackedRTree::Box& searchBox, Visitor visitor) const
+{
+    ensureIndexed();
+
+    bool proceed = true;
+    qsizetype firstUnindexedRow = 0;
+    if (m_treeValid)
+    {
+        m_tree.visit(searchBox, [&proceed, &visitor](qsizetype row)
+        {
+            proceed = visitor(row);
+            return proceed;
+        });
+        firstUnindexedRow = m_tree.size();
+    }
+
+    // Graphics appended since the tree was built, or all while it is rebuilt
+    for (qsizetype row = firstUnindexedRow; proceed && row < m_boxes.size(); row++)
+    {
+        if (searchBox.intersects(m_boxes.at(row)))
+        {
+            proceed = visitor(row);
+        }
+    }
+}
+
+QList<qsizetype> GraphicsOverlayIndex::query(const Envelope& extent, qsizetype maximumCount) const
+{
+    QList<qsizetype> rows;
+    PackedRTree::Box searchBox;
+    if (0 == maximumCount || !toSearchBox(extent, searchBox))
+    {
+        return rows;
+    }
+
+    visit(searchBox, [&rows, maximumCount](qsizetype row)
+    {
+        rows.append(row);
+        return maximumCount < 0 || rows.size() < maximumCount;
+    });
+    std::sort(rows.begin(), rows.end());
+    return rows;
+}
+
+QList<qsizetype> GraphicsOverlayIndex::identify(const Envelope& searchExtent, qsizetype maximumCount) const
+{
+    QList<qsizetype> rows;
+    PackedRTree::Box searchBox;
+    if (0 == maximumCount || !toSearchBox(searchExtent, searchBox))
+    {
+        return rows;
+    }
+
+    // Boxes of lines and areas may intersect while the geometries do not
+    const Envelope searchEnvelope(searchBox.minX, searchBox.minY, searchBox.maxX, searchBox.maxY, m_spatialReference);
+    const double centerX = 0.5 * (searchBox.minX + searchBox.maxX);
+    const double centerY = 0.5 * (searchBox.minY + searchBox.maxY);
+    GraphicListModel* graphics = m_overlay->graphics();
+    QList<std::pair<double, qsizetype>> candidates;
+    visit(searchBox, [&](qsizetype row)
+    {
+        const PackedRTree::Box& box = m_boxes.at(row);
+        const bool isPoint = box.minX == box.maxX && box.minY == box.maxY;
+        if (isPoint || GeometryEngine::intersects(graphics->at(static_cast<int>(row))->geometry(), searchEnvelope))
+        {
+            candidates.append({ box.squaredDistance(centerX, centerY), row });
+        }
+        return true;
+    });
+
+    // The nearest graphics come first
+    std::sort(candidates.begin(), candidates.end());
+    const qsizetype count = maximumCount < 0 ? candidates.size() : qMin(maximumCount, candidates.size());
+    rows.reserve(count);
+    for (qsizetype index = 0; index < count; index++)
+    {
+        rows.append(candidates.at(index).second);
+    }
+
+    return rows;
+}
+
+void GraphicsOverlayIndex::onRowsInserted(const QModelIndex& parent, int first, int last)
+{
+    Q_UNUSED(parent);
+
+    QList<PackedRTree::Box> boxes;
+    boxes.reserve(last - first + 1);
+    for (int row = first; row <= last; row++)
+    {
+        boxes.append(graphicBox(row));
+    }
+
+    m_boxesGeneration++;
+    if (first == m_boxes.size())
+    {
+        // The tree still covers all rows before the appended ones
+        m_boxes.append(boxes);
+        if (m_treeValid && m_boxes.size() - m_tree.size() <= UnindexedLimit)
+        {
+            return;
+        }
+    }
+    else
+    {
+        m_boxes.insert(first, boxes.size(), PackedRTree::Box());
+        std::copy(boxes.cbegin(), boxes.cend(), m_boxes.begin() + first);
+        m_treeValid = false;
+    }
+
+    scheduleRebuild();
+}
+
+void GraphicsOverlayIndex::onRowsRemoved(const QModelIndex& parent, int first, int last)
+{
+    Q_UNUSED(parent);
+
+    m_boxes.remove(first, last - first + 1);
+    m_boxesGeneration++;
+    m_treeValid = false;
+    scheduleRebuild();
+}
+
+void GraphicsOverlayIndex::invalidate()
+{
+    m_boxesValid = false;
+    m_treeValid = false;
+    scheduleRebuild();
+}
+
+void GraphicsOverlayIndex::reset()
+{
+    // Recycled overlays may be filled with another spatial reference
+    m_spatialReference = SpatialReference();
+    refreshBoxes();
+    m_tree = PackedRTree();
+    m_treeValid = false;
+    scheduleRebuild();
+}
+
+void GraphicsOverlayIndex::scheduleRebuild()
+{
+    // All changes of one batch are covered by a single rebuild
+    if (m_rebuildScheduled)
+    {
+        return;
+    }
+
+    m_rebuildScheduled = true;
+    QMetaObject::invokeMethod(this, &GraphicsOverlayIndex::rebuild, Qt::QueuedConnection);
+}
+
+void GraphicsOverlayIndex::rebuild()
+{
+    m_rebuildScheduled = false;
+    if (!m_boxesValid)
+    {
+        refreshBoxes();
+    }
+    if (m_boxes.size() <= UnindexedLimit)
+    {
+        m_tree = PackedRTree(m_boxes);
+        m_treeValid = true;
+        return;
+    }
+
+    // Queries scan the boxes linearly until the tree is swapped in
+    const QList<PackedRTree::Box> boxes = m_boxes;
+    const quint64 boxesGeneration = m_boxesGeneration;
+    QtConcurrent::run([boxes]()
+    {
+        return PackedRTree(boxes);
+    }).then(this, [this, boxesGeneration](const PackedRTree& tree)
+    {
+        if (boxesGeneration == m_boxesGeneration)
+        {
+            m_tree = tree;
+            m_treeValid = true;
+        }
+    });
+}
+
+void GraphicsOverlayIndex::refreshBoxes() const
+{
+    GraphicListModel* graphics = m_overlay->graphics();
+    const int rowCount = graphics->rowCount();
+    m_boxes.clear();
+    m_boxes.reserve(rowCount);
+    m_boxesGeneration++;
+    for (int row = 0; row < rowCount; row++)
+    {
+        m_boxes.append(graphicBox(row));
+    }
+
+    m_boxesValid = true;
+}
+
+PackedRTree::Box GraphicsOverlayIndex::graphicBox(int row) const
+{
+    const Geometry geometry = m_overlay->graphics()->at(row)->geometry();
+    if (geometry.isEmpty())
+    {
+        return PackedRTree::Box();
+    }
+
+    // All graphics of an overlay are expected to share the spatial reference
+    if (m_spatialReference.isEmpty())
+    {
+        m_spatialReference = geometry.spatialReference();
+    }
+
+    if (GeometryType::Point == geometry.geometryType())
+    {
+        const Point point = geometry_cast<Point>(geometry);
+        return PackedRTree::Box{ point.x(), point.y(), point.x(), point.y() };
+    }
+
+    const Envelope extent = geometry.extent();
+    return PackedRTree::Box{ extent.xMin(), extent.yMin(), extent.xMax(), extent.yMax() };
+}
+
+bool GraphicsOverlayIndex::toSearchBox(const Envelope& extent, PackedRTree::Box& searchBox) const
+{
+    if (extent.isEmpty() || m_spatialReference.isEmpty())
+    {
+        return false;
+    }
+
+    Envelope searchExtent = extent;
+    const SpatialReference extentSpatialReference = extent.spatialReference();
+    if (!extentSpatialReference.isEmpty() && extentSpatialReference != m_spatialReference)
+    {
+        searchExtent = GeometryEngine::project(extent, m_spatialReference).extent();
+        if (searchExtent.isEmpty())
+        {
+            return false;
+        }
+    }
+
+    searchBox = PackedRTree::Box{ searchExtent.xMin(), searchExtent.yMin(), searchExtent.xMax(), searchExtent.yMax() };
+    return true;
+}
+
+void GraphicsOverlayIndex::ensureIndexed() const
+{
+    // The tree itself is rebuilt after the changes, never by a query
+    if (!m_boxesValid)
+    {
+        refreshBoxes();
+        m_treeValid = false;
+    }
+}
@@ -0,0 +1,100 @@
+// geoint-mapping offers core mapping and Geospatial Intelligence capabilities for Python.
+// Copyright (C) 2024 Jan Tschada (gisfromscratch@live.de)
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// Additional permission under GNU LGPL version 3 section 4 and 5
+// If you modify this Program, or any covered work, by linking or combining
+// it with ArcGIS Runtime for Qt (or a modified version of that library),
+// containing parts covered by the terms of ArcGIS Runtime for Qt,
+// the licensors of this Program grant you additional permission to convey the resulting work.
+// See <https://developers.arcgis.com/qt/> for further information.
+//
+
+#ifndef GRAPHICSOVERLAYINDEX_H
+#define GRAPHICSOVERLAYINDEX_H
+
+#include "PackedRTree.h"
+
+namespace Esri
+{
+namespace ArcGISRuntime
+{
+class Envelope;
+class GraphicsOverlay;
+}
+}
+
+#include <SpatialReference.h>
+
+#include <QList>
+#include <QModelIndex>
+#include <QObject>
+
+/*!
+ * \brief Spatial index over the graphics of one graphics overlay.
+ *
+ * The index follows the rows of the graphic list model, so graphics being
+ * appended, removed or cleared by any code path are tracked. After every
+ * batch of changes the tree is rebuilt on the thread pool, queries scan
+ * the boxes not covered by a valid tree linearly in the meantime.
+ * Graphics are reported by their row in the graphic list model.
+ * Geometries changed in place are only picked up after invalidate.
+ * The index lives on the thread of its overlay.
+ */
+class GraphicsOverlayIndex : public QObject
+{
+    Q_OBJECT
+public:
+    // Number of appended graphics being scanned linearly without rebuilding
+    static constexpr qsizetype UnindexedLimit = 1024;
+
+    static GraphicsOverlayIndex* attach(Esri::ArcGISRuntime::GraphicsOverlay* overlay);
+    static GraphicsOverlayIndex* find(const Esri::ArcGISRuntime::GraphicsOverlay* overlay);
+
+    QList<qsizetype> query(const Esri::ArcGISRuntime::Envelope& extent, qsizetype maximumCount = -1) const;
+    QList<qsizetype> identify(const Esri::ArcGISRuntime::Envelope& searchExtent, qsizetype maximumCount) const;
+
+    // The boxes of all graphics are read again by the next query
+    void invalidate();
+
+private:
+    explicit GraphicsOverlayIndex(Esri::ArcGISRuntime::GraphicsOverlay* overlay);
+
+    void onRowsInserted(const QModelIndex& parent, int first, int last);
+    void onRowsRemoved(const QModelIndex& parent, int first, int last);
+    void reset();
+    void scheduleRebuild();
+    void rebuild();
+
+    void refreshBoxes() const;
+    PackedRTree::Box graphicBox(int row) const;
+    bool toSearchBox(const Esri::ArcGISRuntime::Envelope& extent, PackedRTree::Box& searchBox) const;
+    void ensureIndexed() const;
+
+    template <typename Visitor>
+    void visit(const PackedRTree::Box& searchBox, Visitor visitor) const;
+
+    Esri::ArcGISRuntime::GraphicsOverlay* m_overlay = nullptr;
+    mutable Esri::ArcGISRuntime::SpatialReference m_spatialReference;
+    mutable QList<PackedRTree::Box> m_boxes;
+    mutable PackedRTree m_tree;
+    mutable bool m_treeValid = true;
+    mutable bool m_boxesValid = true;
+    // Trees built from older boxes are discarded
+    mutable quint64 m_boxesGeneration = 0;
+    bool m_rebuildScheduled = false;
+};
+
+#endif // GRAPHICSOVERLAYINDEX_H
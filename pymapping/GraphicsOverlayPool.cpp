@@ -0,0 +1,240 @@
+// geoint-mapping offers core mapping and Geospatial Intelligence capabilities for Python.
+// Copyright (C) 2024 Jan Tschada (gisfromscratch@live.de)
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// Additional permission under GNU LGPL version 3 section 4 and 5
+// If you modify this Program, or any covered work, by linking or combining
+// it with ArcGIS Runtime for Qt (or a modified version of that library),
+// containing parts covered by the terms of ArcGIS Runtime for Qt,
+// the licensors of this Program grant you additional permission to convey the resulting work.
+// See <https://developers.arcgis.com/qt/> for further information.
+//
+
+#include "GraphicsOverlayPool.h"
+
+#include <Graphic.h>
+#include <GraphicListModel.h>
+#include <GraphicsOverlay.h>
+#include <LabelDefinitionListModel.h>
+#include <MapViewTypes.h>
+
+#include <QElapsedTimer>
+#include <QSet>
+#include <QTimer>
+
+#include <utility>
+
+using namespace Esri::ArcGISRuntime;
+
+// Number of graphics being destroyed between two looks at the clock
+static const qsizetype GraphicsPerStep = 1024;
+
+GraphicsOverlayPool::GraphicsOverlayPool(QObject *parent) :
+    QObject(parent)
+{
+}
+
+GraphicsOverlay* GraphicsOverlayPool::acquire()
+{
+    if (m_idleOverlays.isEmpty())
+    {
+        return new GraphicsOverlay(this);
+    }
+
+    return m_idleOverlays.takeLast();
+}
+
+void GraphicsOverlayPool::release(GraphicsOverlay* overlay)
+{
+    if (nullptr == overlay)
+    {
+        return;
+    }
+
+    // The pool owns the overlay from now on
+    overlay->setParent(this);
+    m_releasedOverlays.append(overlay);
+    scheduleTeardown();
+}
+
+void GraphicsOverlayPool::retire(QObject* owner)
+{
+    if (nullptr == owner)
+    {
+        return;
+    }
+
+    owner->setParent(this);
+    m_retiredOwners.append(owner);
+    scheduleTeardown();
+}
+
+qsizetype GraphicsOverlayPool::idleCount() const
+{
+    return m_idleOverlays.size();
+}
+
+bool GraphicsOverlayPool::isTearingDown() const
+{
+    return m_nextRetiredGraphic < m_retiredGraphics.size() || !m_releasedOverlays.isEmpty() || !m_retiredOwners.isEmpty();
+}
+
+void GraphicsOverlayPool::flush()
+{
+    while (teardownStep())
+    {
+    }
+}
+
+void GraphicsOverlayPool::scheduleTeardown()
+{
+    if (m_teardownScheduled)
+    {
+        return;
+    }
+
+    m_teardownScheduled = true;
+    QTimer::singleShot(0, this, &GraphicsOverlayPool::teardown);
+}
+
+void GraphicsOverlayPool::teardown()
+{
+    m_teardownScheduled = false;
+    QElapsedTimer sliceTimer;
+    sliceTimer.start();
+    bool pending = true;
+    while (pending && !sliceTimer.hasExpired(TeardownTimeSlice))
+    {
+        pending = teardownStep();
+    }
+
+    // The event loop handles user input between two slices
+    if (pending)
+    {
+        scheduleTeardown();
+    }
+}
+
+bool GraphicsOverlayPool::teardownStep()
+{
+    if (m_nextRetiredGraphic < m_retiredGraphics.size())
+    {
+        // Graphics are destroyed in the order of the children of their parent,
+        // so each of them is found at the front of the children once the
+        // graphics before it are gone
+        const qsizetype lastGraphic = qMin(m_nextRetiredGraphic + GraphicsPerStep, m_retiredGraphics.size());
+        for (; m_nextRetiredGraphic < lastGraphic; m_nextRetiredGraphic++)
+        {
+            delete m_retiredGraphics.at(m_nextRetiredGraphic);
+        }
+        if (m_retiredGraphics.size() == m_nextRetiredGraphic)
+        {
+            m_retiredGraphics.clear();
+            m_nextRetiredGraphic = 0;
+        }
+        return true;
+    }
+
+    if (!m_releasedOverlays.isEmpty())
+    {
+        // All released overlays are emptied together, because the graphics of
+        // one factory are interleaved across the overlays of a GeoJSON layer
+        QSet<QObject*> retiredGraphics;
+        QList<QObject*> parents;
+        QSet<QObject*> knownParents;
+        const QList<GraphicsOverlay*> releasedOverlays = std::exchange(m_releasedOverlays, {});
+        for (GraphicsOverlay* overlay : releasedOverlays)
+        {
+            GraphicListModel* graphics = overlay->graphics();
+            const int graphicCount = graphics->rowCount();
+            retiredGraphics.reserve(retiredGraphics.size() + graphicCount);
+            for (int row = 0; row < graphicCount; row++)
+            {
+                Graphic* graphic = graphics->at(row);
+                retiredGraphics.insert(graphic);
+                QObject* parent = graphic->parent();
+                if (!knownParents.contains(parent))
+                {
+                    knownParents.insert(parent);
+                    parents.append(parent);
+                }
+            }
+            graphics->clear();
+        }
+
+        // Deleting a child searches it in the children of its parent
+        m_retiredGraphics.reserve(retiredGraphics.size());
+        for (QObject* parent : parents)
+        {
+            if (nullptr == parent)
+            {
+                continue;
+            }
+            for (QObject* child : parent->children())
+            {
+                if (retiredGraphics.contains(child))
+                {
+                    m_retiredGraphics.append(static_cast<Graphic*>(child));
+                }
+            }
+        }
+        if (knownParents.contains(nullptr))
+        {
+            for (QObject* graphic : std::as_const(retiredGraphics))
+            {
+                if (nullptr == graphic->parent())
+                {
+                    m_retiredGraphics.append(static_cast<Graphic*>(graphic));
+                }
+            }
+        }
+
+        for (GraphicsOverlay* overlay : releasedOverlays)
+        {
+            recycle(overlay);
+        }
+        return true;
+    }
+
+    if (!m_retiredOwners.isEmpty())
+    {
+        delete m_retiredOwners.takeFirst();
+        return true;
+    }
+
+    return false;
+}
+
+void GraphicsOverlayPool::recycle(GraphicsOverlay* overlay)
+{
+    if (MaximumIdleOverlays <= m_idleOverlays.size())
+    {
+        // The overlay may still be the parent of retired graphics
+        m_retiredOwners.append(overlay);
+        return;
+    }
+
+    // Acquired overlays look like new ones, the renderer is set by the caller
+    overlay->clearSelection();
+    overlay->setRenderer(nullptr);
+    overlay->setMinScale(0.0);
+    overlay->setMaxScale(0.0);
+    overlay->setRenderingMode(GraphicsRenderingMode::Dynamic);
+    overlay->setVisible(true);
+    overlay->setOpacity(1.0f);
+    overlay->setLabelsEnabled(false);
+    overlay->labelDefinitions()->clear();
+    m_idleOverlays.append(overlay);
+}
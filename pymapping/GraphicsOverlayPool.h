@@ -0,0 +1,86 @@
+// geoint-mapping offers core mapping and Geospatial Intelligence capabilities for Python.
+// Copyright (C) 2024 Jan Tschada (gisfromscratch@live.de)
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// Additional permission under GNU LGPL version 3 section 4 and 5
+// If you modify this Program, or any covered work, by linking or combining
+// it with ArcGIS Runtime for Qt (or a modified version of that library),
+// containing parts covered by the terms of ArcGIS Runtime for Qt,
+// the licensors of this Program grant you additional permission to convey the resulting work.
+// See <https://developers.arcgis.com/qt/> for further information.
+//
+
+#ifndef GRAPHICSOVERLAYPOOL_H
+#define GRAPHICSOVERLAYPOOL_H
+
+namespace Esri
+{
+namespace ArcGISRuntime
+{
+class Graphic;
+class GraphicsOverlay;
+}
+}
+
+#include <QList>
+#include <QObject>
+
+/*!
+ * \brief Recycles graphics overlays and tears down their graphics in the background.
+ *
+ * Released overlays are emptied and their graphics are destroyed in small
+ * time slices of the event loop, so clearing the map returns at once even
+ * for millions of graphics. Emptied overlays are reset and handed out again
+ * by acquire. Retired owners, like GeoJSON layers, are destroyed after the
+ * graphics of all overlays released before them.
+ */
+class GraphicsOverlayPool : public QObject
+{
+    Q_OBJECT
+public:
+    // Number of empty overlays being kept for reuse
+    static constexpr qsizetype MaximumIdleOverlays = 16;
+    // Milliseconds of one teardown slice of the event loop
+    static constexpr qint64 TeardownTimeSlice = 8;
+
+    explicit GraphicsOverlayPool(QObject *parent = nullptr);
+
+    Esri::ArcGISRuntime::GraphicsOverlay* acquire();
+
+    // The overlay must not be part of any map view
+    void release(Esri::ArcGISRuntime::GraphicsOverlay* overlay);
+    void retire(QObject* owner);
+
+    qsizetype idleCount() const;
+    bool isTearingDown() const;
+
+    // Finishes the pending teardown on the calling thread
+    void flush();
+
+private:
+    void scheduleTeardown();
+    void teardown();
+    bool teardownStep();
+    void recycle(Esri::ArcGISRuntime::GraphicsOverlay* overlay);
+
+    QList<Esri::ArcGISRuntime::GraphicsOverlay*> m_idleOverlays;
+    QList<Esri::ArcGISRuntime::GraphicsOverlay*> m_releasedOverlays;
+    QList<QObject*> m_retiredOwners;
+    QList<Esri::ArcGISRuntime::Graphic*> m_retiredGraphics;
+    qsizetype m_nextRetiredGraphic = 0;
+    bool m_teardownScheduled = false;
+};
+
+#endif // GRAPHICSOVERLAYPOOL_H
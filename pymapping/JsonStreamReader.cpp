@@ -0,0 +1,639 @@
+// geoint-mapping offers core mapping and Geospatial Intelligence capabilities for Python.
+// Copyright (C) 2024 Jan Tschada (gisfromscratch@live.de)
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// Additional permission under GNU LGPL version 3 section 4 and 5
+// If you modify this Program, or any covered work, by linking or combining
+// it with ArcGIS Runtime for Qt (or a modified version of that library),
+// containing parts covered by the terms of ArcGIS Runtime for Qt,
+// the licensors of this Program grant you additional permission to convey the resulting work.
+// See <https://developers.arcgis.com/qt/> for further information.
+//
+#include "JsonStreamReader.h"
+
+#include <QByteArrayView>
+#include <QIODevice>
+#include <QJsonArray>
+#include <QJsonObject>
+
+static const int MaximumDepth = 512;
+
+JsonStreamReader::JsonStreamReader(QIODevice* device, qint64 chunkSize) :
+    m_device(device),
+    m_chunkSize(qMax<qint64>(chunkSize, 1024)),
+    m_position(m_buffer.constData()),
+    m_end(m_buffer.constData())
+{
+}
+
+JsonStreamReader::JsonStreamReader(const QByteArray& data) :
+    m_buffer(data),
+    m_position(m_buffer.constData()),
+    m_end(m_buffer.constData() + m_buffer.size())
+{
+}
+
+JsonStreamReader::TokenType JsonStreamReader::readNext()
+{
+    if (Invalid == m_tokenType || EndDocument == m_tokenType)
+    {
+        return m_tokenType;
+    }
+
+    if (!skipWhitespace())
+    {
+        if (m_scopes.isEmpty() && m_afterValue)
+        {
+            return m_tokenType = EndDocument;
+        }
+        return raiseError("Unexpected end of JSON document!");
+    }
+
+    char c = *m_position;
+    if (m_afterValue)
+    {
+        if (m_scopes.isEmpty())
+        {
+            return raiseError("Unexpected data after the JSON document!");
+        }
+
+        if (',' == c)
+        {
+            ++m_position;
+            m_afterValue = false;
+            if (!skipWhitespace())
+            {
+                return raiseError("Unexpected end of JSON document!");
+            }
+            c = *m_position;
+            if ('}' == c || ']' == c)
+            {
+                return raiseError("Trailing comma is not allowed!");
+            }
+        }
+        else if ('}' != c && ']' != c)
+        {
+            return raiseError("Expected ',' or a closing bracket!");
+        }
+    }
+
+    if ('}' == c || ']' == c)
+    {
+        char openingBracket = ('}' == c) ? '{' : '[';
+        if (m_scopes.isEmpty() || openingBracket != m_scopes.last() || Name == m_tokenType)
+        {
+            return raiseError("Unexpected closing bracket!");
+        }
+
+        m_scopes.removeLast();
+        ++m_position;
+        m_afterValue = true;
+        return m_tokenType = ('}' == c) ? EndObject : EndArray;
+    }
+
+    bool insideObject = !m_scopes.isEmpty() && '{' == m_scopes.last();
+    if (insideObject && Name != m_tokenType)
+    {
+        // Every object member starts with a name
+        if ('"' != c)
+        {
+            return raiseError("Expected the name of an object member!");
+        }
+
+        ++m_position;
+        if (!readString())
+        {
+            return m_tokenType;
+        }
+        if (!skipWhitespace() || ':' != *m_position)
+        {
+            return raiseError("Expected ':' after the name of an object member!");
+        }
+
+        ++m_position;
+        return m_tokenType = Name;
+    }
+
+    switch (c)
+    {
+    case '{':
+    case '[':
+        if (MaximumDepth <= m_scopes.size())
+        {
+            return raiseError("JSON document is nested too deeply!");
+        }
+        m_scopes.append(c);
+        ++m_position;
+        m_afterValue = false;
+        return m_tokenType = ('{' == c) ? StartObject : StartArray;
+
+    case '"':
+        ++m_position;
+        if (!readString())
+        {
+            return m_tokenType;
+        }
+        m_afterValue = true;
+        return m_tokenType = String;
+
+    case 't':
+    case 'f':
+    case 'n':
+        return readLiteral();
+
+    default:
+        if ('-' == c || ('0' <= c && c <= '9'))
+        {
+            return readNumber();
+        }
+        return raiseError(QString("Unexpected character '%1'!").arg(QChar(c)));
+    }
+}
+
+JsonStreamReader::TokenType JsonStreamReader::tokenType() const
+{
+    return m_tokenType;
+}
+
+bool JsonStreamReader::atEnd() const
+{
+    return Invalid == m_tokenType || EndDocument == m_tokenType;
+}
+
+bool JsonStreamReader::hasError() const
+{
+    return Invalid == m_tokenType;
+}
+
+QString JsonStreamReader::errorString() const
+{
+    return m_errorString;
+}
+
+const QByteArray& JsonStreamReader::utf8Text() const
+{
+    return m_text;
+}
+
+QString JsonStreamReader::text() const
+{
+    return QString::fromUtf8(m_text);
+}
+
+double JsonStreamReader::number() const
+{
+    return m_number;
+}
+
+bool JsonStreamReader::isInteger() const
+{
+    return m_isInteger;
+}
+
+qint64 JsonStreamReader::integer() const
+{
+    return m_integer;
+}
+
+bool JsonStreamReader::boolean() const
+{
+    return m_boolean;
+}
+
+int JsonStreamReader::depth() const
+{
+    return m_scopes.size();
+}
+
+qint64 JsonStreamReader::bytesConsumed() const
+{
+    return m_consumed + (m_position - m_buffer.constData());
+}
+
+void JsonStreamReader::skipCurrentValue()
+{
+    if (Name == m_tokenType)
+    {
+        readNext();
+    }
+    if (StartObject != m_tokenType && StartArray != m_tokenType)
+    {
+        return;
+    }
+
+    int valueDepth = m_scopes.size();
+    while (!atEnd())
+    {
+        TokenType tokenType = readNext();
+        if ((EndObject == tokenType || EndArray == tokenType) && m_scopes.size() < valueDepth)
+        {
+            return;
+        }
+    }
+}
+
+QJsonValue JsonStreamReader::readCurrentValue()
+{
+    switch (m_tokenType)
+    {
+    case StartObject:
+    {
+        QJsonObject object;
+        while (Name == readNext())
+        {
+            QString name = text();
+            readNext();
+            object.insert(name, readCurrentValue());
+        }
+        return object;
+    }
+
+    case StartArray:
+    {
+        QJsonArray array;
+        for (TokenType tokenType = readNext(); EndArray != tokenType && !atEnd(); tokenType = readNext())
+        {
+            array.append(readCurrentValue());
+        }
+        return array;
+    }
+
+    case String:
+        return text();
+
+    case Number:
+        return m_isInteger ? QJsonValue(m_integer) : QJsonValue(m_number);
+
+    case Bool:
+        return m_boolean;
+
+    case Null:
+        return QJsonValue(QJsonValue::Null);
+
+    default:
+        return QJsonValue(QJsonValue::Undefined);
+    }
+}
+
+QVariant JsonStreamReader::readCurrentVariant()
+{
+    switch (m_tokenType)
+    {
+    case StartObject:
+    {
+        QVariantMap map;
+        while (Name == readNext())
+        {
+            QString name = text();
+            readNext();
+            map.insert(name, readCurrentVariant());
+        }
+        return map;
+    }
+
+    case StartArray:
+    {
+        QVariantList list;
+        for (TokenType tokenType = readNext(); EndArray != tokenType && !atEnd(); tokenType = readNext())
+        {
+            list.append(readCurrentVariant());
+        }
+        return list;
+    }
+
+    case String:
+        return text();
+
+    case Number:
+        return m_isInteger ? QVariant(m_integer) : QVariant(m_number);
+
+    case Bool:
+        return m_boolean;
+
+    case Null:
+        return QVariant::fromValue(nullptr);
+
+    default:
+        return QVariant();
+    }
+}
+
+bool JsonStreamReader::fill()
+{
+    if (!m_device)
+    {
+        return false;
+    }
+
+    m_consumed += m_end - m_buffer.constData();
+    m_buffer.resize(m_chunkSize);
+    qint64 bytesRead = m_device->read(m_buffer.data(), m_chunkSize);
+    if (bytesRead <= 0)
+    {
+        m_buffer.resize(0);
+        m_position = m_end = m_buffer.constData();
+        return false;
+    }
+
+    m_position = m_buffer.constData();
+    m_end = m_position + bytesRead;
+    return true;
+}
+
+bool JsonStreamReader::nextChar(char& c)
+{
+    if (m_position == m_end && !fill())
+    {
+        return false;
+    }
+
+    c = *m_position++;
+    return true;
+}
+
+bool JsonStreamReader::skipWhitespace()
+{
+    forever
+    {
+        while (m_position != m_end)
+        {
+            char c = *m_position;
+            if (' ' != c && '\n' != c && '\r' != c && '\t' != c)
+            {
+                return true;
+            }
+            ++m_position;
+        }
+
+        if (!fill())
+        {
+            return false;
+        }
+    }
+}
+
+JsonStreamReader::TokenType JsonStreamReader::raiseError(const QString& message)
+{
+    m_errorString = QString("%1 (offset %2)").arg(message).arg(bytesConsumed());
+    return m_tokenType = Invalid;
+}
+
+bool JsonStreamReader::readString()
+{
+    m_text.resize(0);
+    forever
+    {
+        if (m_position == m_end && !fill())
+        {
+            raiseError("Unterminated string!");
+            return false;
+        }
+
+        // Copy the unescaped characters in one go
+        const char* start = m_position;
+        while (m_position != m_end && '"' != *m_position && '\\' != *m_position)
+        {
+            ++m_position;
+        }
+        m_text.append(start, m_position - start);
+        if (m_position == m_end)
+        {
+            continue;
+        }
+
+        if ('"' == *m_position++)
+        {
+            return true;
+        }
+        if (!readEscape())
+        {
+            return false;
+        }
+    }
+}
+
+bool JsonStreamReader::readEscape()
+{
+    char c;
+    if (!nextChar(c))
+    {
+        raiseError("Unterminated escape sequence!");
+        return false;
+    }
+
+    switch (c)
+    {
+    case '"':
+    case '\\':
+    case '/':
+        m_text.append(c);
+        return true;
+    case 'b':
+        m_text.append('\b');
+        return true;
+    case 'f':
+        m_text.append('\f');
+        return true;
+    case 'n':
+        m_text.append('\n');
+        return true;
+    case 'r':
+        m_text.append('\r');
+        return true;
+    case 't':
+        m_text.append('\t');
+        return true;
+    case 'u':
+    {
+        char32_t codePoint;
+        if (!readHex4(codePoint))
+        {
+            return false;
+        }
+        if (0xD800 <= codePoint && codePoint <= 0xDBFF)
+        {
+            // A high surrogate must be followed by an escaped low surrogate
+            char backslash, u;
+            char32_t lowSurrogate;
+            if (!nextChar(backslash) || !nextChar(u) || '\\' != backslash || 'u' != u
+                || !readHex4(lowSurrogate) || lowSurrogate < 0xDC00 || 0xDFFF < lowSurrogate)
+            {
+                raiseError("Invalid UTF-16 surrogate pair!");
+                return false;
+            }
+            codePoint = 0x10000 + ((codePoint - 0xD800) << 10) + (lowSurrogate - 0xDC00);
+        }
+        appendUtf8(codePoint);
+        return true;
+    }
+    default:
+        raiseError("Invalid escape sequence!");
+        return false;
+    }
+}
+
+bool JsonStreamReader::readHex4(char32_t& codePoint)
+{
+    codePoint = 0;
+    for (int index = 0; index < 4; index++)
+    {
+        char c;
+        if (!nextChar(c))
+        {
+            raiseError("Unterminated unicode escape sequence!");
+            return false;
+        }
+
+        codePoint <<= 4;
+        if ('0' <= c && c <= '9')
+        {
+            codePoint |= c - '0';
+        }
+        else if ('a' <= c && c <= 'f')
+        {
+            codePoint |= c - 'a' + 10;
+        }
+        else if ('A' <= c && c <= 'F')
+        {
+            codePoint |= c - 'A' + 10;
+        }
+        else
+        {
+            raiseError("Invalid unicode escape sequence!");
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void JsonStreamReader::appendUtf8(char32_t codePoint)
+{
+    if (codePoint < 0x80)
+    {
+        m_text.append(static_cast<char>(codePoint));
+    }
+    else if (codePoint < 0x800)
+    {
+        m_text.append(static_cast<char>(0xC0 | (codePoint >> 6)));
+        m_text.append(static_cast<char>(0x80 | (codePoint & 0x3F)));
+    }
+    else if (codePoint < 0x10000)
+    {
+        m_text.append(static_cast<char>(0xE0 | (codePoint >> 12)));
+        m_text.append(static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F)));
+        m_text.append(static_cast<char>(0x80 | (codePoint & 0x3F)));
+    }
+    else
+    {
+        m_text.append(static_cast<char>(0xF0 | (codePoint >> 18)));
+        m_text.append(static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F)));
+        m_text.append(static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F)));
+        m_text.append(static_cast<char>(0x80 | (codePoint & 0x3F)));
+    }
+}
+
+JsonStreamReader::TokenType JsonStreamReader::readNumber()
+{
+    // Numbers may span two chunks, so they are collected first
+    char digits[64];
+    int length = 0;
+    bool integral = true;
+    forever
+    {
+        if (m_position == m_end && !fill())
+        {
+            break;
+        }
+
+        char c = *m_position;
+        if ('.' == c || 'e' == c || 'E' == c)
+        {
+            integral = false;
+        }
+        else if ('-' != c && '+' != c && (c < '0' || '9' < c))
+        {
+            break;
+        }
+
+        if (static_cast<int>(sizeof(digits)) <= length)
+        {
+            return raiseError("Number is too long!");
+        }
+        digits[length++] = c;
+        ++m_position;
+    }
+
+    QByteArrayView numberView(digits, length);
+    bool ok = false;
+    m_isInteger = false;
+    if (integral)
+    {
+        m_integer = numberView.toLongLong(&ok);
+        m_isInteger = ok;
+    }
+    m_number = m_isInteger ? static_cast<double>(m_integer) : numberView.toDouble(&ok);
+    if (!ok)
+    {
+        return raiseError("Invalid number!");
+    }
+
+    m_afterValue = true;
+    return m_tokenType = Number;
+}
+
+JsonStreamReader::TokenType JsonStreamReader::readLiteral()
+{
+    char letters[6];
+    int length = 0;
+    forever
+    {
+        if (m_position == m_end && !fill())
+        {
+            break;
+        }
+
+        char c = *m_position;
+        if (c < 'a' || 'z' < c)
+        {
+            break;
+        }
+        if (static_cast<int>(sizeof(letters)) <= length)
+        {
+            return raiseError("Invalid literal!");
+        }
+        letters[length++] = c;
+        ++m_position;
+    }
+
+    QByteArrayView literal(letters, length);
+    m_afterValue = true;
+    if (QByteArrayView("true") == literal)
+    {
+        m_boolean = true;
+        return m_tokenType = Bool;
+    }
+    if (QByteArrayView("false") == literal)
+    {
+        m_boolean = false;
+        return m_tokenType = Bool;
+    }
+    if (QByteArrayView("null") == literal)
+    {
+        return m_tokenType = Null;
+    }
+
+    return raiseError("Invalid literal!");
+}
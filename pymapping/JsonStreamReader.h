@@ -0,0 +1,119 @@
+// geoint-mapping offers core mapping and Geospatial Intelligence capabilities for Python.
+// Copyright (C) 2024 Jan Tschada (gisfromscratch@live.de)
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// Additional permission under GNU LGPL version 3 section 4 and 5
+// If you modify this Program, or any covered work, by linking or combining
+// it with ArcGIS Runtime for Qt (or a modified version of that library),
+// containing parts covered by the terms of ArcGIS Runtime for Qt,
+// the licensors of this Program grant you additional permission to convey the resulting work.
+// See <https://developers.arcgis.com/qt/> for further information.
+//
+
+#ifndef JSONSTREAMREADER_H
+#define JSONSTREAMREADER_H
+
+class QIODevice;
+
+#include <QByteArray>
+#include <QJsonValue>
+#include <QString>
+#include <QVarLengthArray>
+#include <QVariant>
+
+/*!
+ * \brief Pull-based JSON tokenizer reading from a device or a byte array.
+ *
+ * Unlike QJsonDocument no document tree is built. The reader only keeps
+ * the current token and a fixed size chunk of the input in memory, so the
+ * memory consumption does not depend on the size of the JSON document.
+ * The API follows the style of QXmlStreamReader.
+ */
+class JsonStreamReader
+{
+public:
+    enum TokenType
+    {
+        NoToken,
+        Invalid,
+        StartObject,
+        EndObject,
+        StartArray,
+        EndArray,
+        Name,
+        String,
+        Number,
+        Bool,
+        Null,
+        EndDocument
+    };
+
+    explicit JsonStreamReader(QIODevice* device, qint64 chunkSize = 64 * 1024);
+    explicit JsonStreamReader(const QByteArray& data);
+
+    TokenType readNext();
+    TokenType tokenType() const;
+
+    bool atEnd() const;
+    bool hasError() const;
+    QString errorString() const;
+
+    const QByteArray& utf8Text() const;
+    QString text() const;
+    double number() const;
+    bool isInteger() const;
+    qint64 integer() const;
+    bool boolean() const;
+
+    int depth() const;
+    qint64 bytesConsumed() const;
+
+    void skipCurrentValue();
+    QJsonValue readCurrentValue();
+    QVariant readCurrentVariant();
+
+private:
+    bool fill();
+    bool nextChar(char& c);
+    bool skipWhitespace();
+
+    TokenType raiseError(const QString& message);
+    bool readString();
+    bool readEscape();
+    bool readHex4(char32_t& codePoint);
+    void appendUtf8(char32_t codePoint);
+    TokenType readNumber();
+    TokenType readLiteral();
+
+    QIODevice* m_device = nullptr;
+    qint64 m_chunkSize = 0;
+    QByteArray m_buffer;
+    const char* m_position = nullptr;
+    const char* m_end = nullptr;
+    qint64 m_consumed = 0;
+
+    QVarLengthArray<char, 32> m_scopes;
+    bool m_afterValue = false;
+    TokenType m_tokenType = NoToken;
+
+    QByteArray m_text;
+    double m_number = 0;
+    qint64 m_integer = 0;
+    bool m_isInteger = false;
+    bool m_boolean = false;
+    QString m_errorString;
+};
+
+#endif // JSONSTREAMREADER_H
@@ -0,0 +1,286 @@
+// geoint-mapping offers core mapping and Geospatial Intelligence capabilities for Python.
+// Copyright (C) 2024 Jan Tschada (gisfromscratch@live.de)
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// Additional permission under GNU LGPL version 3 section 4 and 5
+// If you modify this Program, or any covered work, by linking or combining
+// it with ArcGIS Runtime for Qt (or a modified version of that library),
+// containing parts covered by the terms of ArcGIS Runtime for Qt,
+// the licensors of this Program grant you additional permission to convey the resulting work.
+// See <https://developers.arcgis.com/qt/> for further information.
+//
+
+#include "LoadMetrics.h"
+
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMutexLocker>
+#include <QSaveFile>
+
+#include <atomic>
+
+static thread_local LoadMetrics* s_currentMetrics = nullptr;
+
+static const char* counterName(LoadCounter counter)
+{
+    switch (counter)
+    {
+    case LoadCounter::FeaturesParsed:
+        return "featuresParsed";
+    case LoadCounter::VerticesBuilt:
+        return "verticesBuilt";
+    case LoadCounter::GraphicsAppended:
+        return "graphicsAppended";
+    case LoadCounter::BytesProcessed:
+        return "bytesProcessed";
+    }
+
+    return "unknown";
+}
+
+// Small and stable thread numbers keep the trace readable
+static int traceThreadId()
+{
+    static std::atomic<int> s_nextThreadId{1};
+    static thread_local const int threadId = s_nextThreadId.fetch_add(1);
+    return threadId;
+}
+
+LoadMetrics::LoadMetrics(const QString& operation) :
+    m_operation(operation),
+    m_begin(now()),
+    m_threadId(traceThreadId())
+{
+}
+
+QString LoadMetrics::operation() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_operation;
+}
+
+void LoadMetrics::setOperation(const QString& operation)
+{
+    QMutexLocker locker(&m_mutex);
+    m_operation = operation;
+}
+
+void LoadMetrics::finish()
+{
+    QMutexLocker locker(&m_mutex);
+    if (m_end < 0)
+    {
+        m_end = now();
+    }
+}
+
+void LoadMetrics::add(LoadCounter counter, qint64 value)
+{
+    QMutexLocker locker(&m_mutex);
+    m_counters[static_cast<int>(counter)] += value;
+}
+
+void LoadMetrics::addStage(const char* stage, qint64 begin, qint64 duration)
+{
+    QMutexLocker locker(&m_mutex);
+    StageTotal& stageTotal = m_stages[QByteArray(stage)];
+    stageTotal.duration += duration;
+    stageTotal.count++;
+    if (m_events.size() < MaximumEvents)
+    {
+        m_events.append(StageEvent{ stage, begin, duration, traceThreadId() });
+    }
+}
+
+QVariantMap LoadMetrics::toVariantMap() const
+{
+    QMutexLocker locker(&m_mutex);
+    QVariantMap metrics;
+    metrics.insert("operation", m_operation);
+    metrics.insert("elapsedMilliseconds", ((m_end < 0 ? now() : m_end) - m_begin) / 1.0e6);
+    for (int counter = 0; counter < CounterCount; counter++)
+    {
+        metrics.insert(counterName(static_cast<LoadCounter>(counter)), m_counters[counter]);
+    }
+
+    // Stages running on several threads may sum up to more than the elapsed time
+    QVariantMap stages;
+    for (auto stage = m_stages.cbegin(); stage != m_stages.cend(); stage++)
+    {
+        QVariantMap stageMetrics;
+        stageMetrics.insert("milliseconds", stage.value().duration / 1.0e6);
+        stageMetrics.insert("count", stage.value().count);
+        stages.insert(QString::fromLatin1(stage.key()), stageMetrics);
+    }
+    metrics.insert("stages", stages);
+    return metrics;
+}
+
+QVariantList LoadMetrics::traceEvents() const
+{
+    QMutexLocker locker(&m_mutex);
+    QVariantList events;
+    events.reserve(1 + m_events.size());
+
+    // The call itself spans all of its stages, timestamps are microseconds
+    QVariantMap callEvent;
+    callEvent.insert("name", m_operation);
+    callEvent.insert("cat", "load");
+    callEvent.insert("ph", "X");
+    callEvent.insert("ts", m_begin / 1.0e3);
+    callEvent.insert("dur", ((m_end < 0 ? now() : m_end) - m_begin) / 1.0e3);
+    callEvent.insert("pid", 1);
+    callEvent.insert("tid", m_threadId);
+    QVariantMap callArguments;
+    for (int counter = 0; counter < CounterCount; counter++)
+    {
+        callArguments.insert(counterName(static_cast<LoadCounter>(counter)), m_counters[counter]);
+    }
+    callEvent.insert("args", callArguments);
+    events.append(callEvent);
+
+    for (const StageEvent& stageEvent : m_events)
+    {
+        QVariantMap event;
+        event.insert("name", QString::fromLatin1(stageEvent.stage));
+        event.insert("cat", m_operation);
+        event.insert("ph", "X");
+        event.insert("ts", stageEvent.begin / 1.0e3);
+        event.insert("dur", stageEvent.duration / 1.0e3);
+        event.insert("pid", 1);
+        event.insert("tid", stageEvent.threadId);
+        events.append(event);
+    }
+
+    return events;
+}
+
+LoadMetrics* LoadMetrics::current()
+{
+    return s_currentMetrics;
+}
+
+void LoadMetrics::count(LoadCounter counter, qint64 value)
+{
+    if (nullptr != s_currentMetrics)
+    {
+        s_currentMetrics->add(counter, value);
+    }
+}
+
+qint64 LoadMetrics::now()
+{
+    static const QElapsedTimer clock = []()
+    {
+        QElapsedTimer timer;
+        timer.start();
+        return timer;
+    }();
+    return clock.nsecsElapsed();
+}
+
+LoadMetrics::Scope::Scope(LoadMetrics* metrics) :
+    m_previous(s_currentMetrics)
+{
+    s_currentMetrics = metrics;
+}
+
+LoadMetrics::Scope::~Scope()
+{
+    s_currentMetrics = m_previous;
+}
+
+ScopedLoadStage::ScopedLoadStage(const char* stage) :
+    m_metrics(LoadMetrics::current()),
+    m_stage(stage)
+{
+    if (nullptr != m_metrics)
+    {
+        m_begin = LoadMetrics::now();
+    }
+}
+
+ScopedLoadStage::~ScopedLoadStage()
+{
+    if (nullptr != m_metrics)
+    {
+        m_metrics->addStage(m_stage, m_begin, LoadMetrics::now() - m_begin);
+    }
+}
+
+void LoadMetricsLog::append(const QSharedPointer<LoadMetrics>& metrics)
+{
+    if (MaximumEntries <= m_entries.size())
+    {
+        m_entries.removeFirst();
+    }
+    m_entries.append(metrics);
+}
+
+void LoadMetricsLog::clear()
+{
+    m_entries.clear();
+}
+
+QVariantList LoadMetricsLog::toVariantList() const
+{
+    QVariantList entries;
+    entries.reserve(m_entries.size());
+    for (const QSharedPointer<LoadMetrics>& metrics : m_entries)
+    {
+        entries.append(metrics->toVariantMap());
+    }
+
+    return entries;
+}
+
+bool LoadMetricsLog::writeTrace(const QString& filePath) const
+{
+    QVariantList traceEvents;
+    for (const QSharedPointer<LoadMetrics>& metrics : m_entries)
+    {
+        traceEvents.append(metrics->traceEvents());
+    }
+
+    QJsonObject trace;
+    trace.insert("traceEvents", QJsonArray::fromVariantList(traceEvents));
+    trace.insert("displayTimeUnit", "ms");
+
+    QSaveFile traceFile(filePath);
+    if (!traceFile.open(QIODevice::WriteOnly))
+    {
+        qWarning() << "Trace file cannot be written!" << traceFile.errorString();
+        return false;
+    }
+
+    traceFile.write(QJsonDocument(trace).toJson(QJsonDocument::Compact));
+    return traceFile.commit();
+}
+
+LoadMetricsRecorder::LoadMetricsRecorder(LoadMetricsLog& log, const QString& operation) :
+    m_log(log),
+    m_metrics(new LoadMetrics(operation)),
+    m_scope(m_metrics.data())
+{
+}
+
+LoadMetricsRecorder::~LoadMetricsRecorder()
+{
+    m_metrics->finish();
+    m_log.append(m_metrics);
+}
@@ -0,0 +1,171 @@
+// geoint-mapping offers core mapping and Geospatial Intelligence capabilities for Python.
+// Copyright (C) 2024 Jan Tschada (gisfromscratch@live.de)
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// Additional permission under GNU LGPL version 3 section 4 and 5
+// If you modify this Program, or any covered work, by linking or combining
+// it with ArcGIS Runtime for Qt (or a modified version of that library),
+// containing parts covered by the terms of ArcGIS Runtime for Qt,
+// the licensors of this Program grant you additional permission to convey the resulting work.
+// See <https://developers.arcgis.com/qt/> for further information.
+//
+
+#ifndef LOADMETRICS_H
+#define LOADMETRICS_H
+
+#include <QByteArray>
+#include <QList>
+#include <QMap>
+#include <QMutex>
+#include <QSharedPointer>
+#include <QString>
+#include <QVariantList>
+#include <QVariantMap>
+
+enum class LoadCounter
+{
+    FeaturesParsed,
+    VerticesBuilt,
+    GraphicsAppended,
+    BytesProcessed
+};
+
+/*!
+ * \brief Counters and stage timings of one load call.
+ *
+ * The code of a load path records into the metrics being current for the
+ * calling thread, nothing is recorded when no metrics are current. A thread
+ * of a load job records into the same metrics after installing a Scope. The
+ * thread pool building the geometries installs none, so the "geometryWait"
+ * stage is the time the loading thread waits for the pool.
+ */
+class LoadMetrics
+{
+public:
+    // Upper bound of stage events being kept for the trace of one call
+    static constexpr qsizetype MaximumEvents = 10000;
+    static constexpr int CounterCount = 4;
+
+    explicit LoadMetrics(const QString& operation);
+
+    QString operation() const;
+    void setOperation(const QString& operation);
+    void finish();
+
+    void add(LoadCounter counter, qint64 value);
+    void addStage(const char* stage, qint64 begin, qint64 duration);
+
+    QVariantMap toVariantMap() const;
+    QVariantList traceEvents() const;
+
+    static LoadMetrics* current();
+    static void count(LoadCounter counter, qint64 value);
+    // Nanoseconds on a clock shared by all metrics of the process
+    static qint64 now();
+
+    // Makes the metrics current for the calling thread
+    class Scope
+    {
+    public:
+        explicit Scope(LoadMetrics* metrics);
+        ~Scope();
+
+    private:
+        Q_DISABLE_COPY(Scope)
+
+        LoadMetrics* m_previous = nullptr;
+    };
+
+private:
+    Q_DISABLE_COPY(LoadMetrics)
+
+    struct StageTotal
+    {
+        qint64 duration = 0;
+        qint64 count = 0;
+    };
+
+    struct StageEvent
+    {
+        const char* stage = nullptr;
+        qint64 begin = 0;
+        qint64 duration = 0;
+        int threadId = 0;
+    };
+
+    mutable QMutex m_mutex;
+    QString m_operation;
+    qint64 m_begin = 0;
+    qint64 m_end = -1;
+    qint64 m_counters[CounterCount] = {};
+    QMap<QByteArray, StageTotal> m_stages;
+    QList<StageEvent> m_events;
+    int m_threadId = 0;
+};
+
+/*!
+ * \brief Measures the enclosing block as one stage of the current metrics.
+ */
+class ScopedLoadStage
+{
+public:
+    explicit ScopedLoadStage(const char* stage);
+    ~ScopedLoadStage();
+
+private:
+    Q_DISABLE_COPY(ScopedLoadStage)
+
+    LoadMetrics* m_metrics = nullptr;
+    const char* m_stage = nullptr;
+    qint64 m_begin = 0;
+};
+
+/*!
+ * \brief The metrics of the most recent load calls.
+ */
+class LoadMetricsLog
+{
+public:
+    static constexpr qsizetype MaximumEntries = 100;
+
+    void append(const QSharedPointer<LoadMetrics>& metrics);
+    void clear();
+
+    QVariantList toVariantList() const;
+    // Writes the Chrome trace event format, see chrome://tracing or ui.perfetto.dev
+    bool writeTrace(const QString& filePath) const;
+
+private:
+    QList<QSharedPointer<LoadMetrics>> m_entries;
+};
+
+/*!
+ * \brief Records the metrics of one call and logs them when leaving the scope.
+ */
+class LoadMetricsRecorder
+{
+public:
+    LoadMetricsRecorder(LoadMetricsLog& log, const QString& operation);
+    ~LoadMetricsRecorder();
+
+private:
+    Q_DISABLE_COPY(LoadMetricsRecorder)
+
+    LoadMetricsLog& m_log;
+    QSharedPointer<LoadMetrics> m_metrics;
+    LoadMetrics::Scope m_scope;
+};
+
+#endif // LOADMETRICS_H
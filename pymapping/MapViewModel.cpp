@@ -26,13 +26,13 @@
 
 #include <algorithm>
 
-#include <QJsonArray>
-#include <QJsonDocument>
-#include <QJsonObject>
+#include <QElapsedTimer>
+#include <QQmlEngine>
 
 #include <ArcGISTiledLayer.h>
 #include <ArcGISVectorTiledLayer.h>
 #include <Basemap.h>
+#include <Envelope.h>
 #include <Error.h>
 #include <Feature.h>
 #include <FeatureCollection.h>
@@ -52,11 +52,13 @@
 #include <GraphicListModel.h>
 #include <GraphicsOverlay.h>
 #include <GraphicsOverlayListModel.h>
+#include <Layer.h>
 #include <LayerListModel.h>
 #include <Map.h>
 #include <MapQuickView.h>
 #include <MapTypes.h>
 #include <MobileMapPackage.h>
+#include <Polygon.h>
 #include <Raster.h>
 #include <RasterLayer.h>
 #include <Renderer.h>
@@ -71,8 +73,20 @@
 #include <WmtsService.h>
 #include <WmtsServiceInfo.h>
 
+#include "CoordinateArrays.h"
+#include "EsriJsonGeometryReader.h"
+#include "FeatureBinaryWriter.h"
 #include "GeoElementsOverlayModel.h"
+#include "GeoJsonLoadJob.h"
+#include "GeoPackagePrefetchJob.h"
+#include "GraphicsFactory.h"
+#include "GraphicsOverlayIndex.h"
+#include "GraphicsOverlayPool.h"
+#include "LoadMetrics.h"
+#include "RendererCache.h"
 #include "SimpleGeoJsonLayer.h"
+#include "VectorTilePackageWriter.h"
+#include "WorkspaceCache.h"
 
 using namespace Esri::ArcGISRuntime;
 
@@ -82,11 +96,29 @@ MapViewModel::MapViewModel(QObject *parent /* = nullptr */)
     , m_geometryEditor(new GeometryEditor(this))
     , m_sketchTool(new VertexTool(this))
     , m_overlayModel(new GeoElementsOverlayModel(this))
+    , m_overlayPool(new GraphicsOverlayPool(this))
+    , m_rendererCache(new RendererCache(this))
 {
     qDebug() << "Map view model was instantiated.";
 }
 
-MapViewModel::~MapViewModel() {}
+MapViewModel::~MapViewModel()
+{
+    // Cached workspaces and the maps of cached packages outlive the view model
+    removeOwnedLayers();
+    WorkspaceCache::instance()->release(m_mapPackage);
+
+    // The layers were created after the renderer cache, so the children would be
+    // destroyed in the wrong order, the overlays must go before their renderers
+    qDeleteAll(m_geojsonLayers);
+    m_geojsonLayers.clear();
+    m_liveGeoJsonLayers.clear();
+    qDeleteAll(m_graphicLayers);
+    m_graphicLayers.clear();
+    m_overlayPool->flush();
+    delete m_overlayPool;
+    m_overlayPool = nullptr;
+}
 
 MapQuickView *MapViewModel::mapView() const
 {
@@ -259,6 +291,7 @@ void MapViewModel::loadBasemapFromTilePackage(const QString& tilePackageFilePath
 
     // Update the basemap
     Basemap* basemap = new Basemap(tiledLayer, this);
+    removeOwnedLayers();
     m_map = new Map(basemap, this);
     m_mapView->setMap(m_map);
     qDebug() << "Map view was updated with a new map";
@@ -276,6 +309,7 @@ void MapViewModel::loadBasemapFromVectorTilePackage(const QString& vectorTilePac
 
     // Update the basemap
     Basemap* basemap = new Basemap(vectorTiledLayer, this);
+    removeOwnedLayers();
     m_map = new Map(basemap, this);
     m_mapView->setMap(m_map);
     qDebug() << "Map view was updated with a new map";
@@ -320,6 +354,7 @@ void MapViewModel::loadBasemapFromWMTS(const QString& wmtsServiceUrl, int layerI
 
         // Update the basemap
         Basemap* basemap = new Basemap(wmtsLayer, this);
+        removeOwnedLayers();
         m_map = new Map(basemap, this);
         m_mapView->setMap(m_map);
         qDebug() << "Map view was updated with a new map";
@@ -334,24 +369,22 @@ void MapViewModel::loadMapFromMobilePackage(const QString& mobileMapPackageFileP
         return;
     }
 
-    MobileMapPackage* mobileMapPackage = new MobileMapPackage(mobileMapPackageFilePath, this);
-    connect(mobileMapPackage, &MobileMapPackage::doneLoading, this, [this, mobileMapPackage, mobileMapPackageFilePath, mapIndex](const Error& error)
+    // Opening the same package again reuses its loaded maps
+    MobileMapPackage* mobileMapPackage = WorkspaceCache::instance()->acquireMobileMapPackage(mobileMapPackageFilePath);
+    WorkspaceCache::whenLoaded(mobileMapPackage, this, [this, mobileMapPackage, mobileMapPackageFilePath, mapIndex](const Error& error)
     {
         if (!error.isEmpty())
         {
             qWarning() << "Failed to load mobile map package:" << error.message();
             qWarning() << mobileMapPackageFilePath;
-            return;
-        }
-
-        if (!mobileMapPackage)
-        {
+            WorkspaceCache::instance()->release(mobileMapPackage);
             return;
         }
 
         QList<Map*> mobileMaps = mobileMapPackage->maps();
         if (mobileMaps.length() <= mapIndex)
         {
+            WorkspaceCache::instance()->release(mobileMapPackage);
             if (mobileMaps.isEmpty())
             {
                 qWarning() << "The mobile map package does not contain any map!";
@@ -364,23 +397,60 @@ void MapViewModel::loadMapFromMobilePackage(const QString& mobileMapPackageFileP
             }
         }
 
-        // Update the map
+        // Opening the package again shows the same map, so it must not keep the layers of this model
+        removeOwnedLayers();
         m_map = mobileMaps.at(mapIndex);
         m_mapView->setMap(m_map);
         qDebug() << "Map view was updated with a new map";
+
+        // The package owns the map, so it is kept until another package replaces it
+        WorkspaceCache::instance()->release(m_mapPackage);
+        m_mapPackage = mobileMapPackage;
     });
+}
+
+void MapViewModel::logLoadMetrics(GeoJsonLoadJob* loadJob, const QString& operation)
+{
+    // Background loads are logged when they are done
+    const QSharedPointer<LoadMetrics> metrics = loadJob->metrics();
+    metrics->setOperation(operation);
+    connect(loadJob, &GeoJsonLoadJob::finished, this, [this, metrics]()
+    {
+        m_loadMetrics.append(metrics);
+    });
+}
+
+SimpleGeoJsonLayer* MapViewModel::createGeoJsonLayer()
+{
+    // New layers start with the level of detail of the current scale
+    SimpleGeoJsonLayer* geojsonLayer = new SimpleGeoJsonLayer(m_rendererCache, this);
+    if (m_mapView)
+    {
+        geojsonLayer->updateScale(m_mapView->mapScale());
+    }
+
+    return geojsonLayer;
+}
+
+QSet<const GraphicsOverlay*> MapViewModel::clustersOverlays() const
+{
+    QSet<const GraphicsOverlay*> clusterOverlays;
+    for (const SimpleGeoJsonLayer* geojsonLayer : m_geojsonLayers)
+    {
+        clusterOverlays.insert(geojsonLayer->clustersOverlay());
+    }
 
-    mobileMapPackage->load();
+    return clusterOverlays;
 }
 
 bool MapViewModel::addGeoJsonFeatures(const QString& features)
 {
+    LoadMetricsRecorder metricsRecorder(m_loadMetrics, "addGeoJsonFeatures");
     qDebug() << "Try to add GeoJSON features as feature layers...";
     //qDebug() << features;
 
-    SimpleGeoJsonLayer* geojsonLayer = new SimpleGeoJsonLayer(this);
-    QJsonDocument geojsonDocument = QJsonDocument::fromJson(features.toUtf8());
-    geojsonLayer->load(geojsonDocument);
+    SimpleGeoJsonLayer* geojsonLayer = createGeoJsonLayer();
+    geojsonLayer->load(features.toUtf8());
 
     // Add the GeoJSON layer
     GraphicsOverlay* geoJsonPointsOverlay = geojsonLayer->pointsOverlay();
@@ -395,13 +465,13 @@ bool MapViewModel::addGeoJsonFeatures(const QString& features)
 
 bool MapViewModel::addGeoJsonPointFeatures(const QString& features, const QString& renderer)
 {
-    SimpleGeoJsonLayer* geojsonLayer = new SimpleGeoJsonLayer(this);
-    QJsonDocument geojsonDocument = QJsonDocument::fromJson(features.toUtf8());
-    geojsonLayer->load(geojsonDocument);
+    LoadMetricsRecorder metricsRecorder(m_loadMetrics, "addGeoJsonPointFeatures");
+    SimpleGeoJsonLayer* geojsonLayer = createGeoJsonLayer();
+    geojsonLayer->load(features.toUtf8());
 
     // Add the GeoJSON layer
     GraphicsOverlay* geoJsonPointsOverlay = geojsonLayer->pointsOverlay();
-    Renderer* geoJsonRenderer = Renderer::fromJson(renderer, this);
+    Renderer* geoJsonRenderer = m_rendererCache->renderer(renderer);
     geoJsonPointsOverlay->setRenderer(geoJsonRenderer);
     m_mapView->graphicsOverlays()->append(geoJsonPointsOverlay);
     m_geojsonLayers.append(geojsonLayer);
@@ -410,13 +480,13 @@ bool MapViewModel::addGeoJsonPointFeatures(const QString& features, const QStrin
 
 bool MapViewModel::addGeoJsonLineFeatures(const QString& features, const QString& renderer)
 {
-    SimpleGeoJsonLayer* geojsonLayer = new SimpleGeoJsonLayer(this);
-    QJsonDocument geojsonDocument = QJsonDocument::fromJson(features.toUtf8());
-    geojsonLayer->load(geojsonDocument);
+    LoadMetricsRecorder metricsRecorder(m_loadMetrics, "addGeoJsonLineFeatures");
+    SimpleGeoJsonLayer* geojsonLayer = createGeoJsonLayer();
+    geojsonLayer->load(features.toUtf8());
 
     // Add the GeoJSON layer
     GraphicsOverlay* geoJsonLinesOverlay = geojsonLayer->linesOverlay();
-    Renderer* geoJsonRenderer = Renderer::fromJson(renderer, this);
+    Renderer* geoJsonRenderer = m_rendererCache->renderer(renderer);
     geoJsonLinesOverlay->setRenderer(geoJsonRenderer);
     m_mapView->graphicsOverlays()->append(geoJsonLinesOverlay);
     m_geojsonLayers.append(geojsonLayer);
@@ -425,64 +495,333 @@ bool MapViewModel::addGeoJsonLineFeatures(const QString& features, const QString
 
 bool MapViewModel::addGeoJsonPolygonFeatures(const QString& features, const QString& renderer)
 {
-    SimpleGeoJsonLayer* geojsonLayer = new SimpleGeoJsonLayer(this);
-    QJsonDocument geojsonDocument = QJsonDocument::fromJson(features.toUtf8());
-    geojsonLayer->load(geojsonDocument);
+    LoadMetricsRecorder metricsRecorder(m_loadMetrics, "addGeoJsonPolygonFeatures");
+    SimpleGeoJsonLayer* geojsonLayer = createGeoJsonLayer();
+    geojsonLayer->load(features.toUtf8());
 
     // Add the GeoJSON layer
     GraphicsOverlay* geoJsonAreasOverlay = geojsonLayer->areasOverlay();
-    Renderer* geoJsonRenderer = Renderer::fromJson(renderer, this);
+    Renderer* geoJsonRenderer = m_rendererCache->renderer(renderer);
     geoJsonAreasOverlay->setRenderer(geoJsonRenderer);
     m_mapView->graphicsOverlays()->append(geoJsonAreasOverlay);
     m_geojsonLayers.append(geojsonLayer);
     return true;
 }
 
-void MapViewModel::addGeometries(const QString& geometries, const QString& renderer)
+GeoJsonLoadJob* MapViewModel::addGeoJsonFeaturesAsync(const QString& features)
 {
-    QJsonDocument geometriesDocument = QJsonDocument::fromJson(geometries.toUtf8());
-    if (geometriesDocument.isNull())
+    if (!m_mapView)
     {
-        qDebug() << "JSON is invalid!";
-        return;
+        return nullptr;
+    }
+
+    // The overlays are shown right away and filled while loading
+    SimpleGeoJsonLayer* geojsonLayer = createGeoJsonLayer();
+    m_mapView->graphicsOverlays()->append(geojsonLayer->pointsOverlay());
+    m_mapView->graphicsOverlays()->append(geojsonLayer->linesOverlay());
+    m_mapView->graphicsOverlays()->append(geojsonLayer->areasOverlay());
+    m_geojsonLayers.append(geojsonLayer);
+
+    // The layer owns the job, clearing the layers cancels the loading
+    GeoJsonLoadJob* loadJob = geojsonLayer->loadAsync(features.toUtf8());
+    QQmlEngine::setObjectOwnership(loadJob, QQmlEngine::CppOwnership);
+    logLoadMetrics(loadJob, "addGeoJsonFeaturesAsync");
+    return loadJob;
+}
+
+bool MapViewModel::addGeoJsonFeaturesLazy(const QString& features)
+{
+    LoadMetricsRecorder metricsRecorder(m_loadMetrics, "addGeoJsonFeaturesLazy");
+    if (!m_mapView)
+    {
+        return false;
+    }
+
+    // Only the features around the visible area get graphics
+    SimpleGeoJsonLayer* geojsonLayer = createGeoJsonLayer();
+    geojsonLayer->loadLazy(features.toUtf8());
+    m_mapView->graphicsOverlays()->append(geojsonLayer->pointsOverlay());
+    m_mapView->graphicsOverlays()->append(geojsonLayer->linesOverlay());
+    m_mapView->graphicsOverlays()->append(geojsonLayer->areasOverlay());
+    m_geojsonLayers.append(geojsonLayer);
+    geojsonLayer->updateViewport(m_mapView->visibleArea().extent());
+    return true;
+}
+
+bool MapViewModel::addGeoJsonFeaturesClustered(const QString& features)
+{
+    LoadMetricsRecorder metricsRecorder(m_loadMetrics, "addGeoJsonFeaturesClustered");
+    if (!m_mapView)
+    {
+        return false;
+    }
+
+    // Points are shown as clusters until the deepest cluster level is passed
+    SimpleGeoJsonLayer* geojsonLayer = createGeoJsonLayer();
+    geojsonLayer->loadLazy(features.toUtf8());
+    geojsonLayer->enableClustering();
+    m_mapView->graphicsOverlays()->append(geojsonLayer->areasOverlay());
+    m_mapView->graphicsOverlays()->append(geojsonLayer->linesOverlay());
+    m_mapView->graphicsOverlays()->append(geojsonLayer->pointsOverlay());
+    m_mapView->graphicsOverlays()->append(geojsonLayer->clustersOverlay());
+    m_geojsonLayers.append(geojsonLayer);
+    geojsonLayer->updateViewport(m_mapView->visibleArea().extent());
+    return true;
+}
+
+bool MapViewModel::addGeoJsonFeaturesFromFile(const QString& filePath)
+{
+    LoadMetricsRecorder metricsRecorder(m_loadMetrics, "addGeoJsonFeaturesFromFile");
+    if (!m_mapView)
+    {
+        return false;
+    }
+
+    // The file is parsed from the mapped pages, no string copy is made
+    SimpleGeoJsonLayer* geojsonLayer = createGeoJsonLayer();
+    const bool loaded = geojsonLayer->loadFile(filePath);
+    m_mapView->graphicsOverlays()->append(geojsonLayer->pointsOverlay());
+    m_mapView->graphicsOverlays()->append(geojsonLayer->linesOverlay());
+    m_mapView->graphicsOverlays()->append(geojsonLayer->areasOverlay());
+    m_geojsonLayers.append(geojsonLayer);
+    return loaded;
+}
+
+GeoJsonLoadJob* MapViewModel::addGeoJsonFeaturesFromFileAsync(const QString& filePath)
+{
+    if (!m_mapView)
+    {
+        return nullptr;
     }
-    if (!geometriesDocument.isArray())
+
+    SimpleGeoJsonLayer* geojsonLayer = createGeoJsonLayer();
+    m_mapView->graphicsOverlays()->append(geojsonLayer->pointsOverlay());
+    m_mapView->graphicsOverlays()->append(geojsonLayer->linesOverlay());
+    m_mapView->graphicsOverlays()->append(geojsonLayer->areasOverlay());
+    m_geojsonLayers.append(geojsonLayer);
+
+    GeoJsonLoadJob* loadJob = geojsonLayer->loadFileAsync(filePath);
+    QQmlEngine::setObjectOwnership(loadJob, QQmlEngine::CppOwnership);
+    logLoadMetrics(loadJob, "addGeoJsonFeaturesFromFileAsync");
+    return loadJob;
+}
+
+bool MapViewModel::addGeoJsonFeaturesLazyFromFile(const QString& filePath)
+{
+    LoadMetricsRecorder metricsRecorder(m_loadMetrics, "addGeoJsonFeaturesLazyFromFile");
+    if (!m_mapView)
     {
-        qDebug() << "JSON document is not an array!";
+        return false;
+    }
+
+    SimpleGeoJsonLayer* geojsonLayer = createGeoJsonLayer();
+    const bool loaded = geojsonLayer->loadLazyFile(filePath);
+    m_mapView->graphicsOverlays()->append(geojsonLayer->pointsOverlay());
+    m_mapView->graphicsOverlays()->append(geojsonLayer->linesOverlay());
+    m_mapView->graphicsOverlays()->append(geojsonLayer->areasOverlay());
+    m_geojsonLayers.append(geojsonLayer);
+    geojsonLayer->updateViewport(m_mapView->visibleArea().extent());
+    return loaded;
+}
+
+bool MapViewModel::addFeatureBinary(const QString& filePath, const QString& extent)
+{
+    LoadMetricsRecorder metricsRecorder(m_loadMetrics, "addFeatureBinary");
+    if (!m_mapView)
+    {
+        return false;
+    }
+
+    // An empty extent loads every feature of the file
+    const Envelope loadExtent = extent.isEmpty() ? Envelope() : Geometry::fromJson(extent).extent();
+    SimpleGeoJsonLayer* geojsonLayer = createGeoJsonLayer();
+    const bool added = geojsonLayer->loadBinary(filePath, loadExtent);
+    m_mapView->graphicsOverlays()->append(geojsonLayer->pointsOverlay());
+    m_mapView->graphicsOverlays()->append(geojsonLayer->linesOverlay());
+    m_mapView->graphicsOverlays()->append(geojsonLayer->areasOverlay());
+    m_geojsonLayers.append(geojsonLayer);
+    return added;
+}
+
+bool MapViewModel::writeFeatureBinary(const QString& filePath) const
+{
+    if (!m_mapView)
+    {
+        return false;
+    }
+
+    // The graphics of all overlays end up in one file, clusters only summarize the points
+    const QSet<const GraphicsOverlay*> clusterOverlays = clustersOverlays();
+    FeatureBinaryWriter featureWriter;
+    GraphicsOverlayListModel* graphicsOverlays = m_mapView->graphicsOverlays();
+    for (int overlayIndex = 0; overlayIndex < graphicsOverlays->size(); overlayIndex++)
+    {
+        GraphicsOverlay* graphicsOverlay = graphicsOverlays->at(overlayIndex);
+        if (!clusterOverlays.contains(graphicsOverlay))
+        {
+            featureWriter.append(graphicsOverlay);
+        }
+    }
+
+    if (!featureWriter.write(filePath))
+    {
+        qWarning() << "Binary features were not written!" << featureWriter.errorString();
+        return false;
+    }
+    return true;
+}
+
+bool MapViewModel::writeVectorTilePackage(const QString& filePath, int minLevel, int maxLevel) const
+{
+    if (!m_mapView)
+    {
+        return false;
+    }
+
+    // Every visible overlay becomes one layer of the vector tiles,
+    // points hidden by their clusters are written instead of the clusters
+    QSet<const GraphicsOverlay*> clusteredOverlays;
+    for (const SimpleGeoJsonLayer* geojsonLayer : m_geojsonLayers)
+    {
+        if (geojsonLayer->clustersOverlay()->isVisible())
+        {
+            clusteredOverlays.insert(geojsonLayer->pointsOverlay());
+        }
+    }
+    const QSet<const GraphicsOverlay*> clusterOverlays = clustersOverlays();
+    VectorTilePackageWriter tileWriter;
+    tileWriter.setLevels(minLevel, maxLevel);
+    GraphicsOverlayListModel* graphicsOverlays = m_mapView->graphicsOverlays();
+    for (int overlayIndex = 0; overlayIndex < graphicsOverlays->size(); overlayIndex++)
+    {
+        GraphicsOverlay* graphicsOverlay = graphicsOverlays->at(overlayIndex);
+        if (clusterOverlays.contains(graphicsOverlay) || (!graphicsOverlay->isVisible() && !clusteredOverlays.contains(graphicsOverlay)))
+        {
+            continue;
+        }
+
+        const QString layerName = graphicsOverlay->overlayId().isEmpty() ? QString("overlay%1").arg(overlayIndex) : graphicsOverlay->overlayId();
+        tileWriter.append(layerName, graphicsOverlay);
+    }
+
+    if (!tileWriter.write(filePath))
+    {
+        qWarning() << "Vector tile package was not written!" << tileWriter.errorString();
+        return false;
+    }
+    return true;
+}
+
+QVariantMap MapViewModel::upsertGeoJsonFeatures(const QString& layerId, const QString& features, const QString& idProperty, bool removeMissing)
+{
+    LoadMetricsRecorder metricsRecorder(m_loadMetrics, "upsertGeoJsonFeatures");
+    QVariantMap result;
+    if (!m_mapView)
+    {
+        return result;
+    }
+
+    // Every live layer is created by its first update
+    QElapsedTimer upsertTimer;
+    upsertTimer.start();
+    SimpleGeoJsonLayer* geojsonLayer = m_liveGeoJsonLayers.value(layerId);
+    if (nullptr == geojsonLayer)
+    {
+        geojsonLayer = createGeoJsonLayer();
+        m_mapView->graphicsOverlays()->append(geojsonLayer->areasOverlay());
+        m_mapView->graphicsOverlays()->append(geojsonLayer->linesOverlay());
+        m_mapView->graphicsOverlays()->append(geojsonLayer->pointsOverlay());
+        m_geojsonLayers.append(geojsonLayer);
+        m_liveGeoJsonLayers.insert(layerId, geojsonLayer);
+    }
+
+    const GeoJsonUpsertStatistics statistics = geojsonLayer->upsert(features.toUtf8(), idProperty, removeMissing);
+    result.insert("inserted", statistics.inserted);
+    result.insert("updated", statistics.updated);
+    result.insert("replaced", statistics.replaced);
+    result.insert("removed", statistics.removed);
+    result.insert("skipped", statistics.skipped);
+    result.insert("elapsedMilliseconds", upsertTimer.nsecsElapsed() / 1.0e6);
+    return result;
+}
+
+void MapViewModel::addGeometries(const QString& geometries, const QString& renderer)
+{
+    LoadMetricsRecorder metricsRecorder(m_loadMetrics, "addGeometries");
+    const QByteArray geometriesJson = geometries.toUtf8();
+    LoadMetrics::count(LoadCounter::BytesProcessed, geometriesJson.size());
+
+    // The geometries are decoded from the JSON tokens, not one document per geometry
+    EsriJsonGeometryReader geometryReader(geometriesJson);
+    const QList<Geometry> esriGeometries = GraphicsFactory::createEsriJsonGeometries(geometryReader);
+    if (geometryReader.hasError())
+    {
+        qDebug() << "JSON is invalid!" << geometryReader.errorString();
         return;
     }
 
-    GraphicsOverlay* graphicsOverlay = new GraphicsOverlay(this);
-    Renderer* graphicsRenderer = Renderer::fromJson(renderer, graphicsOverlay);
+    GraphicsOverlay* graphicsOverlay = m_overlayPool->acquire();
+    Renderer* graphicsRenderer = m_rendererCache->renderer(renderer);
     graphicsOverlay->setRenderer(graphicsRenderer);
-    QJsonArray geometriesArray = geometriesDocument.array();
-    foreach (const QJsonValue& geometryValue, geometriesArray)
+    GraphicsOverlayIndex::attach(graphicsOverlay);
+    QList<Graphic*> geoElements;
+    geoElements.reserve(esriGeometries.size());
     {
-        if (geometryValue.isObject())
+        ScopedLoadStage graphicsStage("graphics");
+        for (const Geometry& geometry : esriGeometries)
         {
-            QJsonDocument geometryDocument(geometryValue.toObject());
-            Geometry geometry = Geometry::fromJson(geometryDocument.toJson(QJsonDocument::Compact));
-            Graphic* geoElement = new Graphic(geometry, graphicsOverlay);
-            graphicsOverlay->graphics()->append(geoElement);
+            geoElements.append(new Graphic(geometry, graphicsOverlay));
         }
     }
+    GraphicsFactory::appendGraphics(graphicsOverlay, geoElements);
     m_mapView->graphicsOverlays()->append(graphicsOverlay);
+    m_graphicLayers.append(graphicsOverlay);
+}
 
-    /*
-    GraphicListModel* graphics = geoJsonAreasOverlay->graphics();
-    QList<GeoElement*> graphicsList;
-    graphicsList.reserve(graphics->size());
-    std::for_each(graphics->begin(), graphics->end(), [&graphicsList](Graphic* graphic)
+bool MapViewModel::addGeometryArrays(GeometryType geometryType,
+                                     const CoordinateArrays& coordinates,
+                                     const QList<QVariantMap>& attributes,
+                                     const QString& renderer,
+                                     int wkid)
+{
+    LoadMetricsRecorder metricsRecorder(m_loadMetrics, "addGeometryArrays");
+    if (!m_mapView)
     {
-        graphicsList.append(static_cast<GeoElement*>(graphic));
-    });
-    FeatureCollectionTable* geojsonFeatureCollectionTable = new FeatureCollectionTable(graphicsList, QList<Field>(), this);
-    geojsonFeatureCollectionTable->setRenderer(geoJsonRenderer);
-    FeatureCollection* geojsonFeatureCollection = new FeatureCollection(this);
-    geojsonFeatureCollection->tables()->append(geojsonFeatureCollectionTable);
-    FeatureCollectionLayer* geojsonFeatureCollectionLayer = new FeatureCollectionLayer(geojsonFeatureCollection, this);
-    m_map->operationalLayers()->append(geojsonFeatureCollectionLayer);
-    */
+        return false;
+    }
+
+    GraphicsOverlay* graphicsOverlay = m_overlayPool->acquire();
+    Renderer* graphicsRenderer = m_rendererCache->renderer(renderer);
+    graphicsOverlay->setRenderer(graphicsRenderer);
+    GraphicsOverlayIndex::attach(graphicsOverlay);
+
+    // The geometries are built straight from the arrays, no JSON involved
+    QList<Geometry> geometries;
+    {
+        ScopedLoadStage geometryWaitStage("geometryWait");
+        geometries = GraphicsFactory::createArrayGeometries(geometryType, coordinates, SpatialReference(wkid));
+    }
+    LoadMetrics::count(LoadCounter::VerticesBuilt, coordinates.pointCount);
+    QList<Graphic*> geoElements;
+    geoElements.reserve(geometries.size());
+    {
+        ScopedLoadStage graphicsStage("graphics");
+        for (qsizetype index = 0; index < geometries.size(); index++)
+        {
+            if (index < attributes.size())
+            {
+                geoElements.append(new Graphic(geometries.at(index), attributes.at(index), graphicsOverlay));
+            }
+            else
+            {
+                geoElements.append(new Graphic(geometries.at(index), graphicsOverlay));
+            }
+        }
+    }
+    GraphicsFactory::appendGraphics(graphicsOverlay, geoElements);
+    m_mapView->graphicsOverlays()->append(graphicsOverlay);
+    m_graphicLayers.append(graphicsOverlay);
+    return !geoElements.isEmpty();
 }
 
 void MapViewModel::addFeatureLayer(const QString& featureServiceUrl)
@@ -495,46 +834,125 @@ void MapViewModel::addFeatureLayer(const QString& featureServiceUrl)
 
 void MapViewModel::addFeatureLayerFromMobile(const QString& workspacePath, const QString& featureClassName)
 {
-    Geodatabase* geodatabase = new Geodatabase(workspacePath, this);
-    connect(geodatabase, &Geodatabase::doneLoading, this, [this, geodatabase, workspacePath, featureClassName](const Error& error)
+    Geodatabase* geodatabase = WorkspaceCache::instance()->acquireGeodatabase(workspacePath);
+    WorkspaceCache::whenLoaded(geodatabase, this, [this, geodatabase, workspacePath, featureClassName](const Error& error)
     {
         if (!error.isEmpty())
         {
             qWarning() << "Failed to load mobile geodatabase:" << error.message();
             qWarning() << workspacePath << ":" << featureClassName;
+            WorkspaceCache::instance()->release(geodatabase);
             return;
         }
 
         GeodatabaseFeatureTable* geodatabaseFeatureTable = geodatabase->geodatabaseFeatureTable(featureClassName);
+        if (!geodatabaseFeatureTable)
+        {
+            qWarning() << "The mobile geodatabase has no feature class" << featureClassName;
+            WorkspaceCache::instance()->release(geodatabase);
+            return;
+        }
+
+        // The cached table already has its layer
+        if (m_tableLayers.contains(geodatabaseFeatureTable))
+        {
+            qDebug() << "The feature class" << featureClassName << "is already shown";
+            WorkspaceCache::instance()->release(geodatabase);
+            return;
+        }
+
         FeatureLayer* featureLayer = new FeatureLayer(geodatabaseFeatureTable, this);
         m_map->operationalLayers()->append(featureLayer);
+        m_tableLayers.insert(geodatabaseFeatureTable, featureLayer);
+        m_layerWorkspaces.append(geodatabase);
     });
-    geodatabase->load();
 }
 
 void MapViewModel::addFeatureLayerFromGeoPackage(const QString& workspacePath, const QString& featureClassName)
 {
-    GeoPackage* geopackage = new GeoPackage(workspacePath, this);
-    connect(geopackage, &GeoPackage::doneLoading, this, [this, geopackage, workspacePath, featureClassName](const Error& error)
+    // Switching between the feature classes of one GeoPackage does not open it again
+    GeoPackage* geopackage = WorkspaceCache::instance()->acquireGeoPackage(workspacePath);
+    WorkspaceCache::whenLoaded(geopackage, this, [this, geopackage, workspacePath, featureClassName](const Error& error)
     {
         if (!error.isEmpty())
         {
             qWarning() << "Failed to load geopackage:" << error.message();
             qWarning() << workspacePath << ":" << featureClassName;
+            WorkspaceCache::instance()->release(geopackage);
             return;
         }
 
+        bool layerAdded = false;
         QList<GeoPackageFeatureTable*> featureTables = geopackage->geoPackageFeatureTables();
         for (GeoPackageFeatureTable* featureTable : featureTables)
         {
-            if (featureClassName.isEmpty() || featureClassName == featureTable->tableName())
+            // The cached tables already having a layer keep it
+            if ((featureClassName.isEmpty() || featureClassName == featureTable->tableName()) && !m_tableLayers.contains(featureTable))
             {
                 FeatureLayer* featureLayer = new FeatureLayer(featureTable, this);
                 m_map->operationalLayers()->append(featureLayer);
+                m_tableLayers.insert(featureTable, featureLayer);
+                layerAdded = true;
             }
         }
+
+        if (layerAdded)
+        {
+            m_layerWorkspaces.append(geopackage);
+        }
+        else
+        {
+            WorkspaceCache::instance()->release(geopackage);
+        }
     });
-    geopackage->load();
+}
+
+GeoPackagePrefetchJob* MapViewModel::addFeatureLayersFromGeoPackageAsync(const QString& workspacePath, const QStringList& featureClassNames, const QString& extent)
+{
+    if (!m_mapView)
+    {
+        return nullptr;
+    }
+
+    // The features within the visible area are queried before the layers are added
+    const Envelope prefetchExtent = extent.isEmpty() ? m_mapView->visibleArea().extent() : Geometry::fromJson(extent).extent();
+    GeoPackage* geopackage = WorkspaceCache::instance()->acquireGeoPackage(workspacePath);
+    GeoPackagePrefetchJob* prefetchJob = new GeoPackagePrefetchJob(geopackage, featureClassNames, prefetchExtent, this);
+    QQmlEngine::setObjectOwnership(prefetchJob, QQmlEngine::CppOwnership);
+    connect(prefetchJob, &GeoPackagePrefetchJob::finished, this, [this, prefetchJob, geopackage](bool succeeded)
+    {
+        // The job stays a child of this model, so the caller can still read it
+        m_prefetchJobs.removeOne(prefetchJob);
+        if (!succeeded)
+        {
+            WorkspaceCache::instance()->release(geopackage);
+            return;
+        }
+
+        // One append lets the map view handle all layers at once
+        QList<Layer*> featureLayers;
+        const QList<GeoPackageFeatureTable*> featureTables = prefetchJob->featureTables();
+        for (GeoPackageFeatureTable* featureTable : featureTables)
+        {
+            if (!m_tableLayers.contains(featureTable))
+            {
+                FeatureLayer* featureLayer = new FeatureLayer(featureTable, this);
+                featureLayers.append(featureLayer);
+                m_tableLayers.insert(featureTable, featureLayer);
+            }
+        }
+        if (featureLayers.isEmpty())
+        {
+            WorkspaceCache::instance()->release(geopackage);
+            return;
+        }
+
+        m_map->operationalLayers()->append(featureLayers);
+        m_layerWorkspaces.append(geopackage);
+    });
+    m_prefetchJobs.append(prefetchJob);
+    prefetchJob->start();
+    return prefetchJob;
 }
 
 void MapViewModel::addRasterLayer(const QString& rasterFilePath, float opacity)
@@ -547,28 +965,152 @@ void MapViewModel::addRasterLayer(const QString& rasterFilePath, float opacity)
 
 void MapViewModel::addRasterLayerFromGeoPackage(const QString& workspacePath, const QString& rasterName, float opacity)
 {
-    GeoPackage* geopackage = new GeoPackage(workspacePath, this);
-    connect(geopackage, &GeoPackage::doneLoading, this, [this, geopackage, workspacePath, rasterName, opacity](const Error& error)
+    GeoPackage* geopackage = WorkspaceCache::instance()->acquireGeoPackage(workspacePath);
+    WorkspaceCache::whenLoaded(geopackage, this, [this, geopackage, workspacePath, rasterName, opacity](const Error& error)
     {
         if (!error.isEmpty())
         {
             qWarning() << "Failed to load geopackage:" << error.message();
             qWarning() << workspacePath << ":" << rasterName;
+            WorkspaceCache::instance()->release(geopackage);
             return;
         }
 
+        bool layerAdded = false;
         QList<GeoPackageRaster*> rasters = geopackage->geoPackageRasters();
         for (GeoPackageRaster* raster : rasters)
         {
-            if (rasterName.isEmpty() || rasterName == raster->objectName())
+            if (!rasterName.isEmpty() && rasterName != raster->objectName())
+            {
+                continue;
+            }
+
+            // The cached raster already has its layer, only the opacity changes
+            Layer* existingLayer = m_tableLayers.value(raster);
+            if (nullptr != existingLayer)
             {
-                RasterLayer* rasterLayer = new RasterLayer(raster, this);
-                rasterLayer->setOpacity(opacity);
-                m_map->operationalLayers()->append(rasterLayer);
+                existingLayer->setOpacity(opacity);
+                continue;
             }
+
+            RasterLayer* rasterLayer = new RasterLayer(raster, this);
+            rasterLayer->setOpacity(opacity);
+            m_map->operationalLayers()->append(rasterLayer);
+            m_tableLayers.insert(raster, rasterLayer);
+            layerAdded = true;
+        }
+
+        if (layerAdded)
+        {
+            m_layerWorkspaces.append(geopackage);
+        }
+        else
+        {
+            WorkspaceCache::instance()->release(geopackage);
         }
     });
-    geopackage->load();
+}
+
+static QVariantList toGeoElementReferences(int overlayIndex, const QList<qsizetype>& elementIndices)
+{
+    QVariantList geoElements;
+    geoElements.reserve(elementIndices.size());
+    for (qsizetype elementIndex : elementIndices)
+    {
+        QVariantMap geoElement;
+        geoElement.insert("overlayIndex", overlayIndex);
+        geoElement.insert("elementIndex", elementIndex);
+        geoElements.append(geoElement);
+    }
+
+    return geoElements;
+}
+
+QVariantList MapViewModel::identifyGraphics(double screenX, double screenY, double tolerance, int maximumCount) const
+{
+    QVariantList geoElements;
+    if (!m_mapView)
+    {
+        return geoElements;
+    }
+
+    // The search extent covers the tolerance in screen pixels around the location
+    const Point lowerLeft = m_mapView->screenToLocation(screenX - tolerance, screenY + tolerance);
+    const Point upperRight = m_mapView->screenToLocation(screenX + tolerance, screenY - tolerance);
+    if (lowerLeft.isEmpty() || upperRight.isEmpty())
+    {
+        return geoElements;
+    }
+
+    // Overlays being drawn on top are identified first
+    const Envelope searchExtent(lowerLeft, upperRight);
+    GraphicsOverlayListModel* overlays = m_mapView->graphicsOverlays();
+    for (int overlayIndex = overlays->rowCount() - 1; 0 <= overlayIndex; overlayIndex--)
+    {
+        const int remainingCount = maximumCount < 0 ? -1 : maximumCount - static_cast<int>(geoElements.size());
+        if (0 == remainingCount)
+        {
+            break;
+        }
+
+        GraphicsOverlay* overlay = overlays->at(overlayIndex);
+        const GraphicsOverlayIndex* spatialIndex = GraphicsOverlayIndex::find(overlay);
+        if (nullptr != spatialIndex && overlay->isVisible())
+        {
+            geoElements.append(toGeoElementReferences(overlayIndex, spatialIndex->identify(searchExtent, remainingCount)));
+        }
+    }
+
+    return geoElements;
+}
+
+QVariantList MapViewModel::queryGraphics(const QString& extent, int maximumCount) const
+{
+    QVariantList geoElements;
+    if (!m_mapView)
+    {
+        return geoElements;
+    }
+
+    const Envelope queryExtent = Geometry::fromJson(extent).extent();
+    if (queryExtent.isEmpty())
+    {
+        qWarning() << "The query extent is invalid!";
+        return geoElements;
+    }
+
+    GraphicsOverlayListModel* overlays = m_mapView->graphicsOverlays();
+    for (int overlayIndex = 0; overlayIndex < overlays->rowCount(); overlayIndex++)
+    {
+        const int remainingCount = maximumCount < 0 ? -1 : maximumCount - static_cast<int>(geoElements.size());
+        if (0 == remainingCount)
+        {
+            break;
+        }
+
+        const GraphicsOverlayIndex* spatialIndex = GraphicsOverlayIndex::find(overlays->at(overlayIndex));
+        if (nullptr != spatialIndex)
+        {
+            geoElements.append(toGeoElementReferences(overlayIndex, spatialIndex->query(queryExtent, remainingCount)));
+        }
+    }
+
+    return geoElements;
+}
+
+QVariantList MapViewModel::loadMetrics() const
+{
+    return m_loadMetrics.toVariantList();
+}
+
+void MapViewModel::clearLoadMetrics()
+{
+    m_loadMetrics.clear();
+}
+
+bool MapViewModel::writeLoadTrace(const QString& filePath) const
+{
+    return m_loadMetrics.writeTrace(filePath);
 }
 
 void MapViewModel::clearGraphicOverlays()
@@ -581,23 +1123,67 @@ void MapViewModel::clearGraphicOverlays()
     // Remove all graphic overlays
     m_mapView->graphicsOverlays()->clear();
 
-    // Remove and destroy every GeoJSON layers
-    // Should also destroy every create Graphic instance
-    qDeleteAll(m_geojsonLayers.begin(), m_geojsonLayers.end());
+    // The graphics are destroyed by the pool while the event loop keeps running,
+    // the emptied overlays are reused by the next graphics being added
+    for (SimpleGeoJsonLayer* geojsonLayer : m_geojsonLayers)
+    {
+        const QList<GraphicsOverlay*> layerOverlays = geojsonLayer->takeOverlays();
+        for (GraphicsOverlay* layerOverlay : layerOverlays)
+        {
+            m_overlayPool->release(layerOverlay);
+        }
+        m_overlayPool->retire(geojsonLayer);
+    }
     m_geojsonLayers.clear();
+    m_liveGeoJsonLayers.clear();
 
-    // Remove and destroy every graphic overlays
-    // Should also destroy every create Graphic instance
-    qDeleteAll(m_graphicLayers.begin(), m_graphicLayers.end());
+    for (GraphicsOverlay* graphicsOverlay : m_graphicLayers)
+    {
+        m_overlayPool->release(graphicsOverlay);
+    }
     m_graphicLayers.clear();
 }
 
 void MapViewModel::clearOperationalLayers()
 {
+    // Pending prefetches must not add their layers afterwards,
+    // canceled jobs finish at once and remove themselves
+    const QList<GeoPackagePrefetchJob*> prefetchJobs = m_prefetchJobs;
+    for (GeoPackagePrefetchJob* prefetchJob : prefetchJobs)
+    {
+        prefetchJob->cancel();
+    }
+
     // Remove all operational layers (feature, raster)
+    removeOwnedLayers();
     m_map->operationalLayers()->clear();
 }
 
+void MapViewModel::removeOwnedLayers()
+{
+    if (m_map)
+    {
+        LayerListModel* operationalLayers = m_map->operationalLayers();
+        for (int layerIndex = operationalLayers->size() - 1; 0 <= layerIndex; layerIndex--)
+        {
+            Layer* layer = operationalLayers->at(layerIndex);
+            if (this == layer->parent())
+            {
+                operationalLayers->removeAt(layerIndex);
+                delete layer;
+            }
+        }
+    }
+
+    // The tables are free for new layers, the workspaces stay cached
+    m_tableLayers.clear();
+    for (QObject* workspace : m_layerWorkspaces)
+    {
+        WorkspaceCache::instance()->release(workspace);
+    }
+    m_layerWorkspaces.clear();
+}
+
 void MapViewModel::startSketching(SketchEditorMode sketchEditorMode)
 {
     if (m_geometryEditor->isStarted())
@@ -660,10 +1246,34 @@ void MapViewModel::onMouseClicked(QMouseEvent& mouseEvent)
     QPointF screenPosition = mouseEvent.position();
     Point mapClickLocation = m_mapView->screenToLocation(screenPosition.x(), screenPosition.y());
     emit mapViewClicked(mapClickLocation.toJson());
+
+    // Emit the graphics next to the clicked location
+    if (!m_geometryEditor->isStarted())
+    {
+        emit graphicsIdentified(identifyGraphics(screenPosition.x(), screenPosition.y()));
+    }
 }
 
 void MapViewModel::onViewpointChanged()
 {
     emit mapViewExtentChanged();
     emit mapViewCenterChanged();
+
+    if (!m_mapView || m_geojsonLayers.isEmpty())
+    {
+        return;
+    }
+
+    // GeoJSON layers follow the scale, lazy, clustered and simplified ones also follow the visible area
+    const double mapScale = m_mapView->mapScale();
+    const bool hasLazyLayers = std::any_of(m_geojsonLayers.cbegin(), m_geojsonLayers.cend(), [](SimpleGeoJsonLayer* geojsonLayer)
+    {
+        return geojsonLayer->followsViewport();
+    });
+    const Envelope visibleArea = hasLazyLayers ? m_mapView->visibleArea().extent() : Envelope();
+    for (SimpleGeoJsonLayer* geojsonLayer : m_geojsonLayers)
+    {
+        geojsonLayer->updateScale(mapScale);
+        geojsonLayer->updateViewport(visibleArea);
+    }
 }
@@ -25,25 +25,42 @@
 #ifndef MAPVIEWMODEL_H
 #define MAPVIEWMODEL_H
 
+struct CoordinateArrays;
 class GeoElementsOverlayModel;
+class GeoJsonLoadJob;
+class GeoPackagePrefetchJob;
+class GraphicsOverlayPool;
+class RendererCache;
 class SimpleGeoJsonLayer;
 
 namespace Esri::ArcGISRuntime {
 class GeometryEditor;
 class GraphicsOverlay;
+class Layer;
 class Map;
 class MapQuickView;
+class MobileMapPackage;
 class VertexTool;
 } // namespace Esri::ArcGISRuntime
 
 #include <QObject>
+#include <QHash>
 #include <QList>
 #include <QMouseEvent>
+#include <QSet>
+#include <QStringList>
+#include <QVariantList>
+#include <QVariantMap>
 
+#include <GeometryTypes.h>
 #include <Point.h>
 
+#include "LoadMetrics.h"
+
 Q_MOC_INCLUDE("MapQuickView.h")
 Q_MOC_INCLUDE("GeoElementsOverlayModel.h")
+Q_MOC_INCLUDE("GeoJsonLoadJob.h")
+Q_MOC_INCLUDE("GeoPackagePrefetchJob.h")
 
 class MapViewModel : public QObject
 {
@@ -81,16 +98,39 @@ public:
     Q_INVOKABLE bool addGeoJsonPointFeatures(const QString& features, const QString& renderer);
     Q_INVOKABLE bool addGeoJsonLineFeatures(const QString& features, const QString& renderer);
     Q_INVOKABLE bool addGeoJsonPolygonFeatures(const QString& features, const QString& renderer);
+    Q_INVOKABLE GeoJsonLoadJob* addGeoJsonFeaturesAsync(const QString& features);
+    Q_INVOKABLE bool addGeoJsonFeaturesLazy(const QString& features);
+    Q_INVOKABLE bool addGeoJsonFeaturesClustered(const QString& features);
+    Q_INVOKABLE bool addGeoJsonFeaturesFromFile(const QString& filePath);
+    Q_INVOKABLE GeoJsonLoadJob* addGeoJsonFeaturesFromFileAsync(const QString& filePath);
+    Q_INVOKABLE bool addGeoJsonFeaturesLazyFromFile(const QString& filePath);
+    Q_INVOKABLE bool addFeatureBinary(const QString& filePath, const QString& extent=QString());
+    Q_INVOKABLE bool writeFeatureBinary(const QString& filePath) const;
+    Q_INVOKABLE bool writeVectorTilePackage(const QString& filePath, int minLevel=0, int maxLevel=14) const;
+    Q_INVOKABLE QVariantMap upsertGeoJsonFeatures(const QString& layerId, const QString& features, const QString& idProperty, bool removeMissing=true);
 
     Q_INVOKABLE void addGeometries(const QString& geometries, const QString& renderer);
+    bool addGeometryArrays(Esri::ArcGISRuntime::GeometryType geometryType,
+                           const CoordinateArrays& coordinates,
+                           const QList<QVariantMap>& attributes,
+                           const QString& renderer,
+                           int wkid = 4326);
 
     Q_INVOKABLE void addFeatureLayer(const QString& featureServiceUrl);
     Q_INVOKABLE void addFeatureLayerFromMobile(const QString& workspacePath, const QString& featureClassName);
     Q_INVOKABLE void addFeatureLayerFromGeoPackage(const QString& workspacePath, const QString& featureClassName);
+    Q_INVOKABLE GeoPackagePrefetchJob* addFeatureLayersFromGeoPackageAsync(const QString& workspacePath, const QStringList& featureClassNames=QStringList(), const QString& extent=QString());
 
     Q_INVOKABLE void addRasterLayer(const QString& rasterFilePath, float opacity=0.7f);
     Q_INVOKABLE void addRasterLayerFromGeoPackage(const QString& workspacePath, const QString& rasterName, float opacity=0.7f);
 
+    Q_INVOKABLE QVariantList identifyGraphics(double screenX, double screenY, double tolerance=8.0, int maximumCount=100) const;
+    Q_INVOKABLE QVariantList queryGraphics(const QString& extent, int maximumCount=-1) const;
+
+    Q_INVOKABLE QVariantList loadMetrics() const;
+    Q_INVOKABLE void clearLoadMetrics();
+    Q_INVOKABLE bool writeLoadTrace(const QString& filePath) const;
+
     Q_INVOKABLE void clearGraphicOverlays();
     Q_INVOKABLE void clearOperationalLayers();    
 
@@ -99,6 +139,7 @@ public:
 
 signals:
     void mapViewClicked(const QString& location);
+    void graphicsIdentified(const QVariantList& geoElements);
     void mapViewChanged();
     void mapViewExtentChanged();
     void mapViewCenterChanged();
@@ -120,14 +161,30 @@ private:
 
     GeoElementsOverlayModel* overlayModel() const;
 
+    SimpleGeoJsonLayer* createGeoJsonLayer();
+    QSet<const Esri::ArcGISRuntime::GraphicsOverlay*> clustersOverlays() const;
+    void logLoadMetrics(GeoJsonLoadJob* loadJob, const QString& operation);
+    void removeOwnedLayers();
+
     Esri::ArcGISRuntime::Map *m_map = nullptr;
     Esri::ArcGISRuntime::MapQuickView *m_mapView = nullptr;
     Esri::ArcGISRuntime::GeometryEditor *m_geometryEditor = nullptr;
     Esri::ArcGISRuntime::VertexTool *m_sketchTool = nullptr;
 
     QList<SimpleGeoJsonLayer*> m_geojsonLayers;
+    QHash<QString, SimpleGeoJsonLayer*> m_liveGeoJsonLayers;
     QList<Esri::ArcGISRuntime::GraphicsOverlay*> m_graphicLayers;
+    // Cached workspaces referenced by the current map and its layers
+    Esri::ArcGISRuntime::MobileMapPackage* m_mapPackage = nullptr;
+    QList<QObject*> m_layerWorkspaces;
+    // A table of a cached workspace is bound to one layer at a time
+    QHash<QObject*, Esri::ArcGISRuntime::Layer*> m_tableLayers;
+    QList<GeoPackagePrefetchJob*> m_prefetchJobs;
     GeoElementsOverlayModel* m_overlayModel;
+    // Destroyed by the destructor before the cache, the overlays use its renderers
+    GraphicsOverlayPool* m_overlayPool;
+    RendererCache* m_rendererCache;
+    LoadMetricsLog m_loadMetrics;
 };
 
 #endif // MAPVIEWMODEL_H
@@ -0,0 +1,83 @@
+// geoint-mapping offers core mapping and Geospatial Intelligence capabilities for Python.
+// Copyright (C) 2024 Jan Tschada (gisfromscratch@live.de)
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// Additional permission under GNU LGPL version 3 section 4 and 5
+// If you modify this Program, or any covered work, by linking or combining
+// it with ArcGIS Runtime for Qt (or a modified version of that library),
+// containing parts covered by the terms of ArcGIS Runtime for Qt,
+// the licensors of this Program grant you additional permission to convey the resulting work.
+// See <https://developers.arcgis.com/qt/> for further information.
+//
+
+#include "MappedFile.h"
+
+MappedFile::~MappedFile()
+{
+    close();
+}
+
+bool MappedFile::open(const QString& filePath)
+{
+    close();
+    m_file.setFileName(filePath);
+    if (!m_file.open(QIODevice::ReadOnly))
+    {
+        m_errorString = m_file.errorString();
+        return false;
+    }
+
+    // Pages are only read from disk when they are touched
+    const qint64 fileSize = m_file.size();
+    m_mappedData = 0 < fileSize ? m_file.map(0, fileSize) : nullptr;
+    if (nullptr != m_mappedData)
+    {
+        m_data = QByteArray::fromRawData(reinterpret_cast<const char*>(m_mappedData), fileSize);
+    }
+    else
+    {
+        m_data = m_file.readAll();
+    }
+
+    m_errorString.clear();
+    return true;
+}
+
+void MappedFile::close()
+{
+    // The view must not outlive the mapping
+    m_data.clear();
+    if (nullptr != m_mappedData)
+    {
+        m_file.unmap(m_mappedData);
+        m_mappedData = nullptr;
+    }
+    m_file.close();
+}
+
+bool MappedFile::isOpen() const
+{
+    return m_file.isOpen();
+}
+
+const QByteArray& MappedFile::data() const
+{
+    return m_data;
+}
+
+QString MappedFile::errorString() const
+{
+    return m_errorString;
+}
@@ -0,0 +1,61 @@
+// geoint-mapping offers core mapping and Geospatial Intelligence capabilities for Python.
+// Copyright (C) 2024 Jan Tschada (gisfromscratch@live.de)
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// Additional permission under GNU LGPL version 3 section 4 and 5
+// If you modify this Program, or any covered work, by linking or combining
+// it with ArcGIS Runtime for Qt (or a modified version of that library),
+// containing parts covered by the terms of ArcGIS Runtime for Qt,
+// the licensors of this Program grant you additional permission to convey the resulting work.
+// See <https://developers.arcgis.com/qt/> for further information.
+//
+
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+
+#include <QByteArray>
+#include <QFile>
+#include <QString>
+
+/*!
+ * \brief Read-only view on the contents of a file mapped into memory.
+ *
+ * The data is a QByteArray referencing the mapped pages without copying
+ * them, it is only valid while the file is open. Files which cannot be
+ * mapped are read into memory instead.
+ */
+class MappedFile
+{
+public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    bool open(const QString& filePath);
+    void close();
+    bool isOpen() const;
+
+    const QByteArray& data() const;
+    QString errorString() const;
+
+private:
+    Q_DISABLE_COPY(MappedFile)
+
+    QFile m_file;
+    uchar* m_mappedData = nullptr;
+    QByteArray m_data;
+    QString m_errorString;
+};
+
+#endif // MAPPEDFILE_H
@@ -0,0 +1,235 @@
+// geoint-mapping offers core mapping and Geospatial Intelligence capabilities for Python.
+// Copyright (C) 2024 Jan Tschada (gisfromscratch@live.de)
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// Additional permission under GNU LGPL version 3 section 4 and 5
+// If you modify this Program, or any covered work, by linking or combining
+// it with ArcGIS Runtime for Qt (or a modified version of that library),
+// containing parts covered by the terms of ArcGIS Runtime for Qt,
+// the licensors of this Program grant you additional permission to convey the resulting work.
+// See <https://developers.arcgis.com/qt/> for further information.
+//
+
+#include "PackedRTree.h"
+
+#include <algorithm>
+#include <utility>
+
+PackedRTree::PackedRTree(const QList<Box>& boxes, qsizetype count)
+    : m_itemCount(count < 0 ? boxes.size() : qMin(count, boxes.size()))
+{
+    if (0 == m_itemCount)
+    {
+        return;
+    }
+
+    m_levelBounds = levelBounds(m_itemCount);
+
+    Box itemsExtent;
+    for (qsizetype index = 0; index < m_itemCount; index++)
+    {
+        if (!boxes.at(index).isEmpty())
+        {
+            itemsExtent.expand(boxes.at(index));
+        }
+    }
+
+    // Map the box centers onto a 16 bit grid covering all items
+    constexpr double hilbertMax = 0xFFFF;
+    const double width = itemsExtent.isEmpty() ? 0.0 : itemsExtent.maxX - itemsExtent.minX;
+    const double height = itemsExtent.isEmpty() ? 0.0 : itemsExtent.maxY - itemsExtent.minY;
+    QList<std::pair<quint32, qsizetype>> hilbertValues;
+    hilbertValues.reserve(m_itemCount);
+    for (qsizetype index = 0; index < m_itemCount; index++)
+    {
+        const Box& box = boxes.at(index);
+        if (box.isEmpty())
+        {
+            hilbertValues.append({ std::numeric_limits<quint32>::max(), index });
+            continue;
+        }
+
+        const double centerX = 0.0 < width ? (0.5 * (box.minX + box.maxX) - itemsExtent.minX) / width : 0.0;
+        const double centerY = 0.0 < height ? (0.5 * (box.minY + box.maxY) - itemsExtent.minY) / height : 0.0;
+        const quint32 x = static_cast<quint32>(qBound(0.0, hilbertMax * centerX, hilbertMax));
+        const quint32 y = static_cast<quint32>(qBound(0.0, hilbertMax * centerY, hilbertMax));
+        hilbertValues.append({ hilbert(x, y), index });
+    }
+    std::sort(hilbertValues.begin(), hilbertValues.end());
+
+    m_boxes.reserve(m_levelBounds.last());
+    m_indices.reserve(m_itemCount);
+    for (const auto& hilbertValue : hilbertValues)
+    {
+        m_boxes.append(boxes.at(hilbertValue.second));
+        m_indices.append(hilbertValue.second);
+    }
+
+    // Parent nodes cover NodeSize consecutive children
+    qsizetype position = 0;
+    for (qsizetype level = 0; level + 1 < m_levelBounds.size(); level++)
+    {
+        const qsizetype levelEnd = m_levelBounds.at(level);
+        while (position < levelEnd)
+        {
+            Box nodeBox;
+            for (qsizetype child = 0; child < NodeSize && position < levelEnd; child++, position++)
+            {
+                nodeBox.expand(m_boxes.at(position));
+            }
+            m_boxes.append(nodeBox);
+        }
+    }
+}
+
+PackedRTree PackedRTree::fromNodes(qsizetype itemCount, const Box* nodes, qsizetype nodeCount)
+{
+    PackedRTree tree;
+    if (itemCount <= 0 || nullptr == nodes || nodeCount != PackedRTree::nodeCount(itemCount))
+    {
+        return tree;
+    }
+
+    tree.m_itemCount = itemCount;
+    tree.m_externalNodes = nodes;
+    tree.m_levelBounds = levelBounds(itemCount);
+    return tree;
+}
+
+qsizetype PackedRTree::nodeCount(qsizetype itemCount)
+{
+    return itemCount <= 0 ? 0 : levelBounds(itemCount).last();
+}
+
+qsizetype PackedRTree::size() const
+{
+    return m_itemCount;
+}
+
+bool PackedRTree::isEmpty() const
+{
+    return 0 == m_itemCount;
+}
+
+PackedRTree::Box PackedRTree::extent() const
+{
+    return 0 == m_itemCount ? Box() : nodes()[nodeCount() - 1];
+}
+
+const PackedRTree::Box* PackedRTree::nodes() const
+{
+    return nullptr != m_externalNodes ? m_externalNodes : m_boxes.constData();
+}
+
+qsizetype PackedRTree::nodeCount() const
+{
+    return m_levelBounds.isEmpty() ? 0 : m_levelBounds.last();
+}
+
+qsizetype PackedRTree::itemIndex(qsizetype leafIndex) const
+{
+    return m_indices.isEmpty() ? leafIndex : m_indices.at(leafIndex);
+}
+
+QList<qsizetype> PackedRTree::search(const Box& box) const
+{
+    QList<qsizetype> itemIndices;
+    visit(box, [&itemIndices](qsizetype itemIndex)
+    {
+        itemIndices.append(itemIndex);
+        return true;
+    });
+
+    return itemIndices;
+}
+
+QList<qsizetype> PackedRTree::levelBounds(qsizetype itemCount)
+{
+    // Every level holds the parents of the level below up to a single root
+    QList<qsizetype> bounds;
+    qsizetype levelCount = itemCount;
+    qsizetype nodeCount = levelCount;
+    bounds.append(nodeCount);
+    do
+    {
+        levelCount = (levelCount + NodeSize - 1) / NodeSize;
+        nodeCount += levelCount;
+        bounds.append(nodeCount);
+    } while (1 != levelCount);
+
+    return bounds;
+}
+
+qsizetype PackedRTree::upperBound(qsizetype nodeIndex) const
+{
+    return *std::upper_bound(m_levelBounds.cbegin(), m_levelBounds.cend(), nodeIndex);
+}
+
+qsizetype PackedRTree::firstChild(qsizetype nodeIndex) const
+{
+    // The children of the k-th node of a level start at the (k * NodeSize)-th node of the level below
+    const qsizetype level = std::upper_bound(m_levelBounds.cbegin(), m_levelBounds.cend(), nodeIndex) - m_levelBounds.cbegin();
+    const qsizetype levelBegin = m_levelBounds.at(level - 1);
+    const qsizetype childLevelBegin = 1 < level ? m_levelBounds.at(level - 2) : 0;
+    return childLevelBegin + (nodeIndex - levelBegin) * NodeSize;
+}
+
+quint32 PackedRTree::hilbert(quint32 x, quint32 y)
+{
+    // Fast Hilbert curve index of a 16 bit grid cell
+    quint32 a = x ^ y;
+    quint32 b = 0xFFFF ^ a;
+    quint32 c = 0xFFFF ^ (x | y);
+    quint32 d = x & (y ^ 0xFFFF);
+
+    quint32 A = a | (b >> 1);
+    quint32 B = (a >> 1) ^ a;
+    quint32 C = ((c >> 1) ^ (b & (d >> 1))) ^ c;
+    quint32 D = ((a & (c >> 1)) ^ (d >> 1)) ^ d;
+
+    a = A; b = B; c = C; d = D;
+    A = ((a & (a >> 2)) ^ (b & (b >> 2)));
+    B = ((a & (b >> 2)) ^ (b & ((a ^ b) >> 2)));
+    C ^= ((a & (c >> 2)) ^ (b & (d >> 2)));
+    D ^= ((b & (c >> 2)) ^ ((a ^ b) & (d >> 2)));
+
+    a = A; b = B; c = C; d = D;
+    A = ((a & (a >> 4)) ^ (b & (b >> 4)));
+    B = ((a & (b >> 4)) ^ (b & ((a ^ b) >> 4)));
+    C ^= ((a & (c >> 4)) ^ (b & (d >> 4)));
+    D ^= ((b & (c >> 4)) ^ ((a ^ b) & (d >> 4)));
+
+    a = A; b = B; c = C; d = D;
+    C ^= ((a & (c >> 8)) ^ (b & (d >> 8)));
+    D ^= ((b & (c >> 8)) ^ ((a ^ b) & (d >> 8)));
+
+    a = C ^ (C >> 1);
+    b = D ^ (D >> 1);
+
+    quint32 i0 = x ^ y;
+    quint32 i1 = b | (0xFFFF ^ (i0 | a));
+
+    i0 = (i0 | (i0 << 8)) & 0x00FF00FF;
+    i0 = (i0 | (i0 << 4)) & 0x0F0F0F0F;
+    i0 = (i0 | (i0 << 2)) & 0x33333333;
+    i0 = (i0 | (i0 << 1)) & 0x55555555;
+
+    i1 = (i1 | (i1 << 8)) & 0x00FF00FF;
+    i1 = (i1 | (i1 << 4)) & 0x0F0F0F0F;
+    i1 = (i1 | (i1 << 2)) & 0x33333333;
+    i1 = (i1 | (i1 << 1)) & 0x55555555;
+
+    return (i1 << 1) | i0;
+}
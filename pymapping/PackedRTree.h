@@ -0,0 +1,161 @@
+// geoint-mapping offers core mapping and Geospatial Intelligence capabilities for Python.
+// Copyright (C) 2024 Jan Tschada (gisfromscratch@live.de)
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// Additional permission under GNU LGPL version 3 section 4 and 5
+// If you modify this Program, or any covered work, by linking or combining
+// it with ArcGIS Runtime for Qt (or a modified version of that library),
+// containing parts covered by the terms of ArcGIS Runtime for Qt,
+// the licensors of this Program grant you additional permission to convey the resulting work.
+// See <https://developers.arcgis.com/qt/> for further information.
+//
+
+#ifndef PACKEDRTREE_H
+#define PACKEDRTREE_H
+
+#include <QList>
+
+#include <limits>
+
+/*!
+ * \brief Static R-tree packed along the Hilbert curve.
+ *
+ * All boxes are sorted by the Hilbert value of their centers and grouped
+ * into nodes of NodeSize children, level by level up to the root. The nodes
+ * are stored in flat arrays, so building is a sort and searching touches
+ * only the nodes intersecting the search box. Items are reported by their
+ * index in the list the tree was built from.
+ *
+ * Children of a node are found by position, so the node boxes alone
+ * describe a tree whose items are stored in tree order. Such trees can be
+ * used directly on memory owned elsewhere, e.g. a mapped file.
+ */
+class PackedRTree
+{
+public:
+    struct Box
+    {
+        double minX = std::numeric_limits<double>::infinity();
+        double minY = std::numeric_limits<double>::infinity();
+        double maxX = -std::numeric_limits<double>::infinity();
+        double maxY = -std::numeric_limits<double>::infinity();
+
+        bool isEmpty() const
+        {
+            return !(minX <= maxX && minY <= maxY);
+        }
+
+        bool intersects(const Box& other) const
+        {
+            return minX <= other.maxX && other.minX <= maxX && minY <= other.maxY && other.minY <= maxY;
+        }
+
+        void expand(const Box& other)
+        {
+            minX = qMin(minX, other.minX);
+            minY = qMin(minY, other.minY);
+            maxX = qMax(maxX, other.maxX);
+            maxY = qMax(maxY, other.maxY);
+        }
+
+        double squaredDistance(double x, double y) const
+        {
+            const double dx = qMax(0.0, qMax(minX - x, x - maxX));
+            const double dy = qMax(0.0, qMax(minY - y, y - maxY));
+            return dx * dx + dy * dy;
+        }
+    };
+
+    static constexpr qsizetype NodeSize = 16;
+
+    PackedRTree() = default;
+    explicit PackedRTree(const QList<Box>& boxes, qsizetype count = -1);
+
+    // The nodes must outlive the tree, item i is the i-th leaf
+    static PackedRTree fromNodes(qsizetype itemCount, const Box* nodes, qsizetype nodeCount);
+    static qsizetype nodeCount(qsizetype itemCount);
+
+    qsizetype size() const;
+    bool isEmpty() const;
+    Box extent() const;
+
+    // Node boxes from the leaves up to the root and the item of every leaf
+    const Box* nodes() const;
+    qsizetype nodeCount() const;
+    qsizetype itemIndex(qsizetype leafIndex) const;
+
+    QList<qsizetype> search(const Box& box) const;
+
+    // Calls visitor(itemIndex) for every item intersecting the box until it returns false
+    template <typename Visitor>
+    void visit(const Box& box, Visitor visitor) const;
+
+private:
+    static quint32 hilbert(quint32 x, quint32 y);
+    static QList<qsizetype> levelBounds(qsizetype itemCount);
+    qsizetype upperBound(qsizetype nodeIndex) const;
+    qsizetype firstChild(qsizetype nodeIndex) const;
+
+    qsizetype m_itemCount = 0;
+    QList<Box> m_boxes;
+    const Box* m_externalNodes = nullptr;
+    QList<qsizetype> m_indices;
+    QList<qsizetype> m_levelBounds;
+};
+
+template <typename Visitor>
+void PackedRTree::visit(const Box& box, Visitor visitor) const
+{
+    if (0 == m_itemCount)
+    {
+        return;
+    }
+
+    // Every entry is the position of the first node of a group of siblings
+    const Box* treeNodes = nodes();
+    QList<qsizetype> queue;
+    qsizetype nodeIndex = nodeCount() - 1;
+    while (true)
+    {
+        const qsizetype end = qMin(nodeIndex + NodeSize, upperBound(nodeIndex));
+        for (qsizetype position = nodeIndex; position < end; position++)
+        {
+            if (!box.intersects(treeNodes[position]))
+            {
+                continue;
+            }
+
+            if (position < m_itemCount)
+            {
+                if (!visitor(itemIndex(position)))
+                {
+                    return;
+                }
+            }
+            else
+            {
+                queue.append(firstChild(position));
+            }
+        }
+
+        if (queue.isEmpty())
+        {
+            return;
+        }
+        nodeIndex = queue.takeLast();
+    }
+}
+
+#endif // PACKEDRTREE_H
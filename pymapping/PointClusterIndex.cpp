@@ -0,0 +1,232 @@
+// geoint-mapping offers core mapping and Geospatial Intelligence capabilities for Python.
+// Copyright (C) 2024 Jan Tschada (gisfromscratch@live.de)
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// Additional permission under GNU LGPL version 3 section 4 and 5
+// If you modify this Program, or any covered work, by linking or combining
+// it with ArcGIS Runtime for Qt (or a modified version of that library),
+// containing parts covered by the terms of ArcGIS Runtime for Qt,
+// the licensors of this Program grant you additional permission to convey the resulting work.
+// See <https://developers.arcgis.com/qt/> for further information.
+//
+
+#include "PointClusterIndex.h"
+
+#include <QtMath>
+
+#include <cmath>
+
+// Scale of the Web Mercator tiling scheme at zoom level 0
+static constexpr double ScaleAtZoomZero = 591657527.591555;
+
+static double longitudeToX(double longitude)
+{
+    return longitude / 360.0 + 0.5;
+}
+
+static double latitudeToY(double latitude)
+{
+    const double sine = qSin(qDegreesToRadians(latitude));
+    const double y = 0.5 - 0.25 * qLn((1.0 + sine) / (1.0 - sine)) / M_PI;
+    return qBound(0.0, y, 1.0);
+}
+
+static double xToLongitude(double x)
+{
+    return (x - 0.5) * 360.0;
+}
+
+static double yToLatitude(double y)
+{
+    const double y2 = qDegreesToRadians(180.0 - y * 360.0);
+    return 360.0 * qAtan(qExp(y2)) / M_PI - 90.0;
+}
+
+void PointClusterIndex::build(const QList<double>& longitudes, const QList<double>& latitudes, const QList<QList<double>>& fieldValues)
+{
+    clear();
+    m_fieldCount = fieldValues.size();
+
+    ZoomLevel points;
+    const qsizetype pointCount = qMin(longitudes.size(), latitudes.size());
+    points.x.reserve(pointCount);
+    points.y.reserve(pointCount);
+    points.counts.reserve(pointCount);
+    points.sums.reserve(pointCount * m_fieldCount);
+    for (qsizetype pointIndex = 0; pointIndex < pointCount; pointIndex++)
+    {
+        const double longitude = longitudes.at(pointIndex);
+        const double latitude = latitudes.at(pointIndex);
+        if (qIsNaN(longitude) || qIsNaN(latitude))
+        {
+            continue;
+        }
+
+        points.x.append(longitudeToX(longitude));
+        points.y.append(latitudeToY(latitude));
+        points.counts.append(1);
+        for (const QList<double>& values : fieldValues)
+        {
+            const double value = pointIndex < values.size() ? values.at(pointIndex) : qQNaN();
+            points.sums.append(qIsNaN(value) ? 0.0 : value);
+        }
+    }
+
+    // Every level clusters the level below it
+    m_zoomLevels.resize(MaximumZoom + 2);
+    buildTree(points);
+    m_zoomLevels[MaximumZoom + 1] = points;
+    for (int zoom = MaximumZoom; MinimumZoom <= zoom; zoom--)
+    {
+        ZoomLevel zoomLevel = clusterLevel(m_zoomLevels.at(zoom + 1), zoom);
+        buildTree(zoomLevel);
+        m_zoomLevels[zoom] = zoomLevel;
+    }
+}
+
+void PointClusterIndex::clear()
+{
+    m_zoomLevels.clear();
+    m_fieldCount = 0;
+}
+
+bool PointClusterIndex::isEmpty() const
+{
+    return m_zoomLevels.isEmpty() || 0 == m_zoomLevels.last().size();
+}
+
+qsizetype PointClusterIndex::fieldCount() const
+{
+    return m_fieldCount;
+}
+
+int PointClusterIndex::zoomForScale(double mapScale)
+{
+    if (mapScale <= 0.0)
+    {
+        return MaximumZoom + 1;
+    }
+
+    const int zoom = qFloor(std::log2(ScaleAtZoomZero / mapScale));
+    return qBound(MinimumZoom, zoom, MaximumZoom + 1);
+}
+
+QList<PointClusterIndex::Cluster> PointClusterIndex::clusters(double minLongitude, double minLatitude, double maxLongitude, double maxLatitude, int zoom) const
+{
+    QList<Cluster> clusters;
+    if (m_zoomLevels.isEmpty())
+    {
+        return clusters;
+    }
+
+    // The y axis of the unit square points southwards
+    const ZoomLevel& zoomLevel = m_zoomLevels.at(qBound(MinimumZoom, zoom, MaximumZoom + 1));
+    const PackedRTree::Box searchBox{ longitudeToX(qBound(-180.0, minLongitude, 180.0)), latitudeToY(maxLatitude),
+                                      longitudeToX(qBound(-180.0, maxLongitude, 180.0)), latitudeToY(minLatitude) };
+    zoomLevel.tree.visit(searchBox, [this, &zoomLevel, &clusters](qsizetype clusterIndex)
+    {
+        Cluster cluster;
+        cluster.longitude = xToLongitude(zoomLevel.x.at(clusterIndex));
+        cluster.latitude = yToLatitude(zoomLevel.y.at(clusterIndex));
+        cluster.count = zoomLevel.counts.at(clusterIndex);
+        cluster.sums = zoomLevel.sums.mid(clusterIndex * m_fieldCount, m_fieldCount);
+        clusters.append(cluster);
+        return true;
+    });
+
+    return clusters;
+}
+
+void PointClusterIndex::buildTree(ZoomLevel& zoomLevel)
+{
+    QList<PackedRTree::Box> boxes;
+    boxes.reserve(zoomLevel.size());
+    for (qsizetype index = 0; index < zoomLevel.size(); index++)
+    {
+        const double x = zoomLevel.x.at(index);
+        const double y = zoomLevel.y.at(index);
+        boxes.append(PackedRTree::Box{ x, y, x, y });
+    }
+
+    zoomLevel.tree = PackedRTree(boxes);
+}
+
+PointClusterIndex::ZoomLevel PointClusterIndex::clusterLevel(const ZoomLevel& previousLevel, int zoom) const
+{
+    // The radius in pixels expressed in units of the unit square
+    const double radius = Radius / (TileExtent * qPow(2.0, zoom));
+    const double squaredRadius = radius * radius;
+
+    // Walking the points in the Hilbert order of the tree keeps neighbors close in memory
+    QList<qsizetype> order;
+    order.reserve(previousLevel.size());
+    previousLevel.tree.visit(previousLevel.tree.extent(), [&order](qsizetype index)
+    {
+        order.append(index);
+        return true;
+    });
+
+    ZoomLevel zoomLevel;
+    QList<bool> visited(previousLevel.size(), false);
+    QList<double> sums(m_fieldCount);
+    for (const qsizetype index : order)
+    {
+        if (visited.at(index))
+        {
+            continue;
+        }
+        visited[index] = true;
+
+        // The cluster center is weighted by the number of points
+        const double x = previousLevel.x.at(index);
+        const double y = previousLevel.y.at(index);
+        qsizetype count = previousLevel.counts.at(index);
+        double weightedX = x * count;
+        double weightedY = y * count;
+        for (qsizetype fieldIndex = 0; fieldIndex < m_fieldCount; fieldIndex++)
+        {
+            sums[fieldIndex] = previousLevel.sums.at(index * m_fieldCount + fieldIndex);
+        }
+
+        const PackedRTree::Box searchBox{ x - radius, y - radius, x + radius, y + radius };
+        previousLevel.tree.visit(searchBox, [&](qsizetype neighbor)
+        {
+            const double dx = previousLevel.x.at(neighbor) - x;
+            const double dy = previousLevel.y.at(neighbor) - y;
+            if (visited.at(neighbor) || squaredRadius < dx * dx + dy * dy)
+            {
+                return true;
+            }
+
+            visited[neighbor] = true;
+            const qsizetype neighborCount = previousLevel.counts.at(neighbor);
+            weightedX += previousLevel.x.at(neighbor) * neighborCount;
+            weightedY += previousLevel.y.at(neighbor) * neighborCount;
+            count += neighborCount;
+            for (qsizetype fieldIndex = 0; fieldIndex < m_fieldCount; fieldIndex++)
+            {
+                sums[fieldIndex] += previousLevel.sums.at(neighbor * m_fieldCount + fieldIndex);
+            }
+            return true;
+        });
+
+        zoomLevel.x.append(weightedX / count);
+        zoomLevel.y.append(weightedY / count);
+        zoomLevel.counts.append(count);
+        zoomLevel.sums.append(sums);
+    }
+
+    return zoomLevel;
+}
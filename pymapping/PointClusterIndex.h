@@ -0,0 +1,92 @@
+// geoint-mapping offers core mapping and Geospatial Intelligence capabilities for Python.
+// Copyright (C) 2024 Jan Tschada (gisfromscratch@live.de)
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// Additional permission under GNU LGPL version 3 section 4 and 5
+// If you modify this Program, or any covered work, by linking or combining
+// it with ArcGIS Runtime for Qt (or a modified version of that library),
+// containing parts covered by the terms of ArcGIS Runtime for Qt,
+// the licensors of this Program grant you additional permission to convey the resulting work.
+// See <https://developers.arcgis.com/qt/> for further information.
+//
+
+#ifndef POINTCLUSTERINDEX_H
+#define POINTCLUSTERINDEX_H
+
+#include "PackedRTree.h"
+
+#include <QList>
+
+/*!
+ * \brief Hierarchical clustering of points for every zoom level of the map.
+ *
+ * The points are projected onto the Web Mercator unit square. Starting at
+ * the deepest zoom level, all clusters within the pixel radius of a cluster
+ * are merged into it, and the merged clusters are the input of the next
+ * coarser level. Every level is spatially indexed, so only the clusters of
+ * the visible area need to be fetched. Clusters carry the number of points
+ * and the sums of numeric point values.
+ */
+class PointClusterIndex
+{
+public:
+    struct Cluster
+    {
+        double longitude = 0.0;
+        double latitude = 0.0;
+        qsizetype count = 0;
+        QList<double> sums;
+    };
+
+    static constexpr int MinimumZoom = 0;
+    static constexpr int MaximumZoom = 16;
+    static constexpr double Radius = 60.0;
+    static constexpr double TileExtent = 512.0;
+
+    // Missing values are NaN and do not contribute to the sums
+    void build(const QList<double>& longitudes, const QList<double>& latitudes, const QList<QList<double>>& fieldValues);
+    void clear();
+
+    bool isEmpty() const;
+    qsizetype fieldCount() const;
+
+    static int zoomForScale(double mapScale);
+
+    QList<Cluster> clusters(double minLongitude, double minLatitude, double maxLongitude, double maxLatitude, int zoom) const;
+
+private:
+    struct ZoomLevel
+    {
+        QList<double> x;
+        QList<double> y;
+        QList<qsizetype> counts;
+        QList<double> sums;
+        PackedRTree tree;
+
+        qsizetype size() const
+        {
+            return counts.size();
+        }
+    };
+
+    void buildTree(ZoomLevel& zoomLevel);
+    ZoomLevel clusterLevel(const ZoomLevel& previousLevel, int zoom) const;
+
+    // Levels for MinimumZoom to MaximumZoom followed by the points themselves
+    QList<ZoomLevel> m_zoomLevels;
+    qsizetype m_fieldCount = 0;
+};
+
+#endif // POINTCLUSTERINDEX_H
@@ -0,0 +1,131 @@
+// geoint-mapping offers core mapping and Geospatial Intelligence capabilities for Python.
+// Copyright (C) 2024 Jan Tschada (gisfromscratch@live.de)
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// Additional permission under GNU LGPL version 3 section 4 and 5
+// If you modify this Program, or any covered work, by linking or combining
+// it with ArcGIS Runtime for Qt (or a modified version of that library),
+// containing parts covered by the terms of ArcGIS Runtime for Qt,
+// the licensors of this Program grant you additional permission to convey the resulting work.
+// See <https://developers.arcgis.com/qt/> for further information.
+//
+
+#include "RendererCache.h"
+
+#include <Renderer.h>
+#include <SimpleFillSymbol.h>
+#include <SimpleLineSymbol.h>
+#include <SimpleMarkerSymbol.h>
+#include <SimpleRenderer.h>
+#include <SymbolTypes.h>
+
+#include <QColor>
+#include <QJsonDocument>
+
+using namespace Esri::ArcGISRuntime;
+
+RendererCache::RendererCache(QObject *parent) :
+    QObject(parent)
+{
+}
+
+Renderer* RendererCache::renderer(const QString& rendererJson)
+{
+    const QByteArray key = contentKey(rendererJson);
+    auto cachedRenderer = m_renderers.constFind(key);
+    if (m_renderers.constEnd() != cachedRenderer)
+    {
+        return cachedRenderer.value();
+    }
+
+    Renderer* renderer = Renderer::fromJson(rendererJson, this);
+    if (nullptr != renderer)
+    {
+        m_renderers.insert(key, renderer);
+    }
+
+    return renderer;
+}
+
+Renderer* RendererCache::pointRenderer()
+{
+    if (nullptr == m_pointRenderer)
+    {
+        SimpleRenderer* markerRenderer = new SimpleRenderer(this);
+        SimpleMarkerSymbol* markerSymbol = new SimpleMarkerSymbol(SimpleMarkerSymbolStyle::Circle, QColor("#d3c2a6"), 12, markerRenderer);
+        markerSymbol->setOutline(new SimpleLineSymbol(SimpleLineSymbolStyle::Solid, Qt::black, 4, markerRenderer));
+        markerRenderer->setSymbol(markerSymbol);
+        m_pointRenderer = markerRenderer;
+    }
+
+    return m_pointRenderer;
+}
+
+Renderer* RendererCache::lineRenderer()
+{
+    if (nullptr == m_lineRenderer)
+    {
+        SimpleRenderer* lineRenderer = new SimpleRenderer(this);
+        lineRenderer->setSymbol(new SimpleLineSymbol(SimpleLineSymbolStyle::Solid, Qt::black, 5, lineRenderer));
+        m_lineRenderer = lineRenderer;
+    }
+
+    return m_lineRenderer;
+}
+
+Renderer* RendererCache::fillRenderer()
+{
+    if (nullptr == m_fillRenderer)
+    {
+        SimpleRenderer* fillRenderer = new SimpleRenderer(this);
+        SimpleFillSymbol* fillSymbol = new SimpleFillSymbol(SimpleFillSymbolStyle::Solid, QColor("#d3c2a6"), fillRenderer);
+        fillSymbol->setOutline(new SimpleLineSymbol(SimpleLineSymbolStyle::Solid, Qt::black, 4, fillRenderer));
+        fillRenderer->setSymbol(fillSymbol);
+        m_fillRenderer = fillRenderer;
+    }
+
+    return m_fillRenderer;
+}
+
+Renderer* RendererCache::clusterRenderer()
+{
+    // Clusters are sized by their number of points
+    return renderer(R"({
+        "type": "simple",
+        "symbol": { "type": "esriSMS", "style": "esriSMSCircle", "color": [211, 194, 166, 220], "size": 16,
+                    "outline": { "type": "esriSLS", "style": "esriSLSSolid", "color": [0, 0, 0, 255], "width": 1.5 } },
+        "visualVariables": [ { "type": "sizeInfo", "field": "point_count", "valueUnit": "unknown",
+                               "minDataValue": 1, "maxDataValue": 10000, "minSize": 12, "maxSize": 48 } ]
+    })");
+}
+
+qsizetype RendererCache::size() const
+{
+    return m_renderers.size();
+}
+
+QByteArray RendererCache::contentKey(const QString& rendererJson)
+{
+    // Objects are written with sorted keys and without whitespace, so equal
+    // definitions share a key regardless of their formatting
+    const QByteArray json = rendererJson.toUtf8();
+    const QJsonDocument rendererDocument = QJsonDocument::fromJson(json);
+    if (rendererDocument.isObject())
+    {
+        return rendererDocument.toJson(QJsonDocument::Compact);
+    }
+
+    return json;
+}
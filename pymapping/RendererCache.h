@@ -0,0 +1,72 @@
+// geoint-mapping offers core mapping and Geospatial Intelligence capabilities for Python.
+// Copyright (C) 2024 Jan Tschada (gisfromscratch@live.de)
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// Additional permission under GNU LGPL version 3 section 4 and 5
+// If you modify this Program, or any covered work, by linking or combining
+// it with ArcGIS Runtime for Qt (or a modified version of that library),
+// containing parts covered by the terms of ArcGIS Runtime for Qt,
+// the licensors of this Program grant you additional permission to convey the resulting work.
+// See <https://developers.arcgis.com/qt/> for further information.
+//
+
+#ifndef RENDERERCACHE_H
+#define RENDERERCACHE_H
+
+namespace Esri
+{
+namespace ArcGISRuntime
+{
+class Renderer;
+}
+}
+
+#include <QByteArray>
+#include <QHash>
+#include <QObject>
+
+/*!
+ * \brief Renderers shared by all overlays of a map view.
+ *
+ * Renderers are keyed by the content of their JSON definition, so loading
+ * many layers having the same styling creates one renderer. The cache owns
+ * every renderer it returns, the overlays must not outlive the cache.
+ */
+class RendererCache : public QObject
+{
+    Q_OBJECT
+public:
+    explicit RendererCache(QObject *parent = nullptr);
+
+    Esri::ArcGISRuntime::Renderer* renderer(const QString& rendererJson);
+
+    // Default styling of GeoJSON layers
+    Esri::ArcGISRuntime::Renderer* pointRenderer();
+    Esri::ArcGISRuntime::Renderer* lineRenderer();
+    Esri::ArcGISRuntime::Renderer* fillRenderer();
+    Esri::ArcGISRuntime::Renderer* clusterRenderer();
+
+    qsizetype size() const;
+
+private:
+    static QByteArray contentKey(const QString& rendererJson);
+
+    QHash<QByteArray, Esri::ArcGISRuntime::Renderer*> m_renderers;
+    Esri::ArcGISRuntime::Renderer* m_pointRenderer = nullptr;
+    Esri::ArcGISRuntime::Renderer* m_lineRenderer = nullptr;
+    Esri::ArcGISRuntime::Renderer* m_fillRenderer = nullptr;
+};
+
+#endif // RENDERERCACHE_H
@@ -23,46 +23,84 @@
 //
 #include "SimpleGeoJsonLayer.h"
 
+#include "FeatureBinaryReader.h"
+#include "GeoJsonFeatureReader.h"
+#include "GeoJsonLoadJob.h"
+#include "GeometryPyramid.h"
 #include "GraphicsFactory.h"
+#include "GraphicsOverlayIndex.h"
+#include "JsonStreamReader.h"
+#include "LoadMetrics.h"
+#include "MappedFile.h"
+#include "RendererCache.h"
 
+#include <GeometryEngine.h>
+#include <Graphic.h>
 #include <GraphicsOverlay.h>
-#include <SimpleFillSymbol.h>
-#include <SimpleLineSymbol.h>
-#include <SimpleMarkerSymbol.h>
-#include <SimpleRenderer.h>
-#include <SymbolTypes.h>
+#include <LabelDefinition.h>
+#include <LabelDefinitionListModel.h>
+#include <Point.h>
+#include <Renderer.h>
+#include <SpatialReference.h>
 
-#include <QJsonArray>
-#include <QJsonDocument>
-#include <QJsonObject>
+#include <QHash>
+#include <QSet>
+#include <QTimer>
+#include <QtConcurrent>
+
+#include <algorithm>
+#include <numeric>
 
 using namespace Esri::ArcGISRuntime;
 
 SimpleGeoJsonLayer::SimpleGeoJsonLayer(QObject *parent) :
+    SimpleGeoJsonLayer(nullptr, parent)
+{
+}
+
+SimpleGeoJsonLayer::SimpleGeoJsonLayer(RendererCache* rendererCache, QObject *parent) :
     QObject(parent),
     m_pointsOverlay(new GraphicsOverlay(this)),
     m_linesOverlay(new GraphicsOverlay(this)),
     m_areasOverlay(new GraphicsOverlay(this)),
-    m_graphicsFactor(new GraphicsFactory(this))
+    m_clustersOverlay(new GraphicsOverlay(this)),
+    m_graphicsFactor(new GraphicsFactory(this)),
+    m_viewportTimer(new QTimer(this))
 {
-    SimpleRenderer* fillRenderer = new SimpleRenderer(this);
-    SimpleFillSymbol* fillSymbol = new SimpleFillSymbol(SimpleFillSymbolStyle::Solid, QColor("#d3c2a6"), this);
-    fillSymbol->setOutline(new SimpleLineSymbol(SimpleLineSymbolStyle::Solid, Qt::black, 4, this));
-    fillRenderer->setSymbol(fillSymbol);
-    m_areasOverlay->setRenderer(fillRenderer);
-    m_areasOverlay->setOpacity(0.35f);
+    // Viewpoint changes while panning are coalesced
+    m_viewportTimer->setSingleShot(true);
+    m_viewportTimer->setInterval(100);
+    connect(m_viewportTimer, &QTimer::timeout, this, &SimpleGeoJsonLayer::onViewportChanged);
+
+    // Layers without a shared cache own their renderers
+    if (nullptr == rendererCache)
+    {
+        rendererCache = new RendererCache(this);
+    }
 
-    SimpleRenderer* lineRenderer = new SimpleRenderer(this);
-    SimpleLineSymbol* lineSymbol = new SimpleLineSymbol(SimpleLineSymbolStyle::Solid, Qt::black, 5, this);
-    lineRenderer->setSymbol(lineSymbol);
-    m_linesOverlay->setRenderer(lineRenderer);
+    m_areasOverlay->setRenderer(rendererCache->fillRenderer());
+    m_areasOverlay->setOpacity(0.35f);
+    m_linesOverlay->setRenderer(rendererCache->lineRenderer());
     m_linesOverlay->setOpacity(0.35f);
+    m_pointsOverlay->setRenderer(rendererCache->pointRenderer());
+
+    // Clusters are sized and labeled by their number of points
+    m_clustersOverlay->setRenderer(rendererCache->clusterRenderer());
+    const QString clusterLabel = R"({
+        "labelExpressionInfo": { "expression": "$feature.point_count" },
+        "labelPlacement": "esriServerPointLabelPlacementCenterCenter",
+        "where": "point_count > 1",
+        "symbol": { "type": "esriTS", "color": [0, 0, 0, 255], "font": { "size": 10, "weight": "bold" } }
+    })";
+    m_clustersOverlay->labelDefinitions()->append(LabelDefinition::fromJson(clusterLabel, this));
+    m_clustersOverlay->setLabelsEnabled(true);
+    m_clustersOverlay->setVisible(false);
 
-    SimpleRenderer* markerRenderer = new SimpleRenderer(this);
-    SimpleMarkerSymbol* markerSymbol = new SimpleMarkerSymbol(SimpleMarkerSymbolStyle::Circle, QColor("#d3c2a6"), 12, this);
-    markerSymbol->setOutline(new SimpleLineSymbol(SimpleLineSymbolStyle::Solid, Qt::black, 4, this));
-    markerRenderer->setSymbol(markerSymbol);
-    m_pointsOverlay->setRenderer(markerRenderer);
+    // Keep the graphics of every overlay spatially indexed
+    GraphicsOverlayIndex::attach(m_pointsOverlay);
+    GraphicsOverlayIndex::attach(m_linesOverlay);
+    GraphicsOverlayIndex::attach(m_areasOverlay);
+    GraphicsOverlayIndex::attach(m_clustersOverlay);
 }
 
 GraphicsOverlay* SimpleGeoJsonLayer::pointsOverlay() const
@@ -80,23 +118,719 @@ GraphicsOverlay* SimpleGeoJsonLayer::areasOverlay() const
     return m_areasOverlay;
 }
 
-void SimpleGeoJsonLayer::load(const QJsonDocument &geoJsonDocument)
+GraphicsOverlay* SimpleGeoJsonLayer::clustersOverlay() const
+{
+    return m_clustersOverlay;
+}
+
+SimpleGeoJsonLayer::~SimpleGeoJsonLayer()
+{
+    // The decoding reads the feature store
+    m_decodeFuture.waitForFinished();
+}
+
+QList<GraphicsOverlay*> SimpleGeoJsonLayer::takeOverlays()
 {
-    if (geoJsonDocument.isNull())
+    // Pending batches and viewport updates must not touch the overlays anymore
+    m_viewportTimer->stop();
+    m_viewportFeatures.clear();
+    m_viewportPending = false;
+    const QList<GeoJsonLoadJob*> loadJobs = findChildren<GeoJsonLoadJob*>(QString(), Qt::FindDirectChildrenOnly);
+    for (GeoJsonLoadJob* loadJob : loadJobs)
     {
-        qDebug() << "JSON is invalid!";
-        return;
+        loadJob->cancel();
     }
-    if (!geoJsonDocument.isObject())
+
+    return { m_pointsOverlay, m_linesOverlay, m_areasOverlay, m_clustersOverlay };
+}
+
+void SimpleGeoJsonLayer::load(const QByteArray& geoJson)
+{
+    JsonStreamReader reader(geoJson);
+    load(reader);
+}
+
+void SimpleGeoJsonLayer::load(QIODevice* geoJsonDevice)
+{
+    JsonStreamReader reader(geoJsonDevice);
+    load(reader);
+}
+
+GeoJsonLoadJob* SimpleGeoJsonLayer::loadAsync(const QByteArray& geoJson)
+{
+    GeoJsonLoadJob* loadJob = new GeoJsonLoadJob(geoJson, this);
+    loadJob->start();
+    return loadJob;
+}
+
+bool SimpleGeoJsonLayer::loadFile(const QString& filePath)
+{
+    MappedFile geoJsonFile;
+    if (!geoJsonFile.open(filePath))
+    {
+        qWarning() << "GeoJSON file cannot be opened!" << geoJsonFile.errorString();
+        return false;
+    }
+
+    JsonStreamReader reader(geoJsonFile.data());
+    return load(reader);
+}
+
+GeoJsonLoadJob* SimpleGeoJsonLayer::loadFileAsync(const QString& filePath)
+{
+    // The job keeps the file mapped until it is destroyed
+    GeoJsonLoadJob* loadJob = new GeoJsonLoadJob(filePath, this);
+    loadJob->start();
+    return loadJob;
+}
+
+bool SimpleGeoJsonLayer::loadLazyFile(const QString& filePath)
+{
+    // The store copies the coordinates, so the mapping ends with the load
+    MappedFile geoJsonFile;
+    if (!geoJsonFile.open(filePath))
+    {
+        qWarning() << "GeoJSON file cannot be opened!" << geoJsonFile.errorString();
+        return false;
+    }
+
+    JsonStreamReader reader(geoJsonFile.data());
+    return loadLazy(reader);
+}
+
+bool SimpleGeoJsonLayer::loadBinary(const QString& filePath, const Envelope& extent)
+{
+    FeatureBinaryReader featureReader;
+    if (!featureReader.open(filePath))
+    {
+        qWarning() << "Binary features are invalid!" << featureReader.errorString();
+        return false;
+    }
+
+    // Only the records within the extent are read from the mapped file
+    QList<qsizetype> featureIndices;
+    if (extent.isEmpty())
+    {
+        featureIndices.resize(featureReader.size());
+        std::iota(featureIndices.begin(), featureIndices.end(), 0);
+    }
+    else
+    {
+        const Envelope wgs84Extent = GeometryEngine::project(extent, SpatialReference::wgs84()).extent();
+        if (wgs84Extent.isEmpty())
+        {
+            return false;
+        }
+
+        featureIndices = featureReader.search(PackedRTree::Box{ wgs84Extent.xMin(), wgs84Extent.yMin(), wgs84Extent.xMax(), wgs84Extent.yMax() });
+    }
+
+    return m_graphicsFactor->createGraphics(featureReader, featureIndices, m_pointsOverlay, m_linesOverlay, m_areasOverlay);
+}
+
+void SimpleGeoJsonLayer::loadLazy(const QByteArray& geoJson)
+{
+    JsonStreamReader reader(geoJson);
+    loadLazy(reader);
+}
+
+void SimpleGeoJsonLayer::loadLazy(QIODevice* geoJsonDevice)
+{
+    JsonStreamReader reader(geoJsonDevice);
+    loadLazy(reader);
+}
+
+bool SimpleGeoJsonLayer::isLazy() const
+{
+    return m_lazy;
+}
+
+bool SimpleGeoJsonLayer::enableClustering()
+{
+    // The points are read from the store, so only lazy layers can be clustered.
+    // Every point of a multipoint is clustered, its values are summed once.
+    if (!m_lazy)
+    {
+        qWarning() << "Only lazily loaded GeoJSON can be clustered!";
+        return false;
+    }
+
+    QList<double> longitudes;
+    QList<double> latitudes;
+    QList<QList<double>> fieldValues;
+    QHash<QString, qsizetype> fieldIndices;
+    QSet<QString> nonNumericFields;
+    m_clusterFields.clear();
+
+    GeoJsonFeature feature;
+    for (qsizetype featureIndex = 0; featureIndex < m_featureStore.size(); featureIndex++)
+    {
+        const GeoJsonGeometryType geometryType = m_featureStore.geometryType(featureIndex);
+        if (GeoJsonGeometryType::Point != geometryType && GeoJsonGeometryType::MultiPoint != geometryType)
+        {
+            continue;
+        }
+
+        m_featureStore.feature(featureIndex, feature);
+        const qsizetype pointCount = feature.geometry.pointCount();
+        if (pointCount < 1)
+        {
+            continue;
+        }
+
+        const qsizetype pointIndex = longitudes.size();
+        for (qsizetype vertexIndex = 0; vertexIndex < pointCount; vertexIndex++)
+        {
+            const double* vertex = feature.geometry.vertex(vertexIndex);
+            longitudes.append(vertex[0]);
+            latitudes.append(vertex[1]);
+        }
+        for (QList<double>& values : fieldValues)
+        {
+            values.resize(longitudes.size(), qQNaN());
+        }
+
+        // Only properties having numbers or nulls are aggregated
+        for (auto property = feature.properties.cbegin(); property != feature.properties.cend(); property++)
+        {
+            const QVariant& value = property.value();
+            if (value.isNull() || nonNumericFields.contains(property.key()))
+            {
+                continue;
+            }
+
+            bool isNumber = false;
+            const double number = value.toDouble(&isNumber);
+            const QMetaType::Type valueType = static_cast<QMetaType::Type>(value.typeId());
+            if (!isNumber || QMetaType::QString == valueType || QMetaType::Bool == valueType)
+            {
+                nonNumericFields.insert(property.key());
+                continue;
+            }
+
+            auto fieldIndex = fieldIndices.constFind(property.key());
+            if (fieldIndex == fieldIndices.cend())
+            {
+                fieldIndex = fieldIndices.insert(property.key(), fieldValues.size());
+                m_clusterFields.append(property.key());
+                fieldValues.append(QList<double>(longitudes.size(), qQNaN()));
+            }
+            fieldValues[fieldIndex.value()][pointIndex] = number;
+        }
+    }
+
+    // Fields having mixed values are dropped
+    for (qsizetype fieldIndex = m_clusterFields.size() - 1; 0 <= fieldIndex; fieldIndex--)
+    {
+        if (nonNumericFields.contains(m_clusterFields.at(fieldIndex)))
+        {
+            m_clusterFields.removeAt(fieldIndex);
+            fieldValues.removeAt(fieldIndex);
+        }
+    }
+
+    m_clusterIndex.build(longitudes, latitudes, fieldValues);
+    m_clustering = !m_clusterIndex.isEmpty();
+    return m_clustering;
+}
+
+bool SimpleGeoJsonLayer::isClustering() const
+{
+    return m_clustering;
+}
+
+bool SimpleGeoJsonLayer::followsViewport() const
+{
+    return m_lazy || m_clustering || m_graphicsFactor->hasLevelsOfDetail();
+}
+
+void SimpleGeoJsonLayer::updateScale(double mapScale)
+{
+    m_mapScale = mapScale;
+
+    // Lines and areas are drawn with the vertices visible at this scale,
+    // the graphics in view are swapped when the viewport is updated
+    if (0.0 < mapScale)
+    {
+        m_graphicsFactor->setLevelOfDetail(GeometryPyramid::levelForScale(mapScale));
+    }
+}
+
+void SimpleGeoJsonLayer::updateViewport(const Envelope& visibleArea)
+{
+    if (!followsViewport())
     {
-        qDebug() << "JSON document is not an object!";
         return;
     }
 
-    QJsonObject geoJsonObject = geoJsonDocument.object();
-    QJsonArray geoJsonFeaturesArray = geoJsonObject["features"].toArray();
-    if (!m_graphicsFactor->createGraphics(geoJsonFeaturesArray, m_pointsOverlay, m_linesOverlay, m_areasOverlay))
+    m_visibleArea = visibleArea;
+    m_viewportTimer->start();
+}
+
+bool SimpleGeoJsonLayer::appendGeometries(const QList<GeoJsonFeatureGeometries>& batchGeometries)
+{
+    return m_graphicsFactor->createGraphics(batchGeometries, m_pointsOverlay, m_linesOverlay, m_areasOverlay);
+}
+
+GeoJsonUpsertStatistics SimpleGeoJsonLayer::upsert(const QByteArray& geoJson, const QString& idProperty, bool removeMissing)
+{
+    GeoJsonUpsertStatistics statistics;
+    if (m_lazy)
+    {
+        qWarning() << "Lazily loaded GeoJSON cannot be updated!";
+        return statistics;
+    }
+
+    JsonStreamReader reader(geoJson);
+    GeoJsonFeatureReader featureReader(reader);
+    QList<GeoJsonFeature> features;
+    GeoJsonFeature feature;
+    {
+        ScopedLoadStage parseStage("parse");
+        while (featureReader.readNextFeature(feature))
+        {
+            features.append(feature);
+        }
+    }
+    LoadMetrics::count(LoadCounter::FeaturesParsed, features.size());
+    LoadMetrics::count(LoadCounter::BytesProcessed, reader.bytesConsumed());
+    if (featureReader.hasError())
+    {
+        qDebug() << "JSON is invalid!" << featureReader.errorString();
+        return statistics;
+    }
+
+    QList<GeoJsonFeatureGeometries> featureGeometries;
+    {
+        ScopedLoadStage geometryWaitStage("geometryWait");
+        featureGeometries = QtConcurrent::blockingMapped(features, &GraphicsFactory::createGeometries);
+    }
+    QHash<GraphicsOverlay*, QList<Graphic*>> removedGraphics;
+    QHash<GraphicsOverlay*, QList<Graphic*>> addedGraphics;
+    QSet<GraphicsOverlay*> movedOverlays;
+    QSet<QString> upsertedIds;
+    upsertedIds.reserve(featureGeometries.size());
+    for (auto geometriesIterator = featureGeometries.crbegin(); geometriesIterator != featureGeometries.crend(); geometriesIterator++)
+    {
+        // The last feature having the same id wins
+        const GeoJsonFeatureGeometries& geometries = *geometriesIterator;
+        const QString featureId = geometries.properties.value(idProperty).toString();
+        GraphicsOverlay* featureOverlay = overlay(geometries.type);
+        if (featureId.isEmpty() || nullptr == featureOverlay || upsertedIds.contains(featureId))
+        {
+            statistics.skipped++;
+            continue;
+        }
+
+        upsertedIds.insert(featureId);
+        auto keyedFeature = m_keyedFeatures.find(featureId);
+        if (keyedFeature == m_keyedFeatures.end())
+        {
+            KeyedFeature& addedFeature = m_keyedFeatures[featureId];
+            addedFeature.overlay = featureOverlay;
+            addedFeature.graphics = m_graphicsFactor->createFeatureGraphics(geometries);
+            addedGraphics[featureOverlay].append(addedFeature.graphics);
+            statistics.inserted++;
+            continue;
+        }
+
+        // Existing graphics are changed in place whenever possible
+        if (keyedFeature->overlay == featureOverlay && m_graphicsFactor->updateFeatureGraphics(keyedFeature->graphics, geometries))
+        {
+            movedOverlays.insert(featureOverlay);
+            statistics.updated++;
+            continue;
+        }
+
+        removedGraphics[keyedFeature->overlay].append(keyedFeature->graphics);
+        keyedFeature->overlay = featureOverlay;
+        keyedFeature->graphics = m_graphicsFactor->createFeatureGraphics(geometries);
+        addedGraphics[featureOverlay].append(keyedFeature->graphics);
+        statistics.replaced++;
+    }
+
+    if (removeMissing)
+    {
+        for (auto keyedFeature = m_keyedFeatures.begin(); keyedFeature != m_keyedFeatures.end();)
+        {
+            if (upsertedIds.contains(keyedFeature.key()))
+            {
+                keyedFeature++;
+                continue;
+            }
+
+            removedGraphics[keyedFeature->overlay].append(keyedFeature->graphics);
+            keyedFeature = m_keyedFeatures.erase(keyedFeature);
+            statistics.removed++;
+        }
+    }
+
+    // The graphics must leave their overlay before being released
+    for (auto removed = removedGraphics.cbegin(); removed != removedGraphics.cend(); removed++)
+    {
+        GraphicsFactory::removeGraphics(removed.key(), removed.value());
+        m_graphicsFactor->releaseGraphics(removed.value());
+    }
+    for (auto added = addedGraphics.cbegin(); added != addedGraphics.cend(); added++)
+    {
+        GraphicsFactory::appendGraphics(added.key(), added.value());
+    }
+    for (GraphicsOverlay* movedOverlay : movedOverlays)
+    {
+        if (GraphicsOverlayIndex* overlayIndex = GraphicsOverlayIndex::find(movedOverlay))
+        {
+            overlayIndex->invalidate();
+        }
+    }
+
+    return statistics;
+}
+
+bool SimpleGeoJsonLayer::load(JsonStreamReader& reader)
+{
+    // Only a bounded number of features is kept in memory
+    GeoJsonFeatureReader featureReader(reader);
+    bool added = m_graphicsFactor->createGraphics(featureReader, m_pointsOverlay, m_linesOverlay, m_areasOverlay);
+    LoadMetrics::count(LoadCounter::BytesProcessed, reader.bytesConsumed());
+
+    if (featureReader.hasError())
+    {
+        qDebug() << "JSON is invalid!" << featureReader.errorString();
+        return false;
+    }
+    if (!added)
     {
         qDebug() << "No GeoJSON feature was added!";
     }
+    return true;
+}
+
+bool SimpleGeoJsonLayer::loadLazy(JsonStreamReader& reader)
+{
+    // Features are only kept in the store until they become visible
+    m_lazy = true;
+    GeoJsonFeatureReader featureReader(reader);
+    GeoJsonFeature feature;
+    {
+        ScopedLoadStage parseStage("parse");
+        while (featureReader.readNextFeature(feature))
+        {
+            m_featureStore.append(feature);
+        }
+    }
+    LoadMetrics::count(LoadCounter::FeaturesParsed, m_featureStore.size());
+    LoadMetrics::count(LoadCounter::BytesProcessed, reader.bytesConsumed());
+    {
+        ScopedLoadStage indexStage("index");
+        m_featureStore.buildIndex();
+    }
+
+    if (featureReader.hasError())
+    {
+        qDebug() << "JSON is invalid!" << featureReader.errorString();
+        return false;
+    }
+    if (m_featureStore.isEmpty())
+    {
+        qDebug() << "No GeoJSON feature was stored!";
+    }
+    return true;
+}
+
+void SimpleGeoJsonLayer::onViewportChanged()
+{
+    const bool clustersShown = showClusters();
+    if (m_lazy)
+    {
+        materializeViewport(clustersShown);
+    }
+
+    if (m_graphicsFactor->hasLevelsOfDetail() && !m_visibleArea.isEmpty())
+    {
+        const double marginX = ViewportMargin * m_visibleArea.width();
+        const double marginY = ViewportMargin * m_visibleArea.height();
+        const Envelope levelExtent(m_visibleArea.xMin() - marginX, m_visibleArea.yMin() - marginY,
+                                   m_visibleArea.xMax() + marginX, m_visibleArea.yMax() + marginY, m_visibleArea.spatialReference());
+        m_graphicsFactor->applyLevelOfDetail(m_linesOverlay, levelExtent);
+        m_graphicsFactor->applyLevelOfDetail(m_areasOverlay, levelExtent);
+    }
+}
+
+bool SimpleGeoJsonLayer::showClusters()
+{
+    if (!m_clustering)
+    {
+        return false;
+    }
+
+    const Envelope visibleArea = GeometryEngine::project(m_visibleArea, SpatialReference::wgs84()).extent();
+    const int zoom = PointClusterIndex::zoomForScale(m_mapScale);
+    const bool clustersShown = !visibleArea.isEmpty() && zoom <= PointClusterIndex::MaximumZoom;
+    m_pointsOverlay->setVisible(!clustersShown);
+    m_clustersOverlay->setVisible(clustersShown);
+    if (!clustersShown)
+    {
+        // The hidden graphics are reused when clusters are shown again
+        m_clusterZoom = -1;
+        return false;
+    }
+
+    // Nothing changes while the zoom stays and the view is within the fetched area
+    if (zoom == m_clusterZoom
+            && m_clusterBox.minX <= visibleArea.xMin() && visibleArea.xMax() <= m_clusterBox.maxX
+            && m_clusterBox.minY <= visibleArea.yMin() && visibleArea.yMax() <= m_clusterBox.maxY)
+    {
+        return true;
+    }
+
+    const double marginX = ViewportMargin * visibleArea.width();
+    const double marginY = ViewportMargin * visibleArea.height();
+    const PackedRTree::Box clusterBox{ visibleArea.xMin() - marginX, visibleArea.yMin() - marginY,
+                                       visibleArea.xMax() + marginX, visibleArea.yMax() + marginY };
+    const QList<PointClusterIndex::Cluster> clusters = m_clusterIndex.clusters(clusterBox.minX, clusterBox.minY, clusterBox.maxX, clusterBox.maxY, zoom);
+    const auto clusterAttributes = [this](const PointClusterIndex::Cluster& cluster)
+    {
+        QVariantMap attributes;
+        attributes.insert("point_count", cluster.count);
+        for (qsizetype fieldIndex = 0; fieldIndex < m_clusterFields.size(); fieldIndex++)
+        {
+            attributes.insert(m_clusterFields.at(fieldIndex) + "_sum", cluster.sums.at(fieldIndex));
+        }
+        return attributes;
+    };
+
+    // Clusters staying at their position keep their graphic
+    QHash<QPair<double, double>, Graphic*> staleGraphics;
+    staleGraphics.swap(m_clusterGraphics);
+    m_clusterGraphics.reserve(clusters.size());
+    QList<const PointClusterIndex::Cluster*> enteredClusters;
+    for (const PointClusterIndex::Cluster& cluster : clusters)
+    {
+        const QPair<double, double> position(cluster.longitude, cluster.latitude);
+        Graphic* clusterGraphic = staleGraphics.take(position);
+        if (nullptr == clusterGraphic)
+        {
+            enteredClusters.append(&cluster);
+            continue;
+        }
+
+        if (zoom != m_clusterZoom)
+        {
+            GraphicsFactory::updateAttributes(clusterGraphic, clusterAttributes(cluster));
+        }
+        m_clusterGraphics.insert(position, clusterGraphic);
+    }
+
+    // Graphics of clusters having left are moved to the entered ones
+    QList<Graphic*> addedGraphics;
+    bool graphicsMoved = false;
+    for (const PointClusterIndex::Cluster* cluster : enteredClusters)
+    {
+        const QPair<double, double> position(cluster->longitude, cluster->latitude);
+        if (m_clusterGraphics.contains(position))
+        {
+            continue;
+        }
+
+        const Point center(cluster->longitude, cluster->latitude, SpatialReference::wgs84());
+        if (staleGraphics.isEmpty())
+        {
+            Graphic* clusterGraphic = new Graphic(center, clusterAttributes(*cluster), this);
+            addedGraphics.append(clusterGraphic);
+            m_clusterGraphics.insert(position, clusterGraphic);
+            continue;
+        }
+
+        auto staleGraphic = staleGraphics.begin();
+        Graphic* clusterGraphic = staleGraphic.value();
+        staleGraphics.erase(staleGraphic);
+        clusterGraphic->setGeometry(center);
+        GraphicsFactory::updateAttributes(clusterGraphic, clusterAttributes(*cluster));
+        m_clusterGraphics.insert(position, clusterGraphic);
+        graphicsMoved = true;
+    }
+
+    if (!staleGraphics.isEmpty())
+    {
+        const QList<Graphic*> removedGraphics = staleGraphics.values();
+        GraphicsFactory::removeGraphics(m_clustersOverlay, removedGraphics);
+        qDeleteAll(removedGraphics);
+    }
+    GraphicsFactory::appendGraphics(m_clustersOverlay, addedGraphics);
+    if (graphicsMoved)
+    {
+        if (GraphicsOverlayIndex* overlayIndex = GraphicsOverlayIndex::find(m_clustersOverlay))
+        {
+            overlayIndex->invalidate();
+        }
+    }
+
+    m_clusterZoom = zoom;
+    m_clusterBox = clusterBox;
+    return true;
+}
+
+void SimpleGeoJsonLayer::materializeViewport(bool skipPoints)
+{
+    if (m_decodeFuture.isRunning())
+    {
+        // The viewport is materialized again once the running decoding is done
+        m_viewportPending = true;
+        return;
+    }
+
+    // The stored coordinates are WGS84
+    const Envelope visibleArea = GeometryEngine::project(m_visibleArea, SpatialReference::wgs84()).extent();
+    if (visibleArea.isEmpty())
+    {
+        return;
+    }
+
+    const double marginX = ViewportMargin * visibleArea.width();
+    const double marginY = ViewportMargin * visibleArea.height();
+    const PackedRTree::Box searchBox{ visibleArea.xMin() - marginX, visibleArea.yMin() - marginY,
+                                      visibleArea.xMax() + marginX, visibleArea.yMax() + marginY };
+    QList<qsizetype> visibleFeatures = m_featureStore.search(searchBox);
+    if (skipPoints)
+    {
+        // Clustered points are represented by the cluster graphics
+        visibleFeatures.removeIf([this](qsizetype featureIndex)
+        {
+            const GeoJsonGeometryType geometryType = m_featureStore.geometryType(featureIndex);
+            return GeoJsonGeometryType::Point == geometryType || GeoJsonGeometryType::MultiPoint == geometryType;
+        });
+    }
+    if (MaximumMaterializedFeatures < visibleFeatures.size())
+    {
+        // The features nearest to the center of the view are shown
+        qWarning() << visibleFeatures.size() << "features are visible, only" << MaximumMaterializedFeatures << "are shown!";
+        const double centerX = 0.5 * (visibleArea.xMin() + visibleArea.xMax());
+        const double centerY = 0.5 * (visibleArea.yMin() + visibleArea.yMax());
+        QList<std::pair<double, qsizetype>> rankedFeatures;
+        rankedFeatures.reserve(visibleFeatures.size());
+        for (qsizetype featureIndex : visibleFeatures)
+        {
+            rankedFeatures.append({ m_featureStore.box(featureIndex).squaredDistance(centerX, centerY), featureIndex });
+        }
+        std::nth_element(rankedFeatures.begin(), rankedFeatures.begin() + MaximumMaterializedFeatures, rankedFeatures.end());
+        visibleFeatures.resize(MaximumMaterializedFeatures);
+        for (qsizetype rank = 0; rank < MaximumMaterializedFeatures; rank++)
+        {
+            visibleFeatures[rank] = rankedFeatures.at(rank).second;
+        }
+    }
+    m_viewportFeatures = QSet<qsizetype>(visibleFeatures.cbegin(), visibleFeatures.cend());
+
+    // Evict the graphics of features having left the viewport
+    QHash<GraphicsOverlay*, QList<Graphic*>> evictedGraphics;
+    for (auto materialized = m_materializedGraphics.begin(); materialized != m_materializedGraphics.end();)
+    {
+        if (m_viewportFeatures.contains(materialized.key()))
+        {
+            materialized++;
+            continue;
+        }
+
+        evictedGraphics[overlay(m_featureStore.geometryType(materialized.key()))].append(materialized.value());
+        materialized = m_materializedGraphics.erase(materialized);
+    }
+    for (auto evicted = evictedGraphics.cbegin(); evicted != evictedGraphics.cend(); evicted++)
+    {
+        if (nullptr == evicted.key())
+        {
+            continue;
+        }
+
+        GraphicsFactory::removeGraphics(evicted.key(), evicted.value());
+        m_graphicsFactor->releaseGraphics(evicted.value());
+    }
+
+    // Decode the features having entered the viewport without blocking the owning thread
+    QList<qsizetype> enteredFeatures;
+    for (qsizetype featureIndex : visibleFeatures)
+    {
+        if (!m_materializedGraphics.contains(featureIndex))
+        {
+            enteredFeatures.append(featureIndex);
+        }
+    }
+    if (enteredFeatures.isEmpty())
+    {
+        return;
+    }
+
+    // The store is not changed after loading, the destructor waits for the decoding
+    const GeoJsonFeatureStore* featureStore = &m_featureStore;
+    m_decodeFuture = QtConcurrent::run([featureStore, enteredFeatures]()
+    {
+        QList<GeoJsonFeature> features;
+        features.reserve(enteredFeatures.size());
+        for (qsizetype featureIndex : enteredFeatures)
+        {
+            GeoJsonFeature feature;
+            featureStore->feature(featureIndex, feature);
+            features.append(feature);
+        }
+        return QtConcurrent::blockingMapped(features, &GraphicsFactory::createGeometries);
+    });
+    m_decodeFuture.then(this, [this, enteredFeatures](const QList<GeoJsonFeatureGeometries>& featureGeometries)
+    {
+        onFeaturesDecoded(enteredFeatures, featureGeometries);
+    });
+}
+
+void SimpleGeoJsonLayer::onFeaturesDecoded(const QList<qsizetype>& enteredFeatures, const QList<GeoJsonFeatureGeometries>& featureGeometries)
+{
+    QHash<GraphicsOverlay*, QList<Graphic*>> enteredGraphics;
+    for (qsizetype index = 0; index < featureGeometries.size(); index++)
+    {
+        // Features without graphics are recorded too, so they are not decoded again
+        const qsizetype featureIndex = enteredFeatures.at(index);
+        if (!m_viewportFeatures.contains(featureIndex) || m_materializedGraphics.contains(featureIndex))
+        {
+            continue;
+        }
+
+        const GeoJsonFeatureGeometries& geometries = featureGeometries.at(index);
+        QList<Graphic*>& featureGraphics = m_materializedGraphics[featureIndex];
+        GraphicsOverlay* featureOverlay = overlay(geometries.type);
+        if (nullptr == featureOverlay)
+        {
+            continue;
+        }
+
+        featureGraphics = m_graphicsFactor->createFeatureGraphics(geometries);
+        enteredGraphics[featureOverlay].append(featureGraphics);
+    }
+    for (auto entered = enteredGraphics.cbegin(); entered != enteredGraphics.cend(); entered++)
+    {
+        GraphicsFactory::appendGraphics(entered.key(), entered.value());
+    }
+
+    if (m_viewportPending)
+    {
+        m_viewportPending = false;
+        onViewportChanged();
+    }
+}
+
+GraphicsOverlay* SimpleGeoJsonLayer::overlay(GeoJsonGeometryType geometryType) const
+{
+    switch (geometryType)
+    {
+    case GeoJsonGeometryType::Point:
+    case GeoJsonGeometryType::MultiPoint:
+        return m_pointsOverlay;
+
+    case GeoJsonGeometryType::LineString:
+    case GeoJsonGeometryType::MultiLineString:
+        return m_linesOverlay;
+
+    case GeoJsonGeometryType::Polygon:
+    case GeoJsonGeometryType::MultiPolygon:
+        return m_areasOverlay;
+
+    default:
+        return nullptr;
+    }
 }
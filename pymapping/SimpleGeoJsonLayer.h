@@ -24,7 +24,15 @@
 #ifndef SIMPLEGEOJSONLAYER_H
 #define SIMPLEGEOJSONLAYER_H
 
+#include "GeoJsonFeatureStore.h"
+#include "PointClusterIndex.h"
+
+class GeoJsonLoadJob;
 class GraphicsFactory;
+class JsonStreamReader;
+class QIODevice;
+class RendererCache;
+struct GeoJsonFeatureGeometries;
 
 namespace Esri
 {
@@ -37,25 +45,116 @@ class Renderer;
 }
 }
 
+#include <Envelope.h>
+
+#include <QFuture>
+#include <QHash>
+#include <QList>
 #include <QObject>
+#include <QSet>
+#include <QStringList>
+
+class QTimer;
+
+// Changes applied by one upsert of keyed features
+struct GeoJsonUpsertStatistics
+{
+    qsizetype inserted = 0;
+    qsizetype updated = 0;
+    qsizetype replaced = 0;
+    qsizetype removed = 0;
+    qsizetype skipped = 0;
+};
 
 class SimpleGeoJsonLayer : public QObject
 {
     Q_OBJECT
 public:
+    // Share of the visible extent being materialized on every side of it
+    static constexpr double ViewportMargin = 0.25;
+    // Upper bound of features having graphics at the same time
+    static constexpr qsizetype MaximumMaterializedFeatures = 250000;
+
     explicit SimpleGeoJsonLayer(QObject *parent = nullptr);
+    // The renderers are shared with all layers using the same cache
+    explicit SimpleGeoJsonLayer(RendererCache* rendererCache, QObject *parent = nullptr);
+    ~SimpleGeoJsonLayer() override;
 
     Esri::ArcGISRuntime::GraphicsOverlay* pointsOverlay() const;
     Esri::ArcGISRuntime::GraphicsOverlay* linesOverlay() const;
     Esri::ArcGISRuntime::GraphicsOverlay* areasOverlay() const;
+    Esri::ArcGISRuntime::GraphicsOverlay* clustersOverlay() const;
+
+    void load(const QByteArray& geoJson);
+    void load(QIODevice* geoJsonDevice);
+    GeoJsonLoadJob* loadAsync(const QByteArray& geoJson);
+
+    // The files are mapped into memory and parsed without copying them
+    bool loadFile(const QString& filePath);
+    GeoJsonLoadJob* loadFileAsync(const QString& filePath);
+    bool loadLazyFile(const QString& filePath);
 
-    void load(const QJsonDocument& geoJsonDocument);
+    bool loadBinary(const QString& filePath, const Esri::ArcGISRuntime::Envelope& extent = Esri::ArcGISRuntime::Envelope());
+
+    void loadLazy(const QByteArray& geoJson);
+    void loadLazy(QIODevice* geoJsonDevice);
+    bool isLazy() const;
+    bool enableClustering();
+    bool isClustering() const;
+    bool followsViewport() const;
+    void updateScale(double mapScale);
+    void updateViewport(const Esri::ArcGISRuntime::Envelope& visibleArea);
+
+    bool appendGeometries(const QList<GeoJsonFeatureGeometries>& batchGeometries);
+
+    // Stops loading and following the viewport, the overlays are left to the caller
+    QList<Esri::ArcGISRuntime::GraphicsOverlay*> takeOverlays();
+
+    // Features are matched by the value of their id property
+    GeoJsonUpsertStatistics upsert(const QByteArray& geoJson, const QString& idProperty, bool removeMissing = true);
 
 private:
+    struct KeyedFeature
+    {
+        Esri::ArcGISRuntime::GraphicsOverlay* overlay = nullptr;
+        QList<Esri::ArcGISRuntime::Graphic*> graphics;
+    };
+
+    // Return false when the JSON is invalid, the features read before are kept
+    bool load(JsonStreamReader& reader);
+    bool loadLazy(JsonStreamReader& reader);
+    void onViewportChanged();
+    bool showClusters();
+    void materializeViewport(bool skipPoints);
+    void onFeaturesDecoded(const QList<qsizetype>& enteredFeatures, const QList<GeoJsonFeatureGeometries>& featureGeometries);
+    Esri::ArcGISRuntime::GraphicsOverlay* overlay(GeoJsonGeometryType geometryType) const;
+
     Esri::ArcGISRuntime::GraphicsOverlay* m_pointsOverlay = nullptr;
     Esri::ArcGISRuntime::GraphicsOverlay* m_linesOverlay = nullptr;
     Esri::ArcGISRuntime::GraphicsOverlay* m_areasOverlay = nullptr;
+    Esri::ArcGISRuntime::GraphicsOverlay* m_clustersOverlay = nullptr;
     GraphicsFactory* m_graphicsFactor = nullptr;
+
+    GeoJsonFeatureStore m_featureStore;
+    QHash<qsizetype, QList<Esri::ArcGISRuntime::Graphic*>> m_materializedGraphics;
+    // Features the graphics are materialized for, entered ones are decoded on the thread pool
+    QSet<qsizetype> m_viewportFeatures;
+    QFuture<QList<GeoJsonFeatureGeometries>> m_decodeFuture;
+    bool m_viewportPending = false;
+    Esri::ArcGISRuntime::Envelope m_visibleArea;
+    QTimer* m_viewportTimer = nullptr;
+    bool m_lazy = false;
+
+    QHash<QString, KeyedFeature> m_keyedFeatures;
+
+    PointClusterIndex m_clusterIndex;
+    QStringList m_clusterFields;
+    // Cluster graphics by their position, kept while the zoom and the fetched area stay
+    QHash<QPair<double, double>, Esri::ArcGISRuntime::Graphic*> m_clusterGraphics;
+    PackedRTree::Box m_clusterBox;
+    int m_clusterZoom = -1;
+    double m_mapScale = 0.0;
+    bool m_clustering = false;
 };
 
 #endif // SIMPLEGEOJSONLAYER_H
@@ -0,0 +1,1077 @@
+// geoint-mapping offers core mapping and Geospatial Intelligence capabilities for Python.
+// Copyright (C) 2024 Jan Tschada (gisfromscratch@live.de)
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// Additional permission under GNU LGPL version 3 section 4 and 5
+// If you modify this Program, or any covered work, by linking or combining
+// it with ArcGIS Runtime for Qt (or a modified version of that library),
+// containing parts covered by the terms of ArcGIS Runtime for Qt,
+// the licensors of this Program grant you additional permission to convey the resulting work.
+// See <https://developers.arcgis.com/qt/> for further information.
+//
+
+#include "VectorTilePackageWriter.h"
+#include "FeatureBinaryWriter.h"
+#include "GraphicsFactory.h"
+
+#include <AttributeListModel.h>
+#include <Graphic.h>
+#include <GraphicListModel.h>
+#include <GraphicsOverlay.h>
+
+#include <QFileInfo>
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QPoint>
+#include <QPointF>
+#include <QSaveFile>
+#include <QtConcurrent>
+#include <QtEndian>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <tuple>
+
+using namespace Esri::ArcGISRuntime;
+
+using TilePath = QList<QPointF>;
+using TileRing = QList<QPoint>;
+
+static constexpr double Pi = 3.14159265358979323846;
+static constexpr double MaximumLatitude = 85.0511287798066;
+static constexpr double WebMercatorOrigin = 20037508.342787;
+// Resolution and scale of level 0 having 512 pixels per tile
+static constexpr double BaseResolution = 78271.516964;
+static constexpr double BaseScale = 295828763.7957775;
+
+// Tiles of 128 rows and columns share one compact cache bundle
+static constexpr int BundleSize = 128;
+static constexpr int BundleHeaderSize = 64;
+static constexpr int BundleIndexSize = BundleSize * BundleSize * 8;
+// The index entries of a bundle have 24 bits for the size of a tile
+static constexpr qsizetype MaximumTileSize = (1 << 24) - 1;
+
+// Mapbox vector tile commands and geometry types
+enum TileCommand
+{
+    MoveTo = 1,
+    LineTo = 2,
+    ClosePath = 7
+};
+
+enum TileGeometryType
+{
+    UnknownGeometry = 0,
+    PointGeometry = 1,
+    LineGeometry = 2,
+    PolygonGeometry = 3
+};
+
+static quint32 crc32(const QByteArray& data)
+{
+    static const std::array<quint32, 256> table = []()
+    {
+        std::array<quint32, 256> crcTable;
+        for (quint32 index = 0; index < 256; index++)
+        {
+            quint32 crc = index;
+            for (int bit = 0; bit < 8; bit++)
+            {
+                crc = (crc & 1) ? 0xedb88320u ^ (crc >> 1) : crc >> 1;
+            }
+            crcTable[index] = crc;
+        }
+        return crcTable;
+    }();
+
+    quint32 crc = 0xffffffffu;
+    for (const char byte : data)
+    {
+        crc = table[(crc ^ static_cast<quint8>(byte)) & 0xff] ^ (crc >> 8);
+    }
+    return crc ^ 0xffffffffu;
+}
+
+template <typename T>
+static void appendLittleEndian(QByteArray& buffer, T value)
+{
+    const T littleEndian = qToLittleEndian(value);
+    buffer.append(reinterpret_cast<const char*>(&littleEndian), sizeof(T));
+}
+
+// Wraps the deflate stream of qCompress into the gzip container of the tiles
+static QByteArray gzip(const QByteArray& data)
+{
+    const QByteArray compressed = qCompress(data);
+
+    // qCompress prepends the size, the zlib header and appends the Adler-32 checksum
+    static const int ZlibPrefix = 4 + 2;
+    static const int ZlibSuffix = 4;
+    QByteArray gzipped("\x1f\x8b\x08\x00\x00\x00\x00\x00\x00\xff", 10);
+    gzipped.append(compressed.constData() + ZlibPrefix, compressed.size() - ZlibPrefix - ZlibSuffix);
+    appendLittleEndian<quint32>(gzipped, crc32(data));
+    appendLittleEndian<quint32>(gzipped, static_cast<quint32>(data.size()));
+    return gzipped;
+}
+
+static void writeVarint(QByteArray& buffer, quint64 value)
+{
+    while (0x80 <= value)
+    {
+        buffer.append(static_cast<char>((value & 0x7f) | 0x80));
+        value >>= 7;
+    }
+    buffer.append(static_cast<char>(value));
+}
+
+static void writeKey(QByteArray& buffer, int field, int wireType)
+{
+    writeVarint(buffer, (static_cast<quint32>(field) << 3) | wireType);
+}
+
+static void writeBytes(QByteArray& buffer, int field, const QByteArray& bytes)
+{
+    writeKey(buffer, field, 2);
+    writeVarint(buffer, bytes.size());
+    buffer.append(bytes);
+}
+
+static void writePacked(QByteArray& buffer, int field, const QList<quint32>& values)
+{
+    QByteArray packed;
+    for (quint32 value : values)
+    {
+        writeVarint(packed, value);
+    }
+    writeBytes(buffer, field, packed);
+}
+
+static quint32 zigZag(qint32 value)
+{
+    return (static_cast<quint32>(value) << 1) ^ static_cast<quint32>(value >> 31);
+}
+
+// Vector tile values are messages, equal values share their encoding
+static QByteArray encodeValue(const QVariant& value)
+{
+    QByteArray message;
+    switch (value.typeId())
+    {
+    case QMetaType::Bool:
+        writeKey(message, 7, 0);
+        writeVarint(message, value.toBool() ? 1 : 0);
+        break;
+    case QMetaType::Int:
+    case QMetaType::UInt:
+    case QMetaType::LongLong:
+    case QMetaType::ULongLong:
+    {
+        const qint64 integer = value.toLongLong();
+        if (integer < 0)
+        {
+            writeKey(message, 6, 0);
+            writeVarint(message, (static_cast<quint64>(integer) << 1) ^ static_cast<quint64>(integer >> 63));
+        }
+        else
+        {
+            writeKey(message, 5, 0);
+            writeVarint(message, static_cast<quint64>(integer));
+        }
+        break;
+    }
+    case QMetaType::Float:
+    case QMetaType::Double:
+        writeKey(message, 3, 1);
+        appendLittleEndian<double>(message, value.toDouble());
+        break;
+    default:
+        writeBytes(message, 1, value.toString().toUtf8());
+        break;
+    }
+
+    return message;
+}
+
+/*!
+ * \brief Projects WGS84 vertices into the units of one tile.
+ */
+struct TileProjection
+{
+    double worldSize = 0.0;
+    double originX = 0.0;
+    double originY = 0.0;
+
+    TileProjection(int level, int column, int row) :
+        worldSize(std::ldexp(static_cast<double>(VectorTilePackageWriter::TileExtent), level)),
+        originX(static_cast<double>(column) * VectorTilePackageWriter::TileExtent),
+        originY(static_cast<double>(row) * VectorTilePackageWriter::TileExtent)
+    {
+    }
+
+    QPointF project(const double* vertex) const
+    {
+        const double latitude = qBound(-MaximumLatitude, vertex[1], MaximumLatitude) * Pi / 180.0;
+        const double sinLatitude = std::sin(latitude);
+        const double x = (vertex[0] + 180.0) / 360.0;
+        const double y = 0.5 - std::log((1.0 + sinLatitude) / (1.0 - sinLatitude)) / (4.0 * Pi);
+        return QPointF(x * worldSize - originX, y * worldSize - originY);
+    }
+};
+
+// Longitude and latitude of a normalized Web Mercator position
+static double tileLongitude(double x)
+{
+    return x * 360.0 - 180.0;
+}
+
+static double tileLatitude(double y)
+{
+    return std::atan(std::sinh(Pi * (1.0 - 2.0 * y))) * 180.0 / Pi;
+}
+
+static bool clipSegment(QPointF& begin, QPointF& end, double minimum, double maximum)
+{
+    // Liang-Barsky against the square of the buffered tile
+    const QPointF delta = end - begin;
+    const double p[4] = { -delta.x(), delta.x(), -delta.y(), delta.y() };
+    const double q[4] = { begin.x() - minimum, maximum - begin.x(), begin.y() - minimum, maximum - begin.y() };
+    double first = 0.0;
+    double last = 1.0;
+    for (int edge = 0; edge < 4; edge++)
+    {
+        if (0.0 == p[edge])
+        {
+            if (q[edge] < 0.0)
+            {
+                return false;
+            }
+            continue;
+        }
+
+        const double t = q[edge] / p[edge];
+        if (p[edge] < 0.0)
+        {
+            if (last < t)
+            {
+                return false;
+            }
+            first = qMax(first, t);
+        }
+        else
+        {
+            if (t < first)
+            {
+                return false;
+            }
+            last = qMin(last, t);
+        }
+    }
+
+    const QPointF origin = begin;
+    begin = origin + first * delta;
+    end = origin + last * delta;
+    return true;
+}
+
+static QList<TilePath> clipLine(const TilePath& line, double minimum, double maximum)
+{
+    QList<TilePath> pieces;
+    TilePath piece;
+    for (qsizetype index = 1; index < line.size(); index++)
+    {
+        QPointF begin = line.at(index - 1);
+        QPointF end = line.at(index);
+        if (!clipSegment(begin, end, minimum, maximum))
+        {
+            continue;
+        }
+
+        // The line left the tile in between
+        if (!piece.isEmpty() && piece.last() != begin)
+        {
+            pieces.append(piece);
+            piece.clear();
+        }
+        if (piece.isEmpty())
+        {
+            piece.append(begin);
+        }
+        piece.append(end);
+    }
+    if (!piece.isEmpty())
+    {
+        pieces.append(piece);
+    }
+
+    return pieces;
+}
+
+static TilePath clipRing(const TilePath& ring, double minimum, double maximum)
+{
+    // Sutherland-Hodgman against every edge of the buffered tile
+    TilePath output = ring;
+    for (int edge = 0; edge < 4 && !output.isEmpty(); edge++)
+    {
+        const TilePath input = output;
+        output.clear();
+        const bool vertical = edge < 2;
+        const double bound = 0 == edge % 2 ? minimum : maximum;
+        auto inside = [vertical, bound, edge](const QPointF& point)
+        {
+            const double value = vertical ? point.x() : point.y();
+            return 0 == edge % 2 ? bound <= value : value <= bound;
+        };
+        auto intersection = [vertical, bound](const QPointF& from, const QPointF& to)
+        {
+            const double t = vertical ? (bound - from.x()) / (to.x() - from.x()) : (bound - from.y()) / (to.y() - from.y());
+            return from + t * (to - from);
+        };
+
+        for (qsizetype index = 0; index < input.size(); index++)
+        {
+            const QPointF& current = input.at(index);
+            const QPointF& previous = input.at((index + input.size() - 1) % input.size());
+            if (inside(current))
+            {
+                if (!inside(previous))
+                {
+                    output.append(intersection(previous, current));
+                }
+                output.append(current);
+            }
+            else if (inside(previous))
+            {
+                output.append(intersection(previous, current));
+            }
+        }
+    }
+
+    return output;
+}
+
+static double squaredSegmentDistance(const QPointF& point, const QPointF& first, const QPointF& last)
+{
+    const QPointF segment = last - first;
+    const double squaredLength = QPointF::dotProduct(segment, segment);
+    double t = 0.0;
+    if (0.0 < squaredLength)
+    {
+        t = qBound(0.0, QPointF::dotProduct(point - first, segment) / squaredLength, 1.0);
+    }
+
+    const QPointF offset = point - (first + t * segment);
+    return QPointF::dotProduct(offset, offset);
+}
+
+static TilePath simplify(const TilePath& path, double tolerance)
+{
+    if (path.size() < 3)
+    {
+        return path;
+    }
+
+    // Douglas-Peucker without recursion
+    QList<bool> keep(path.size(), false);
+    keep.first() = true;
+    keep.last() = true;
+    const double squaredTolerance = tolerance * tolerance;
+    QList<std::pair<qsizetype, qsizetype>> ranges = { { 0, path.size() - 1 } };
+    while (!ranges.isEmpty())
+    {
+        const std::pair<qsizetype, qsizetype> range = ranges.takeLast();
+        double maximumDistance = squaredTolerance;
+        qsizetype farthest = -1;
+        for (qsizetype index = range.first + 1; index < range.second; index++)
+        {
+            const double distance = squaredSegmentDistance(path.at(index), path.at(range.first), path.at(range.second));
+            if (maximumDistance < distance)
+            {
+                maximumDistance = distance;
+                farthest = index;
+            }
+        }
+
+        if (0 <= farthest)
+        {
+            keep[farthest] = true;
+            ranges.append({ range.first, farthest });
+            ranges.append({ farthest, range.second });
+        }
+    }
+
+    TilePath simplified;
+    for (qsizetype index = 0; index < path.size(); index++)
+    {
+        if (keep.at(index))
+        {
+            simplified.append(path.at(index));
+        }
+    }
+    return simplified;
+}
+
+// Rounds to tile units, vertices falling onto the same unit are merged
+static TileRing quantize(const TilePath& path)
+{
+    TileRing quantized;
+    quantized.reserve(path.size());
+    for (const QPointF& point : path)
+    {
+        const QPoint unit(qRound(point.x()), qRound(point.y()));
+        if (quantized.isEmpty() || quantized.last() != unit)
+        {
+            quantized.append(unit);
+        }
+    }
+    return quantized;
+}
+
+static qint64 signedArea(const TileRing& ring)
+{
+    qint64 area = 0;
+    for (qsizetype index = 0; index < ring.size(); index++)
+    {
+        const QPoint& point = ring.at(index);
+        const QPoint& nextPoint = ring.at((index + 1) % ring.size());
+        area += static_cast<qint64>(point.x()) * nextPoint.y() - static_cast<qint64>(nextPoint.x()) * point.y();
+    }
+    return area;
+}
+
+static void appendCommand(QList<quint32>& commands, TileCommand command, qsizetype count)
+{
+    commands.append((command & 0x7) | (static_cast<quint32>(count) << 3));
+}
+
+static void appendVertices(QList<quint32>& commands, QPoint& cursor, const TileRing& vertices, qsizetype first, qsizetype last)
+{
+    for (qsizetype index = first; index < last; index++)
+    {
+        const QPoint& vertex = vertices.at(index);
+        commands.append(zigZag(vertex.x() - cursor.x()));
+        commands.append(zigZag(vertex.y() - cursor.y()));
+        cursor = vertex;
+    }
+}
+
+static void appendPath(QList<quint32>& commands, QPoint& cursor, const TileRing& path, bool closed)
+{
+    appendCommand(commands, MoveTo, 1);
+    appendVertices(commands, cursor, path, 0, 1);
+    appendCommand(commands, LineTo, path.size() - 1);
+    appendVertices(commands, cursor, path, 1, path.size());
+    if (closed)
+    {
+        appendCommand(commands, ClosePath, 1);
+    }
+}
+
+static TilePath projectPart(const GeoJsonGeometry& geometry, const TileProjection& projection, qsizetype partIndex)
+{
+    TilePath path;
+    const qsizetype lastPoint = geometry.partEnd(partIndex);
+    path.reserve(lastPoint - geometry.partBegin(partIndex));
+    for (qsizetype pointIndex = geometry.partBegin(partIndex); pointIndex < lastPoint; pointIndex++)
+    {
+        path.append(projection.project(geometry.vertex(pointIndex)));
+    }
+    return path;
+}
+
+// Encodes the commands of one geometry clipped to the tile, returns its tile geometry type
+static TileGeometryType encodeGeometry(const GeoJsonGeometry& geometry, const TileProjection& projection, QList<quint32>& commands)
+{
+    const double minimum = -VectorTilePackageWriter::TileBuffer;
+    const double maximum = VectorTilePackageWriter::TileExtent + VectorTilePackageWriter::TileBuffer;
+    QPoint cursor;
+    switch (geometry.type)
+    {
+    case GeoJsonGeometryType::Point:
+    case GeoJsonGeometryType::MultiPoint:
+    {
+        TileRing points;
+        for (qsizetype pointIndex = 0; pointIndex < geometry.pointCount(); pointIndex++)
+        {
+            const QPointF point = projection.project(geometry.vertex(pointIndex));
+            if (minimum <= point.x() && point.x() <= maximum && minimum <= point.y() && point.y() <= maximum)
+            {
+                points.append(QPoint(qRound(point.x()), qRound(point.y())));
+            }
+        }
+        if (points.isEmpty())
+        {
+            return UnknownGeometry;
+        }
+
+        appendCommand(commands, MoveTo, points.size());
+        appendVertices(commands, cursor, points, 0, points.size());
+        return PointGeometry;
+    }
+
+    case GeoJsonGeometryType::LineString:
+    case GeoJsonGeometryType::MultiLineString:
+        for (qsizetype partIndex = 0; partIndex < geometry.partCount(); partIndex++)
+        {
+            const QList<TilePath> pieces = clipLine(projectPart(geometry, projection, partIndex), minimum, maximum);
+            for (const TilePath& piece : pieces)
+            {
+                const TileRing line = quantize(simplify(piece, VectorTilePackageWriter::Tolerance));
+                if (2 <= line.size())
+                {
+                    appendPath(commands, cursor, line, false);
+                }
+            }
+        }
+        return commands.isEmpty() ? UnknownGeometry : LineGeometry;
+
+    case GeoJsonGeometryType::Polygon:
+    case GeoJsonGeometryType::MultiPolygon:
+    {
+        // Single polygons may have no polygon offsets
+        const qsizetype polygonCount = qMax<qsizetype>(1, geometry.polygonCount());
+        for (qsizetype polygonIndex = 0; polygonIndex < polygonCount; polygonIndex++)
+        {
+            const qsizetype firstPart = 0 < geometry.polygonCount() ? geometry.polygonBegin(polygonIndex) : 0;
+            const qsizetype lastPart = 0 < geometry.polygonCount() ? geometry.polygonEnd(polygonIndex) : geometry.partCount();
+            for (qsizetype partIndex = firstPart; partIndex < lastPart; partIndex++)
+            {
+                TilePath ring = projectPart(geometry, projection, partIndex);
+                if (1 < ring.size() && ring.first() == ring.last())
+                {
+                    ring.removeLast();
+                }
+
+                // The simplification sees the ring closed
+                ring = clipRing(ring, minimum, maximum);
+                if (!ring.isEmpty())
+                {
+                    ring.append(ring.first());
+                }
+                TileRing tileRing = quantize(simplify(ring, VectorTilePackageWriter::Tolerance));
+                if (1 < tileRing.size() && tileRing.first() == tileRing.last())
+                {
+                    tileRing.removeLast();
+                }
+
+                const qint64 area = tileRing.size() < 3 ? 0 : signedArea(tileRing);
+                const bool exterior = firstPart == partIndex;
+                if (0 == area)
+                {
+                    if (exterior)
+                    {
+                        // The holes of a vanished polygon vanish as well
+                        break;
+                    }
+                    continue;
+                }
+
+                // Exterior rings have a positive area in tile units, holes a negative one
+                if (exterior != (0 < area))
+                {
+                    std::reverse(tileRing.begin(), tileRing.end());
+                }
+                appendPath(commands, cursor, tileRing, true);
+            }
+        }
+        return commands.isEmpty() ? UnknownGeometry : PolygonGeometry;
+    }
+
+    default:
+        return UnknownGeometry;
+    }
+}
+
+/*!
+ * \brief Stores the entries of the package uncompressed in a zip archive.
+ *
+ * The tiles are compressed on their own, so the archive only needs the
+ * stored method. Archives larger than 4 GB are refused.
+ */
+class PackageArchive
+{
+public:
+    explicit PackageArchive(QIODevice* device) :
+        m_device(device)
+    {
+    }
+
+    bool add(const QString& name, const QByteArray& data)
+    {
+        const QByteArray fileName = name.toUtf8();
+        const quint32 crc = crc32(data);
+        const qint64 offset = m_device->pos();
+        if (0xffffffffLL < offset + data.size() || 0xffff <= m_entryCount)
+        {
+            m_errorString = QStringLiteral("The vector tile package exceeds the zip limits, use less levels!");
+            return false;
+        }
+
+        QByteArray header;
+        appendLittleEndian<quint32>(header, 0x04034b50);
+        appendEntry(header, crc, data.size(), fileName);
+        appendLittleEndian<quint16>(header, 0);
+        header.append(fileName);
+
+        appendLittleEndian<quint32>(m_centralDirectory, 0x02014b50);
+        appendLittleEndian<quint16>(m_centralDirectory, 20);
+        appendEntry(m_centralDirectory, crc, data.size(), fileName);
+        appendLittleEndian<quint16>(m_centralDirectory, 0);
+        appendLittleEndian<quint16>(m_centralDirectory, 0);
+        appendLittleEndian<quint16>(m_centralDirectory, 0);
+        appendLittleEndian<quint16>(m_centralDirectory, 0);
+        appendLittleEndian<quint32>(m_centralDirectory, 0);
+        appendLittleEndian<quint32>(m_centralDirectory, static_cast<quint32>(offset));
+        m_centralDirectory.append(fileName);
+        m_entryCount++;
+
+        return write(header) && write(data);
+    }
+
+    bool finish()
+    {
+        const qint64 offset = m_device->pos();
+        if (0xffffffffLL < offset + m_centralDirectory.size())
+        {
+            m_errorString = QStringLiteral("The vector tile package exceeds the zip limits, use less levels!");
+            return false;
+        }
+
+        QByteArray end;
+        appendLittleEndian<quint32>(end, 0x06054b50);
+        appendLittleEndian<quint16>(end, 0);
+        appendLittleEndian<quint16>(end, 0);
+        appendLittleEndian<quint16>(end, static_cast<quint16>(m_entryCount));
+        appendLittleEndian<quint16>(end, static_cast<quint16>(m_entryCount));
+        appendLittleEndian<quint32>(end, static_cast<quint32>(m_centralDirectory.size()));
+        appendLittleEndian<quint32>(end, static_cast<quint32>(offset));
+        appendLittleEndian<quint16>(end, 0);
+        return write(m_centralDirectory) && write(end);
+    }
+
+    QString errorString() const
+    {
+        return m_errorString;
+    }
+
+private:
+    // The fields local headers share with the central directory
+    static void appendEntry(QByteArray& buffer, quint32 crc, qint64 size, const QByteArray& fileName)
+    {
+        appendLittleEndian<quint16>(buffer, 20);
+        appendLittleEndian<quint16>(buffer, 0x0800);
+        appendLittleEndian<quint16>(buffer, 0);
+        appendLittleEndian<quint16>(buffer, 0);
+        appendLittleEndian<quint16>(buffer, 0x21);
+        appendLittleEndian<quint32>(buffer, crc);
+        appendLittleEndian<quint32>(buffer, static_cast<quint32>(size));
+        appendLittleEndian<quint32>(buffer, static_cast<quint32>(size));
+        appendLittleEndian<quint16>(buffer, static_cast<quint16>(fileName.size()));
+    }
+
+    bool write(const QByteArray& data)
+    {
+        if (data.size() != m_device->write(data))
+        {
+            m_errorString = m_device->errorString();
+            return false;
+        }
+        return true;
+    }
+
+    QIODevice* m_device;
+    QByteArray m_centralDirectory;
+    qsizetype m_entryCount = 0;
+    QString m_errorString;
+};
+
+void VectorTilePackageWriter::append(const QString& layerName, const GeoJsonFeature& feature)
+{
+    sourceLayer(layerName).features.append(feature);
+}
+
+qsizetype VectorTilePackageWriter::append(const QString& layerName, const GraphicsOverlay* overlay)
+{
+    qsizetype appendedCount = 0;
+    if (nullptr == overlay)
+    {
+        return appendedCount;
+    }
+
+    GeoJsonFeatureStore& features = sourceLayer(layerName).features;
+    GraphicListModel* graphics = overlay->graphics();
+    GeoJsonFeature feature;
+    for (int row = 0; row < graphics->size(); row++)
+    {
+        const Graphic* graphic = graphics->at(row);
+        feature.clear();
+        if (!FeatureBinaryWriter::toGeoJsonGeometry(GraphicsFactory::fullGeometry(graphic), feature.geometry))
+        {
+            continue;
+        }
+
+        feature.properties = graphic->attributes()->attributesMap();
+        features.append(feature);
+        appendedCount++;
+    }
+
+    return appendedCount;
+}
+
+qsizetype VectorTilePackageWriter::size() const
+{
+    qsizetype featureCount = 0;
+    for (const SourceLayer& layer : m_layers)
+    {
+        featureCount += layer.features.size();
+    }
+    return featureCount;
+}
+
+void VectorTilePackageWriter::setLevels(int minLevel, int maxLevel)
+{
+    m_maxLevel = qBound(0, maxLevel, MaximumLevel);
+    m_minLevel = qBound(0, minLevel, m_maxLevel);
+}
+
+bool VectorTilePackageWriter::write(const QString& filePath)
+{
+    PackedRTree::Box extent;
+    for (SourceLayer& layer : m_layers)
+    {
+        layer.features.buildIndex();
+        if (!layer.features.isEmpty())
+        {
+            extent.expand(layer.features.extent());
+        }
+    }
+    if (extent.isEmpty())
+    {
+        m_errorString = QStringLiteral("There are no features to write!");
+        return false;
+    }
+
+    // The previous package stays intact until the new one is complete
+    QSaveFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly))
+    {
+        m_errorString = file.errorString();
+        return false;
+    }
+
+    PackageArchive archive(&file);
+    const QString itemInfo = QStringLiteral(R"(<?xml version="1.0" encoding="utf-8"?>
+<ESRI_ItemInformation Culture="en-US"><name>%1</name><title>%1</title><type>Vector Tile Package</type><typekeywords><typekeyword>Vector Tile Package</typekeyword></typekeywords></ESRI_ItemInformation>
+)").arg(QFileInfo(filePath).completeBaseName().toHtmlEscaped());
+    bool written = archive.add("esriinfo/iteminfo.xml", itemInfo.toUtf8())
+        && archive.add("p12/root.json", rootJson(extent))
+        && archive.add("p12/resources/styles/root.json", styleJson());
+
+    // Only the children of tiles having features can have features
+    QList<TileAddress> tiles = { TileAddress() };
+    for (int level = 0; written && level <= m_maxLevel && !tiles.isEmpty(); level++)
+    {
+        std::sort(tiles.begin(), tiles.end(), [](const TileAddress& tile, const TileAddress& otherTile)
+        {
+            return std::make_tuple(tile.row / BundleSize, tile.column / BundleSize, tile.row, tile.column)
+                < std::make_tuple(otherTile.row / BundleSize, otherTile.column / BundleSize, otherTile.row, otherTile.column);
+        });
+
+        QList<TileAddress> childTiles;
+        qsizetype bundleBegin = 0;
+        while (written && bundleBegin < tiles.size())
+        {
+            const int bundleRow = tiles.at(bundleBegin).row / BundleSize;
+            const int bundleColumn = tiles.at(bundleBegin).column / BundleSize;
+            qsizetype bundleEnd = bundleBegin + 1;
+            while (bundleEnd < tiles.size() && bundleRow == tiles.at(bundleEnd).row / BundleSize && bundleColumn == tiles.at(bundleEnd).column / BundleSize)
+            {
+                bundleEnd++;
+            }
+
+            // The tiles of one bundle are encoded on the thread pool
+            const QList<TileAddress> bundleTiles = tiles.mid(bundleBegin, bundleEnd - bundleBegin);
+            const QList<QByteArray> encodedTiles = QtConcurrent::blockingMapped<QList<QByteArray>>(bundleTiles, [this, level](const TileAddress& tile)
+            {
+                return encodeTile(level, tile);
+            });
+            bundleBegin = bundleEnd;
+
+            QByteArray bundle(BundleHeaderSize + BundleIndexSize, '\0');
+            quint32 maximumTileSize = 0;
+            for (qsizetype tileIndex = 0; tileIndex < bundleTiles.size(); tileIndex++)
+            {
+                const QByteArray& encodedTile = encodedTiles.at(tileIndex);
+                if (encodedTile.isEmpty())
+                {
+                    continue;
+                }
+
+                const TileAddress& tile = bundleTiles.at(tileIndex);
+                if (MaximumTileSize < encodedTile.size())
+                {
+                    m_errorString = QStringLiteral("The tile %1/%2/%3 exceeds the bundle limits, use less levels or features!").arg(level).arg(tile.row).arg(tile.column);
+                    return false;
+                }
+
+                childTiles.append({ 2 * tile.column, 2 * tile.row });
+                childTiles.append({ 2 * tile.column + 1, 2 * tile.row });
+                childTiles.append({ 2 * tile.column, 2 * tile.row + 1 });
+                childTiles.append({ 2 * tile.column + 1, 2 * tile.row + 1 });
+
+                // Every index entry has the offset of the tile in 40 bits and its size in 24 bits
+                appendLittleEndian<quint32>(bundle, static_cast<quint32>(encodedTile.size()));
+                const quint64 indexEntry = static_cast<quint64>(bundle.size()) | (static_cast<quint64>(encodedTile.size()) << 40);
+                const qsizetype indexPosition = BundleHeaderSize + 8 * ((tile.row % BundleSize) * BundleSize + tile.column % BundleSize);
+                qToLittleEndian<quint64>(indexEntry, bundle.data() + indexPosition);
+                bundle.append(encodedTile);
+                maximumTileSize = qMax<quint32>(maximumTileSize, encodedTile.size());
+            }
+            if (level < m_minLevel || 0 == maximumTileSize)
+            {
+                continue;
+            }
+
+            QByteArray header;
+            appendLittleEndian<quint32>(header, 3);
+            appendLittleEndian<quint32>(header, BundleSize * BundleSize);
+            appendLittleEndian<quint32>(header, maximumTileSize);
+            appendLittleEndian<quint32>(header, 5);
+            appendLittleEndian<quint64>(header, 0);
+            appendLittleEndian<quint64>(header, bundle.size());
+            appendLittleEndian<quint64>(header, 40);
+            appendLittleEndian<quint32>(header, 20 + BundleIndexSize);
+            appendLittleEndian<quint32>(header, 3);
+            appendLittleEndian<quint32>(header, 16);
+            appendLittleEndian<quint32>(header, BundleSize * BundleSize);
+            appendLittleEndian<quint32>(header, 5);
+            appendLittleEndian<quint32>(header, BundleIndexSize);
+            bundle.replace(0, BundleHeaderSize, header);
+
+            const QString bundleName = QString::asprintf("p12/tile/L%02d/R%04xC%04x.bundle", level, bundleRow * BundleSize, bundleColumn * BundleSize);
+            written = archive.add(bundleName, bundle);
+        }
+
+        tiles = childTiles;
+    }
+
+    if (!written || !archive.finish())
+    {
+        m_errorString = archive.errorString();
+        file.cancelWriting();
+        return false;
+    }
+    if (!file.commit())
+    {
+        m_errorString = file.errorString();
+        return false;
+    }
+
+    return true;
+}
+
+QString VectorTilePackageWriter::errorString() const
+{
+    return m_errorString;
+}
+
+VectorTilePackageWriter::SourceLayer& VectorTilePackageWriter::sourceLayer(const QString& layerName)
+{
+    auto layer = std::find_if(m_layers.begin(), m_layers.end(), [&layerName](const SourceLayer& sourceLayer)
+    {
+        return layerName == sourceLayer.name;
+    });
+    if (m_layers.end() != layer)
+    {
+        return *layer;
+    }
+
+    m_layers.append(SourceLayer{ layerName, GeoJsonFeatureStore() });
+    return m_layers.last();
+}
+
+QByteArray VectorTilePackageWriter::encodeTile(int level, const TileAddress& tile) const
+{
+    // The search box covers the buffer around the tile
+    const double tileCount = std::ldexp(1.0, level);
+    const double buffer = static_cast<double>(TileBuffer) / TileExtent;
+    const PackedRTree::Box searchBox{ tileLongitude((tile.column - buffer) / tileCount),
+                                      tileLatitude((tile.row + 1 + buffer) / tileCount),
+                                      tileLongitude((tile.column + 1 + buffer) / tileCount),
+                                      tileLatitude((tile.row - buffer) / tileCount) };
+    const TileProjection projection(level, tile.column, tile.row);
+
+    QByteArray encodedTile;
+    GeoJsonFeature feature;
+    for (const SourceLayer& layer : m_layers)
+    {
+        QList<qsizetype> featureIndices = layer.features.search(searchBox);
+        if (featureIndices.isEmpty())
+        {
+            continue;
+        }
+        std::sort(featureIndices.begin(), featureIndices.end());
+
+        // Keys and values are shared by all features of the tile layer
+        QByteArray layerMessage;
+        QHash<QString, quint32> keyIndices;
+        QHash<QByteArray, quint32> valueIndices;
+        QByteArray keys;
+        QByteArray values;
+        qsizetype featureCount = 0;
+        for (qsizetype featureIndex : featureIndices)
+        {
+            layer.features.feature(featureIndex, feature);
+            QList<quint32> commands;
+            const TileGeometryType geometryType = encodeGeometry(feature.geometry, projection, commands);
+            if (UnknownGeometry == geometryType)
+            {
+                continue;
+            }
+
+            QList<quint32> tags;
+            for (auto property = feature.properties.cbegin(); property != feature.properties.cend(); property++)
+            {
+                if (property.value().isNull())
+                {
+                    continue;
+                }
+
+                auto keyIndex = keyIndices.constFind(property.key());
+                if (keyIndices.cend() == keyIndex)
+                {
+                    keyIndex = keyIndices.insert(property.key(), keyIndices.size());
+                    writeBytes(keys, 3, property.key().toUtf8());
+                }
+                const QByteArray value = encodeValue(property.value());
+                auto valueIndex = valueIndices.constFind(value);
+                if (valueIndices.cend() == valueIndex)
+                {
+                    valueIndex = valueIndices.insert(value, valueIndices.size());
+                    writeBytes(values, 4, value);
+                }
+                tags.append(keyIndex.value());
+                tags.append(valueIndex.value());
+            }
+
+            QByteArray featureMessage;
+            writeKey(featureMessage, 1, 0);
+            writeVarint(featureMessage, featureIndex + 1);
+            if (!tags.isEmpty())
+            {
+                writePacked(featureMessage, 2, tags);
+            }
+            writeKey(featureMessage, 3, 0);
+            writeVarint(featureMessage, geometryType);
+            writePacked(featureMessage, 4, commands);
+            writeBytes(layerMessage, 2, featureMessage);
+            featureCount++;
+        }
+        if (0 == featureCount)
+        {
+            continue;
+        }
+
+        QByteArray layerHeader;
+        writeKey(layerHeader, 15, 0);
+        writeVarint(layerHeader, 2);
+        writeBytes(layerHeader, 1, layer.name.toUtf8());
+        layerMessage.prepend(layerHeader);
+        layerMessage.append(keys);
+        layerMessage.append(values);
+        writeKey(layerMessage, 5, 0);
+        writeVarint(layerMessage, TileExtent);
+        writeBytes(encodedTile, 3, layerMessage);
+    }
+
+    return encodedTile.isEmpty() ? encodedTile : gzip(encodedTile);
+}
+
+QByteArray VectorTilePackageWriter::rootJson(const PackedRTree::Box& extent) const
+{
+    const QJsonObject spatialReference{ { "wkid", 102100 }, { "latestWkid", 3857 } };
+    auto toWebMercator = [](double longitude, double latitude)
+    {
+        const double clampedLatitude = qBound(-MaximumLatitude, latitude, MaximumLatitude) * Pi / 180.0;
+        return QPointF(longitude * WebMercatorOrigin / 180.0, std::log(std::tan(Pi / 4.0 + clampedLatitude / 2.0)) * WebMercatorOrigin / Pi);
+    };
+    const QPointF lowerLeft = toWebMercator(extent.minX, extent.minY);
+    const QPointF upperRight = toWebMercator(extent.maxX, extent.maxY);
+    const QJsonObject fullExtent{ { "xmin", lowerLeft.x() }, { "ymin", lowerLeft.y() },
+                                  { "xmax", upperRight.x() }, { "ymax", upperRight.y() },
+                                  { "spatialReference", spatialReference } };
+
+    QJsonArray levels;
+    for (int level = 0; level <= MaximumLevel; level++)
+    {
+        levels.append(QJsonObject{ { "level", level },
+                                   { "resolution", std::ldexp(BaseResolution, -level) },
+                                   { "scale", std::ldexp(BaseScale, -level) } });
+    }
+
+    const QJsonObject tileInfo{ { "rows", 512 }, { "cols", 512 }, { "dpi", 96 }, { "format", "pbf" },
+                                { "origin", QJsonObject{ { "x", -WebMercatorOrigin }, { "y", WebMercatorOrigin } } },
+                                { "spatialReference", spatialReference },
+                                { "lods", levels } };
+    const QJsonObject storageInfo{ { "packetSize", BundleSize }, { "storageFormat", "compactV2" } };
+    const QJsonObject resourceInfo{ { "styleVersion", 8 }, { "tileCompression", "gzip" },
+                                    { "cacheInfo", QJsonObject{ { "storageInfo", storageInfo } } } };
+    const QJsonObject root{ { "currentVersion", 10.9 },
+                            { "name", "coremapping" },
+                            { "capabilities", "TilesOnly" },
+                            { "type", "indexedVector" },
+                            { "defaultStyles", "resources/styles" },
+                            { "tiles", QJsonArray{ "tile/{z}/{y}/{x}.pbf" } },
+                            { "exportTilesAllowed", false },
+                            { "initialExtent", fullExtent },
+                            { "fullExtent", fullExtent },
+                            { "minScale", 0 },
+                            { "maxScale", 0 },
+                            { "tileInfo", tileInfo },
+                            { "minLOD", m_minLevel },
+                            { "maxLOD", m_maxLevel },
+                            { "maxzoom", m_maxLevel },
+                            { "resourceInfo", resourceInfo } };
+    return QJsonDocument(root).toJson(QJsonDocument::Compact);
+}
+
+QByteArray VectorTilePackageWriter::styleJson() const
+{
+    // Every source layer is drawn like the overlays of a GeoJSON layer
+    QJsonArray styleLayers;
+    for (const SourceLayer& layer : m_layers)
+    {
+        styleLayers.append(QJsonObject{ { "id", layer.name + "/areas" }, { "type", "fill" },
+                                        { "source", "esri" }, { "source-layer", layer.name },
+                                        { "filter", QJsonArray{ "==", "$type", "Polygon" } },
+                                        { "paint", QJsonObject{ { "fill-color", "#d3c2a6" }, { "fill-opacity", 0.35 }, { "fill-outline-color", "#000000" } } } });
+        styleLayers.append(QJsonObject{ { "id", layer.name + "/lines" }, { "type", "line" },
+                                        { "source", "esri" }, { "source-layer", layer.name },
+                                        { "filter", QJsonArray{ "==", "$type", "LineString" } },
+                                        { "paint", QJsonObject{ { "line-color", "#000000" }, { "line-width", 5 }, { "line-opacity", 0.35 } } } });
+        styleLayers.append(QJsonObject{ { "id", layer.name + "/points" }, { "type", "circle" },
+                                        { "source", "esri" }, { "source-layer", layer.name },
+                                        { "filter", QJsonArray{ "==", "$type", "Point" } },
+                                        { "paint", QJsonObject{ { "circle-color", "#d3c2a6" }, { "circle-radius", 6 },
+                                                                { "circle-stroke-color", "#000000" }, { "circle-stroke-width", 4 } } } });
+    }
+
+    const QJsonObject style{ { "version", 8 },
+                             { "sources", QJsonObject{ { "esri", QJsonObject{ { "type", "vector" }, { "url", "../../" } } } } },
+                             { "layers", styleLayers } };
+    return QJsonDocument(style).toJson(QJsonDocument::Compact);
+}
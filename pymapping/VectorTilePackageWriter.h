@@ -0,0 +1,98 @@
+// geoint-mapping offers core mapping and Geospatial Intelligence capabilities for Python.
+// Copyright (C) 2024 Jan Tschada (gisfromscratch@live.de)
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// Additional permission under GNU LGPL version 3 section 4 and 5
+// If you modify this Program, or any covered work, by linking or combining
+// it with ArcGIS Runtime for Qt (or a modified version of that library),
+// containing parts covered by the terms of ArcGIS Runtime for Qt,
+// the licensors of this Program grant you additional permission to convey the resulting work.
+// See <https://developers.arcgis.com/qt/> for further information.
+//
+
+#ifndef VECTORTILEPACKAGEWRITER_H
+#define VECTORTILEPACKAGEWRITER_H
+
+#include "GeoJsonFeatureStore.h"
+
+namespace Esri
+{
+namespace ArcGISRuntime
+{
+class GraphicsOverlay;
+}
+}
+
+#include <QByteArray>
+#include <QList>
+#include <QString>
+
+/*!
+ * \brief Writes features into a vector tile package (.vtpk).
+ *
+ * Every level of the Web Mercator tiling scheme gets its own Mapbox vector
+ * tiles. The geometries are clipped to every tile, simplified to the tile
+ * resolution and quantized to integer tile coordinates. The tiles are
+ * stored in compact cache bundles together with a default style, so the
+ * package can be loaded like any other vector tile basemap.
+ * Every appended source layer becomes one layer of the tiles. Graphics are
+ * appended with their full geometry, not the level of detail shown.
+ */
+class VectorTilePackageWriter
+{
+public:
+    // Units on every side of a tile like Mapbox vector tiles
+    static constexpr int TileExtent = 4096;
+    // Units being kept outside of a tile, so strokes are not cut at its border
+    static constexpr int TileBuffer = 64;
+    // Deviation of simplified geometries in tile units
+    static constexpr double Tolerance = 1.0;
+    static constexpr int MaximumLevel = 22;
+
+    void append(const QString& layerName, const GeoJsonFeature& feature);
+    qsizetype append(const QString& layerName, const Esri::ArcGISRuntime::GraphicsOverlay* overlay);
+    qsizetype size() const;
+
+    // Levels below the minimum level have no tiles
+    void setLevels(int minLevel, int maxLevel);
+
+    bool write(const QString& filePath);
+    QString errorString() const;
+
+private:
+    struct SourceLayer
+    {
+        QString name;
+        GeoJsonFeatureStore features;
+    };
+
+    struct TileAddress
+    {
+        int column = 0;
+        int row = 0;
+    };
+
+    SourceLayer& sourceLayer(const QString& layerName);
+    QByteArray encodeTile(int level, const TileAddress& tile) const;
+    QByteArray rootJson(const PackedRTree::Box& extent) const;
+    QByteArray styleJson() const;
+
+    QList<SourceLayer> m_layers;
+    int m_minLevel = 0;
+    int m_maxLevel = 14;
+    QString m_errorString;
+};
+
+#endif // VECTORTILEPACKAGEWRITER_H
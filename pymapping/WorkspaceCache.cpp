@@ -0,0 +1,183 @@
+// geoint-mapping offers core mapping and Geospatial Intelligence capabilities for Python.
+// Copyright (C) 2024 Jan Tschada (gisfromscratch@live.de)
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// Additional permission under GNU LGPL version 3 section 4 and 5
+// If you modify this Program, or any covered work, by linking or combining
+// it with ArcGIS Runtime for Qt (or a modified version of that library),
+// containing parts covered by the terms of ArcGIS Runtime for Qt,
+// the licensors of this Program grant you additional permission to convey the resulting work.
+// See <https://developers.arcgis.com/qt/> for further information.
+//
+
+#include "WorkspaceCache.h"
+
+#include <Geodatabase.h>
+#include <GeoPackage.h>
+#include <MobileMapPackage.h>
+
+#include <QCoreApplication>
+#include <QFileInfo>
+#include <QPointer>
+
+using namespace Esri::ArcGISRuntime;
+
+// The same file opened as another kind of workspace gets its own handle
+template <typename Workspace>
+static QString workspaceKey(const QString& filePath)
+{
+    const QFileInfo fileInfo(filePath);
+    const QString canonicalFilePath = fileInfo.canonicalFilePath();
+    return QString("%1|%2").arg(Workspace::staticMetaObject.className(), canonicalFilePath.isEmpty() ? fileInfo.absoluteFilePath() : canonicalFilePath);
+}
+
+WorkspaceCache::WorkspaceCache(QObject *parent) :
+    QObject(parent)
+{
+}
+
+WorkspaceCache* WorkspaceCache::instance()
+{
+    // The application owns the cache, so the workspaces go before the runtime
+    static QPointer<WorkspaceCache> workspaceCache;
+    if (workspaceCache.isNull())
+    {
+        workspaceCache = new WorkspaceCache(QCoreApplication::instance());
+    }
+
+    return workspaceCache;
+}
+
+MobileMapPackage* WorkspaceCache::acquireMobileMapPackage(const QString& filePath)
+{
+    return acquire<MobileMapPackage>(filePath);
+}
+
+Geodatabase* WorkspaceCache::acquireGeodatabase(const QString& filePath)
+{
+    return acquire<Geodatabase>(filePath);
+}
+
+GeoPackage* WorkspaceCache::acquireGeoPackage(const QString& filePath)
+{
+    return acquire<GeoPackage>(filePath);
+}
+
+template <typename Workspace>
+Workspace* WorkspaceCache::acquire(const QString& filePath)
+{
+    const QString key = workspaceKey<Workspace>(filePath);
+    QObject* workspace = m_workspaces.value(key);
+    if (nullptr == workspace)
+    {
+        Workspace* newWorkspace = new Workspace(filePath, this);
+        connect(newWorkspace, &Workspace::doneLoading, this, [this, newWorkspace](const Error& error)
+        {
+            if (!error.isEmpty())
+            {
+                forget(newWorkspace);
+            }
+        });
+        workspace = newWorkspace;
+        m_workspaces.insert(key, workspace);
+        m_entries.insert(workspace, Entry{ key });
+    }
+
+    Entry& entry = m_entries[workspace];
+    entry.references++;
+    entry.lastUse = ++m_useCount;
+    return static_cast<Workspace*>(workspace);
+}
+
+void WorkspaceCache::release(QObject* workspace)
+{
+    auto entry = m_entries.find(workspace);
+    if (m_entries.end() == entry || entry->references <= 0)
+    {
+        return;
+    }
+
+    entry->lastUse = ++m_useCount;
+    if (0 < --entry->references)
+    {
+        return;
+    }
+
+    // Forgotten workspaces are not opened again
+    if (workspace != m_workspaces.value(entry->key))
+    {
+        m_entries.erase(entry);
+        workspace->deleteLater();
+        return;
+    }
+
+    evictUnused();
+}
+
+qsizetype WorkspaceCache::size() const
+{
+    return m_workspaces.size();
+}
+
+void WorkspaceCache::forget(QObject* workspace)
+{
+    auto entry = m_entries.find(workspace);
+    if (m_entries.end() == entry)
+    {
+        return;
+    }
+
+    // The next acquire opens the file again
+    if (workspace == m_workspaces.value(entry->key))
+    {
+        m_workspaces.remove(entry->key);
+    }
+    if (0 == entry->references)
+    {
+        m_entries.erase(entry);
+        workspace->deleteLater();
+    }
+}
+
+void WorkspaceCache::evictUnused()
+{
+    while (true)
+    {
+        qsizetype unusedCount = 0;
+        auto leastRecentlyUsed = m_entries.end();
+        for (auto entry = m_entries.begin(); entry != m_entries.end(); entry++)
+        {
+            if (0 < entry->references)
+            {
+                continue;
+            }
+
+            unusedCount++;
+            if (m_entries.end() == leastRecentlyUsed || entry->lastUse < leastRecentlyUsed->lastUse)
+            {
+                leastRecentlyUsed = entry;
+            }
+        }
+        if (unusedCount <= MaximumUnusedWorkspaces)
+        {
+            return;
+        }
+
+        QObject* workspace = leastRecentlyUsed.key();
+        m_workspaces.remove(leastRecentlyUsed->key);
+        m_entries.erase(leastRecentlyUsed);
+        workspace->deleteLater();
+    }
+}
@@ -0,0 +1,111 @@
+// geoint-mapping offers core mapping and Geospatial Intelligence capabilities for Python.
+// Copyright (C) 2024 Jan Tschada (gisfromscratch@live.de)
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// Additional permission under GNU LGPL version 3 section 4 and 5
+// If you modify this Program, or any covered work, by linking or combining
+// it with ArcGIS Runtime for Qt (or a modified version of that library),
+// containing parts covered by the terms of ArcGIS Runtime for Qt,
+// the licensors of this Program grant you additional permission to convey the resulting work.
+// See <https://developers.arcgis.com/qt/> for further information.
+//
+
+#ifndef WORKSPACECACHE_H
+#define WORKSPACECACHE_H
+
+namespace Esri
+{
+namespace ArcGISRuntime
+{
+class Geodatabase;
+class GeoPackage;
+class MobileMapPackage;
+}
+}
+
+#include <Error.h>
+#include <LoadableTypes.h>
+
+#include <QHash>
+#include <QMetaObject>
+#include <QObject>
+#include <QString>
+
+/*!
+ * \brief Process-wide cache of mobile map packages, geodatabases and GeoPackages.
+ *
+ * Workspaces are keyed by their canonical file path, so every open of the
+ * same file shares one loaded handle and its tables. Every acquire must be
+ * paired with a release. Released workspaces stay loaded until more than
+ * MaximumUnusedWorkspaces of them are unused, the least recently used one
+ * is destroyed first. Workspaces failing to load are opened again by the
+ * next acquire. A shared table or raster can only be bound to one layer,
+ * so the users of the cache reuse the layers of the tables they bound.
+ * Mobile map packages hand out the same maps again, including the layers
+ * added to them. The cache lives on the thread of the application.
+ */
+class WorkspaceCache : public QObject
+{
+    Q_OBJECT
+public:
+    static constexpr qsizetype MaximumUnusedWorkspaces = 8;
+
+    static WorkspaceCache* instance();
+
+    Esri::ArcGISRuntime::MobileMapPackage* acquireMobileMapPackage(const QString& filePath);
+    Esri::ArcGISRuntime::Geodatabase* acquireGeodatabase(const QString& filePath);
+    Esri::ArcGISRuntime::GeoPackage* acquireGeoPackage(const QString& filePath);
+    void release(QObject* workspace);
+
+    qsizetype size() const;
+
+    // Calls the handler once the workspace is loaded, loaded workspaces call it from the event loop
+    template <typename Workspace, typename Handler>
+    static void whenLoaded(Workspace* workspace, QObject* context, Handler handler)
+    {
+        if (Esri::ArcGISRuntime::LoadStatus::Loaded == workspace->loadStatus())
+        {
+            QMetaObject::invokeMethod(context, [handler]()
+            {
+                handler(Esri::ArcGISRuntime::Error());
+            }, Qt::QueuedConnection);
+            return;
+        }
+
+        connect(workspace, &Workspace::doneLoading, context, handler, Qt::SingleShotConnection);
+        workspace->load();
+    }
+
+private:
+    struct Entry
+    {
+        QString key;
+        qsizetype references = 0;
+        quint64 lastUse = 0;
+    };
+
+    explicit WorkspaceCache(QObject *parent = nullptr);
+
+    template <typename Workspace>
+    Workspace* acquire(const QString& filePath);
+    void forget(QObject* workspace);
+    void evictUnused();
+
+    QHash<QString, QObject*> m_workspaces;
+    QHash<QObject*, Entry> m_entries;
+    quint64 m_useCount = 0;
+};
+
+#endif // WORKSPACECACHE_H
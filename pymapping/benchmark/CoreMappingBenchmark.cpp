@@ -0,0 +1,560 @@
+// geoint-mapping offers core mapping and Geospatial Intelligence capabilities for Python.
+// Copyright (C) 2024 Jan Tschada (gisfromscratch@live.de)
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// Additional permission under GNU LGPL version 3 section 4 and 5
+// If you modify this Program, or any covered work, by linking or combining
+// it with ArcGIS Runtime for Qt (or a modified version of that library),
+// containing parts covered by the terms of ArcGIS Runtime for Qt,
+// the licensors of this Program grant you additional permission to convey the resulting work.
+// See <https://developers.arcgis.com/qt/> for further information.
+//
+
+// Measures the ingestion and export paths of coremapping on synthetic datasets.
+// Every benchmark reports its throughput, the number of operator new calls and
+// the peak resident set size of the process after running it.
+
+#include "GeoElementsOverlayModel.h"
+#include "GeoJsonFeatureReader.h"
+#include "GraphicsFactory.h"
+#include "GraphicsOverlayPool.h"
+#include "JsonStreamReader.h"
+#include "MapViewModel.h"
+#include "SimpleGeoJsonLayer.h"
+
+#include <GraphicsOverlay.h>
+#include <MapQuickView.h>
+
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QGuiApplication>
+#include <QPointF>
+#include <QRandomGenerator>
+#include <QtConcurrent>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <memory>
+#include <new>
+
+#ifdef Q_OS_WIN
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+using namespace Esri::ArcGISRuntime;
+
+static constexpr double Pi = 3.14159265358979323846;
+
+static std::atomic<quint64> s_allocationCount{0};
+static std::atomic<quint64> s_allocatedBytes{0};
+
+void* operator new(std::size_t size)
+{
+    s_allocationCount.fetch_add(1, std::memory_order_relaxed);
+    s_allocatedBytes.fetch_add(size, std::memory_order_relaxed);
+    if (void* memory = std::malloc(0 < size ? size : 1))
+    {
+        return memory;
+    }
+
+    throw std::bad_alloc();
+}
+
+void operator delete(void* memory) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept
+{
+    std::free(memory);
+}
+
+static qint64 peakResidentBytes()
+{
+#ifdef Q_OS_WIN
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+    {
+        return static_cast<qint64>(counters.PeakWorkingSetSize);
+    }
+    return -1;
+#else
+    rusage usage;
+    if (0 != getrusage(RUSAGE_SELF, &usage))
+    {
+        return -1;
+    }
+#ifdef Q_OS_MACOS
+    return usage.ru_maxrss;
+#else
+    return static_cast<qint64>(usage.ru_maxrss) * 1024;
+#endif
+#endif
+}
+
+// Every feature is a list of parts, rings of one polygon follow each other
+using SyntheticFeature = QList<QList<QPointF>>;
+
+enum class DatasetType
+{
+    Points,
+    Lines,
+    Polygons
+};
+
+struct DatasetOptions
+{
+    qsizetype featureCount = 10000;
+    qsizetype vertexCount = 256;
+    qsizetype ringCount = 8;
+};
+
+struct Dataset
+{
+    DatasetType type = DatasetType::Points;
+    QString name;
+    qsizetype featureCount = 0;
+    QByteArray geoJson;
+    QString esriJson;
+    QString renderer;
+};
+
+static QList<QPointF> createRing(const QPointF& center, double radius, qsizetype vertexCount, bool clockwise)
+{
+    QList<QPointF> ring;
+    ring.reserve(vertexCount + 1);
+    const double direction = clockwise ? -1.0 : 1.0;
+    for (qsizetype vertexIndex = 0; vertexIndex < vertexCount; vertexIndex++)
+    {
+        const double angle = direction * 2.0 * Pi * vertexIndex / vertexCount;
+        ring.append(QPointF(center.x() + radius * std::cos(angle), center.y() + radius * std::sin(angle)));
+    }
+    ring.append(ring.first());
+    return ring;
+}
+
+static QList<SyntheticFeature> createFeatures(DatasetType type, const DatasetOptions& options)
+{
+    // The datasets are reproducible between runs
+    QRandomGenerator random(42);
+    QList<SyntheticFeature> features;
+    features.reserve(options.featureCount);
+    for (qsizetype featureIndex = 0; featureIndex < options.featureCount; featureIndex++)
+    {
+        const QPointF origin(random.bounded(340.0) - 170.0, random.bounded(160.0) - 80.0);
+        SyntheticFeature feature;
+        switch (type)
+        {
+        case DatasetType::Points:
+            feature.append({ origin });
+            break;
+
+        case DatasetType::Lines:
+        {
+            // A random walk starting at the origin
+            QList<QPointF> line;
+            line.reserve(options.vertexCount);
+            QPointF vertex = origin;
+            for (qsizetype vertexIndex = 0; vertexIndex < options.vertexCount; vertexIndex++)
+            {
+                line.append(vertex);
+                vertex += QPointF(random.bounded(0.02) - 0.01, random.bounded(0.02) - 0.01);
+            }
+            feature.append(line);
+            break;
+        }
+
+        case DatasetType::Polygons:
+        {
+            // Exterior ring with holes placed on a circle inside of it
+            const double radius = 1.0;
+            feature.append(createRing(origin, radius, options.vertexCount, false));
+            const qsizetype holeCount = options.ringCount - 1;
+            for (qsizetype holeIndex = 0; holeIndex < holeCount; holeIndex++)
+            {
+                const double angle = 2.0 * Pi * holeIndex / holeCount;
+                const QPointF holeCenter(origin.x() + 0.6 * radius * std::cos(angle), origin.y() + 0.6 * radius * std::sin(angle));
+                const double holeRadius = qMin(0.15, 0.6 * radius * std::sin(Pi / qMax<qsizetype>(holeCount, 2)) * 0.8);
+                feature.append(createRing(holeCenter, holeRadius, options.vertexCount, true));
+            }
+            break;
+        }
+        }
+
+        features.append(feature);
+    }
+
+    return features;
+}
+
+static void appendCoordinates(QByteArray& json, const QList<QPointF>& part)
+{
+    json.append('[');
+    for (qsizetype vertexIndex = 0; vertexIndex < part.size(); vertexIndex++)
+    {
+        if (0 < vertexIndex)
+        {
+            json.append(',');
+        }
+        const QPointF& vertex = part.at(vertexIndex);
+        json.append('[').append(QByteArray::number(vertex.x(), 'f', 6)).append(',').append(QByteArray::number(vertex.y(), 'f', 6)).append(']');
+    }
+    json.append(']');
+}
+
+static void appendParts(QByteArray& json, const SyntheticFeature& feature)
+{
+    json.append('[');
+    for (qsizetype partIndex = 0; partIndex < feature.size(); partIndex++)
+    {
+        if (0 < partIndex)
+        {
+            json.append(',');
+        }
+        appendCoordinates(json, feature.at(partIndex));
+    }
+    json.append(']');
+}
+
+static QByteArray toGeoJson(DatasetType type, const QList<SyntheticFeature>& features)
+{
+    static const char* categories[] = { "alpha", "bravo", "charlie", "delta", "echo" };
+    QByteArray json("{\"type\":\"FeatureCollection\",\"features\":[");
+    for (qsizetype featureIndex = 0; featureIndex < features.size(); featureIndex++)
+    {
+        if (0 < featureIndex)
+        {
+            json.append(',');
+        }
+
+        const SyntheticFeature& feature = features.at(featureIndex);
+        json.append("{\"type\":\"Feature\",\"properties\":{\"id\":").append(QByteArray::number(featureIndex))
+            .append(",\"category\":\"").append(categories[featureIndex % 5])
+            .append("\",\"value\":").append(QByteArray::number(0.5 * featureIndex, 'f', 1))
+            .append("},\"geometry\":{");
+        switch (type)
+        {
+        case DatasetType::Points:
+        {
+            const QPointF& point = feature.first().first();
+            json.append("\"type\":\"Point\",\"coordinates\":[").append(QByteArray::number(point.x(), 'f', 6)).append(',').append(QByteArray::number(point.y(), 'f', 6)).append(']');
+            break;
+        }
+
+        case DatasetType::Lines:
+            json.append("\"type\":\"LineString\",\"coordinates\":");
+            appendCoordinates(json, feature.first());
+            break;
+
+        case DatasetType::Polygons:
+            json.append("\"type\":\"Polygon\",\"coordinates\":");
+            appendParts(json, feature);
+            break;
+        }
+        json.append("}}");
+    }
+    json.append("]}");
+    return json;
+}
+
+static QString toEsriJson(DatasetType type, const QList<SyntheticFeature>& features)
+{
+    QByteArray json("[");
+    for (qsizetype featureIndex = 0; featureIndex < features.size(); featureIndex++)
+    {
+        if (0 < featureIndex)
+        {
+            json.append(',');
+        }
+
+        const SyntheticFeature& feature = features.at(featureIndex);
+        switch (type)
+        {
+        case DatasetType::Points:
+        {
+            const QPointF& point = feature.first().first();
+            json.append("{\"x\":").append(QByteArray::number(point.x(), 'f', 6)).append(",\"y\":").append(QByteArray::number(point.y(), 'f', 6));
+            break;
+        }
+
+        case DatasetType::Lines:
+            json.append("{\"paths\":");
+            appendParts(json, feature);
+            break;
+
+        case DatasetType::Polygons:
+            // Esri JSON expects clockwise exterior rings
+            json.append("{\"rings\":");
+            {
+                SyntheticFeature rings = feature;
+                for (QList<QPointF>& ring : rings)
+                {
+                    std::reverse(ring.begin(), ring.end());
+                }
+                appendParts(json, rings);
+            }
+            break;
+        }
+        json.append(",\"spatialReference\":{\"wkid\":4326}}");
+    }
+    json.append(']');
+    return QString::fromUtf8(json);
+}
+
+static Dataset createDataset(DatasetType type, const DatasetOptions& options)
+{
+    Dataset dataset;
+    dataset.type = type;
+    dataset.featureCount = options.featureCount;
+    const QList<SyntheticFeature> features = createFeatures(type, options);
+    dataset.geoJson = toGeoJson(type, features);
+    dataset.esriJson = toEsriJson(type, features);
+    switch (type)
+    {
+    case DatasetType::Points:
+        dataset.name = "points";
+        dataset.renderer = R"({"type":"simple","symbol":{"type":"esriSMS","style":"esriSMSCircle","color":[211,194,166,255],"size":8}})";
+        break;
+
+    case DatasetType::Lines:
+        dataset.name = "lines";
+        dataset.renderer = R"({"type":"simple","symbol":{"type":"esriSLS","style":"esriSLSSolid","color":[0,0,0,255],"width":2}})";
+        break;
+
+    case DatasetType::Polygons:
+        dataset.name = "polygons";
+        dataset.renderer = R"({"type":"simple","symbol":{"type":"esriSFS","style":"esriSFSSolid","color":[211,194,166,128]}})";
+        break;
+    }
+
+    return dataset;
+}
+
+class BenchmarkRunner
+{
+public:
+    BenchmarkRunner(int iterations, const QString& filter) :
+        m_iterations(iterations),
+        m_filter(filter)
+    {
+        std::printf("%-28s %10s %10s %14s %10s %14s %12s %12s\n",
+                    "benchmark", "items", "best ms", "items/s", "MB/s", "allocs/iter", "alloc MB", "peak RSS MB");
+    }
+
+    // Only the body is measured, setup and teardown run around every iteration
+    void run(const QString& name, qsizetype itemCount, qint64 byteCount,
+             const std::function<void()>& setup,
+             const std::function<void()>& body,
+             const std::function<void()>& teardown)
+    {
+        if (!m_filter.isEmpty() && !name.contains(m_filter))
+        {
+            return;
+        }
+
+        QList<qint64> elapsedNanoseconds;
+        quint64 allocationCount = 0;
+        quint64 allocatedBytes = 0;
+        for (int iteration = 0; iteration < m_iterations; iteration++)
+        {
+            setup();
+            const quint64 firstAllocation = s_allocationCount.load();
+            const quint64 firstAllocatedByte = s_allocatedBytes.load();
+            QElapsedTimer timer;
+            timer.start();
+            body();
+            elapsedNanoseconds.append(timer.nsecsElapsed());
+            allocationCount += s_allocationCount.load() - firstAllocation;
+            allocatedBytes += s_allocatedBytes.load() - firstAllocatedByte;
+            teardown();
+        }
+
+        const double bestSeconds = *std::min_element(elapsedNanoseconds.cbegin(), elapsedNanoseconds.cend()) / 1.0e9;
+        const double megabytes = 1024.0 * 1024.0;
+        std::printf("%-28s %10lld %10.1f %14.0f %10.1f %14.0f %12.1f %12.1f\n",
+                    qPrintable(name),
+                    static_cast<long long>(itemCount),
+                    1.0e3 * bestSeconds,
+                    itemCount / bestSeconds,
+                    0 < byteCount ? byteCount / megabytes / bestSeconds : 0.0,
+                    static_cast<double>(allocationCount) / m_iterations,
+                    allocatedBytes / megabytes / m_iterations,
+                    peakResidentBytes() / megabytes);
+        std::fflush(stdout);
+    }
+
+private:
+    int m_iterations;
+    QString m_filter;
+};
+
+// The pool destroys the cleared graphics in slices of the event loop,
+// finishing them here keeps the teardown out of the next measurement
+static void clearGraphicOverlays(MapViewModel& mapViewModel)
+{
+    mapViewModel.clearGraphicOverlays();
+    GraphicsOverlayPool* overlayPool = mapViewModel.findChild<GraphicsOverlayPool*>();
+    if (overlayPool)
+    {
+        overlayPool->flush();
+    }
+    QCoreApplication::processEvents();
+}
+
+static void benchmarkDataset(BenchmarkRunner& runner, const Dataset& dataset, MapViewModel& mapViewModel)
+{
+    static const auto noop = []() {};
+
+    std::unique_ptr<SimpleGeoJsonLayer> geojsonLayer;
+    runner.run("load/" + dataset.name, dataset.featureCount, dataset.geoJson.size(),
+        [&geojsonLayer]()
+        {
+            geojsonLayer = std::make_unique<SimpleGeoJsonLayer>();
+        },
+        [&geojsonLayer, &dataset]()
+        {
+            geojsonLayer->load(dataset.geoJson);
+        },
+        [&geojsonLayer]()
+        {
+            geojsonLayer.reset();
+        });
+
+    // The features are parsed and their geometries built once, only the graphics are measured
+    QList<QList<GeoJsonFeatureGeometries>> batches;
+    {
+        JsonStreamReader reader(dataset.geoJson);
+        GeoJsonFeatureReader featureReader(reader);
+        bool moreFeatures = true;
+        while (moreFeatures)
+        {
+            QList<GeoJsonFeature> featureBatch;
+            moreFeatures = GraphicsFactory::FeatureBatchSize == featureReader.readFeatures(featureBatch, GraphicsFactory::FeatureBatchSize);
+            batches.append(QtConcurrent::blockingMapped(featureBatch, &GraphicsFactory::createGeometries));
+        }
+    }
+
+    std::unique_ptr<QObject> owner;
+    GraphicsFactory* graphicsFactory = nullptr;
+    GraphicsOverlay* overlays[3] = {};
+    runner.run("createGraphics/" + dataset.name, dataset.featureCount, 0,
+        [&]()
+        {
+            owner = std::make_unique<QObject>();
+            graphicsFactory = new GraphicsFactory(owner.get());
+            for (GraphicsOverlay*& overlay : overlays)
+            {
+                overlay = new GraphicsOverlay(owner.get());
+            }
+        },
+        [&]()
+        {
+            for (const QList<GeoJsonFeatureGeometries>& batch : batches)
+            {
+                graphicsFactory->createGraphics(batch, overlays[0], overlays[1], overlays[2]);
+            }
+        },
+        [&owner]()
+        {
+            owner.reset();
+        });
+    batches.clear();
+
+    runner.run("addGeometries/" + dataset.name, dataset.featureCount, dataset.esriJson.size(),
+        noop,
+        [&mapViewModel, &dataset]()
+        {
+            mapViewModel.addGeometries(dataset.esriJson, dataset.renderer);
+        },
+        [&mapViewModel]()
+        {
+            clearGraphicOverlays(mapViewModel);
+        });
+
+    // The GeoJSON layer appends its points, lines and areas overlays in this order
+    GeoElementsOverlayModel* overlayModel = mapViewModel.property("overlayModel").value<GeoElementsOverlayModel*>();
+    const int overlayIndex = static_cast<int>(dataset.type);
+    runner.run("toDict/" + dataset.name, dataset.featureCount, 0,
+        [&mapViewModel, &dataset]()
+        {
+            mapViewModel.addGeoJsonFeatures(QString::fromUtf8(dataset.geoJson));
+        },
+        [overlayModel, overlayIndex]()
+        {
+            const QVariantList elements = overlayModel->toDict(overlayIndex);
+            Q_UNUSED(elements);
+        },
+        [&mapViewModel]()
+        {
+            clearGraphicOverlays(mapViewModel);
+        });
+}
+
+int main(int argc, char *argv[])
+{
+    // The map view is never shown
+    if (!qEnvironmentVariableIsSet("QT_QPA_PLATFORM"))
+    {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+
+    QGuiApplication application(argc, argv);
+    QCoreApplication::setApplicationName("coremapping_benchmark");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Benchmarks the ingestion and export paths of coremapping.");
+    parser.addHelpOption();
+    const QCommandLineOption featuresOption("features", "Number of features of every dataset.", "count", "10000");
+    const QCommandLineOption verticesOption("vertices", "Number of vertices of every line and ring.", "count", "256");
+    const QCommandLineOption ringsOption("rings", "Number of rings of every polygon.", "count", "8");
+    const QCommandLineOption iterationsOption("iterations", "Number of measured runs of every benchmark.", "count", "5");
+    const QCommandLineOption filterOption("filter", "Only runs the benchmarks whose name contains the text.", "text");
+    parser.addOptions({ featuresOption, verticesOption, ringsOption, iterationsOption, filterOption });
+    parser.process(application);
+
+    DatasetOptions options;
+    options.featureCount = qMax(1, parser.value(featuresOption).toInt());
+    options.vertexCount = qMax(3, parser.value(verticesOption).toInt());
+    options.ringCount = qMax(1, parser.value(ringsOption).toInt());
+    const int iterations = qMax(1, parser.value(iterationsOption).toInt());
+
+    std::printf("features: %lld, vertices: %lld, rings: %lld, iterations: %d\n",
+                static_cast<long long>(options.featureCount),
+                static_cast<long long>(options.vertexCount),
+                static_cast<long long>(options.ringCount),
+                iterations);
+
+    // The view goes first, it does not own the map of the view model
+    MapViewModel mapViewModel;
+    MapQuickView mapView;
+    mapViewModel.setProperty("mapView", QVariant::fromValue(&mapView));
+
+    BenchmarkRunner runner(iterations, parser.value(filterOption));
+    for (DatasetType type : { DatasetType::Points, DatasetType::Lines, DatasetType::Polygons })
+    {
+        const Dataset dataset = createDataset(type, options);
+        benchmarkDataset(runner, dataset, mapViewModel);
+    }
+
+    return 0;
+}
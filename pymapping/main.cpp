@@ -23,6 +23,8 @@
 //
 
 #include <iostream>
+#include <memory>
+#include <optional>
 
 using namespace std;
 
@@ -32,6 +34,7 @@ using namespace std;
 #include <pybind11/stl.h>
 
 #include <ArcGISRuntimeEnvironment.h>
+#include <GeometryTypes.h>
 #include <MapQuickView.h>
 #include <MapTypes.h>
 #include <Point.h>
@@ -42,6 +45,7 @@ using namespace std;
 
 #include <QProcessEnvironment>
 
+#include "CoordinateArrays.h"
 #include "GeoElementsOverlayModel.h"
 #include "MapViewModel.h"
 
@@ -50,6 +54,9 @@ namespace py = pybind11;
 using namespace Esri::ArcGISRuntime;
 using namespace std;
 
+typedef py::array_t<double, py::array::c_style | py::array::forcecast> DoubleArray;
+typedef py::array_t<qint64, py::array::c_style | py::array::forcecast> OffsetArray;
+
 static void initializeLocationServicesFromEnvironment()
 {
     QString apiKeyName = "arcgis_api_key";
@@ -110,10 +117,327 @@ static void initialize(const string& apiKey = "")
     // Register the MapViewModel (QQuickItem) for QML
     qmlRegisterType<MapViewModel>("Esri.Mapping", 1, 0, "MapViewModel");
 
-    // Register the GeoElementsOverlayModel
-    //qmlRegisterInterface<GeoElementsOverlayModel>("GeoElementsOverlayModel", 1);
-    //qmlRegisterType<GeoElementsOverlayModel>("Esri.Mapping", 1, 0, "GeoElementsOverlayModel");
-    //qRegisterMetaType<GeoElementsOverlayModel>("GeoElementsOverlayModel");
+    // Register the GeoElementsOverlayModel so that QML can access its enums
+    qmlRegisterUncreatableType<GeoElementsOverlayModel>("Esri.Mapping", 1, 0, "GeoElementsOverlayModel",
+                                                        "GeoElementsOverlayModel is owned by the MapViewModel");
+}
+
+template <typename T>
+static T* toQObject(const py::object& wrapper, const char* typeName)
+{
+    // PySide6 wrappers expose the address of the underlying QObject
+    py::object getCppPointer = py::module_::import("shiboken6").attr("getCppPointer");
+    py::tuple pointers = getCppPointer(wrapper);
+    QObject* object = reinterpret_cast<QObject*>(pointers[0].cast<uintptr_t>());
+    T* instance = qobject_cast<T*>(object);
+    if (!instance)
+    {
+        throw py::type_error(string("Expected a ") + typeName + " instance!");
+    }
+
+    return instance;
+}
+
+static QList<QVariantMap> toAttributeMaps(const py::dict& attributes, qsizetype rowCount)
+{
+    QList<QVariantMap> attributeMaps(attributes.empty() ? 0 : rowCount);
+    for (const auto& attribute : attributes)
+    {
+        QString name = QString::fromStdString(string(py::str(attribute.first)));
+        py::array column = py::array::ensure(attribute.second);
+        if (!column || 1 != column.ndim() || rowCount != column.size())
+        {
+            throw py::value_error("Every attribute column must be a one-dimensional array with one value per geometry!");
+        }
+
+        switch (column.dtype().kind())
+        {
+        case 'f':
+        {
+            DoubleArray values = DoubleArray::ensure(column);
+            auto valuesView = values.unchecked<1>();
+            for (qsizetype row = 0; row < rowCount; row++)
+            {
+                attributeMaps[row].insert(name, valuesView(row));
+            }
+            break;
+        }
+        case 'i':
+        case 'u':
+        {
+            OffsetArray values = OffsetArray::ensure(column);
+            auto valuesView = values.unchecked<1>();
+            for (qsizetype row = 0; row < rowCount; row++)
+            {
+                attributeMaps[row].insert(name, valuesView(row));
+            }
+            break;
+        }
+        case 'b':
+        {
+            py::array_t<bool, py::array::forcecast> values = py::array_t<bool, py::array::forcecast>::ensure(column);
+            auto valuesView = values.unchecked<1>();
+            for (qsizetype row = 0; row < rowCount; row++)
+            {
+                attributeMaps[row].insert(name, valuesView(row));
+            }
+            break;
+        }
+        default:
+        {
+            // Strings and objects are stored as text
+            py::list values = column.attr("tolist")();
+            for (qsizetype row = 0; row < rowCount; row++)
+            {
+                py::handle value = values[static_cast<size_t>(row)];
+                attributeMaps[row].insert(name, value.is_none() ? QVariant() : QVariant(QString::fromStdString(string(py::str(value)))));
+            }
+            break;
+        }
+        }
+    }
+
+    return attributeMaps;
+}
+
+static CoordinateArrays toCoordinateArrays(const DoubleArray& x, const DoubleArray& y,
+                                           const optional<DoubleArray>& z, const optional<DoubleArray>& m)
+{
+    if (1 != x.ndim() || 1 != y.ndim() || x.size() != y.size())
+    {
+        throw py::value_error("x and y must be one-dimensional arrays of the same length!");
+    }
+
+    CoordinateArrays coordinates;
+    coordinates.x = x.data();
+    coordinates.y = y.data();
+    coordinates.pointCount = x.size();
+    if (z)
+    {
+        if (1 != z->ndim() || x.size() != z->size())
+        {
+            throw py::value_error("z must be a one-dimensional array of the same length as x!");
+        }
+        coordinates.z = z->data();
+    }
+    if (m)
+    {
+        if (1 != m->ndim() || x.size() != m->size())
+        {
+            throw py::value_error("m must be a one-dimensional array of the same length as x!");
+        }
+        coordinates.m = m->data();
+    }
+
+    return coordinates;
+}
+
+static qsizetype validateOffsets(const OffsetArray& offsets, qsizetype lastOffset, const char* offsetsName)
+{
+    // Offsets start with zero, never decrease and end with the number of indexed elements
+    if (1 != offsets.ndim() || offsets.size() < 1)
+    {
+        throw py::value_error(string(offsetsName) + " must be a one-dimensional array starting with 0!");
+    }
+
+    auto offsetsView = offsets.unchecked<1>();
+    qsizetype offsetCount = offsets.size();
+    if (0 != offsetsView(0) || lastOffset != offsetsView(offsetCount - 1))
+    {
+        throw py::value_error(string(offsetsName) + " must start with 0 and end with the number of indexed elements!");
+    }
+    for (qsizetype index = 1; index < offsetCount; index++)
+    {
+        if (offsetsView(index) < offsetsView(index - 1))
+        {
+            throw py::value_error(string(offsetsName) + " must not decrease!");
+        }
+    }
+
+    return offsetCount - 1;
+}
+
+static bool addPointArrays(const py::object& model, const DoubleArray& x, const DoubleArray& y, const string& renderer,
+                           const optional<DoubleArray>& z, const optional<DoubleArray>& m,
+                           const py::dict& attributes, int wkid)
+{
+    MapViewModel* mapViewModel = toQObject<MapViewModel>(model, "MapViewModel");
+    CoordinateArrays coordinates = toCoordinateArrays(x, y, z, m);
+    coordinates.geometryCount = coordinates.pointCount;
+    QList<QVariantMap> attributeMaps = toAttributeMaps(attributes, coordinates.geometryCount);
+
+    py::gil_scoped_release release;
+    return mapViewModel->addGeometryArrays(GeometryType::Point, coordinates, attributeMaps, QString::fromStdString(renderer), wkid);
+}
+
+static bool addMultipartArrays(GeometryType geometryType, const py::object& model, const DoubleArray& x, const DoubleArray& y,
+                               const OffsetArray& partOffsets, const string& renderer, const optional<OffsetArray>& geometryOffsets,
+                               const optional<DoubleArray>& z, const optional<DoubleArray>& m,
+                               const py::dict& attributes, int wkid)
+{
+    MapViewModel* mapViewModel = toQObject<MapViewModel>(model, "MapViewModel");
+    CoordinateArrays coordinates = toCoordinateArrays(x, y, z, m);
+    coordinates.partCount = validateOffsets(partOffsets, coordinates.pointCount, "partOffsets");
+    coordinates.partOffsets = partOffsets.data();
+    if (geometryOffsets)
+    {
+        coordinates.geometryCount = validateOffsets(*geometryOffsets, coordinates.partCount, "geometryOffsets");
+        coordinates.geometryOffsets = geometryOffsets->data();
+    }
+    else
+    {
+        coordinates.geometryCount = coordinates.partCount;
+    }
+    QList<QVariantMap> attributeMaps = toAttributeMaps(attributes, coordinates.geometryCount);
+
+    py::gil_scoped_release release;
+    return mapViewModel->addGeometryArrays(geometryType, coordinates, attributeMaps, QString::fromStdString(renderer), wkid);
+}
+
+static bool addPolylineArrays(const py::object& model, const DoubleArray& x, const DoubleArray& y,
+                              const OffsetArray& partOffsets, const string& renderer, const optional<OffsetArray>& geometryOffsets,
+                              const optional<DoubleArray>& z, const optional<DoubleArray>& m,
+                              const py::dict& attributes, int wkid)
+{
+    return addMultipartArrays(GeometryType::Polyline, model, x, y, partOffsets, renderer, geometryOffsets, z, m, attributes, wkid);
+}
+
+static bool addPolygonArrays(const py::object& model, const DoubleArray& x, const DoubleArray& y,
+                             const OffsetArray& partOffsets, const string& renderer, const optional<OffsetArray>& geometryOffsets,
+                             const optional<DoubleArray>& z, const optional<DoubleArray>& m,
+                             const py::dict& attributes, int wkid)
+{
+    return addMultipartArrays(GeometryType::Polygon, model, x, y, partOffsets, renderer, geometryOffsets, z, m, attributes, wkid);
+}
+
+template <typename T>
+static py::array toArray(const QList<T>& values, const py::capsule& owner)
+{
+    // The array shares the buffer being kept alive by the owner
+    return py::array_t<T>(values.size(), values.constData(), owner);
+}
+
+static py::array toBooleanArray(const QList<quint8>& values, const py::capsule& owner)
+{
+    return py::array_t<bool>(values.size(), reinterpret_cast<const bool*>(values.constData()), owner);
+}
+
+static py::array toUnicodeArray(const QStringList& strings)
+{
+    // NumPy stores unicode strings as fixed-width UCS-4
+    qsizetype width = 1;
+    for (const QString& text : strings)
+    {
+        width = std::max(width, text.size());
+    }
+
+    py::array array(py::dtype("U" + to_string(width)), { strings.size() });
+    char32_t* data = static_cast<char32_t*>(array.mutable_data());
+    std::fill_n(data, strings.size() * width, U'\0');
+    for (qsizetype row = 0; row < strings.size(); row++)
+    {
+        const QString& text = strings.at(row);
+        char32_t* cell = data + row * width;
+        for (qsizetype index = 0; index < text.size(); index++)
+        {
+            const QChar character = text.at(index);
+            if (character.isHighSurrogate() && index + 1 < text.size() && text.at(index + 1).isLowSurrogate())
+            {
+                *cell++ = QChar::surrogateToUcs4(character, text.at(++index));
+            }
+            else
+            {
+                *cell++ = character.unicode();
+            }
+        }
+    }
+
+    return array;
+}
+
+static const char* geometryTypeName(GeometryType geometryType)
+{
+    switch (geometryType)
+    {
+    case GeometryType::Point:
+        return "point";
+    case GeometryType::Multipoint:
+        return "multipoint";
+    case GeometryType::Polyline:
+        return "polyline";
+    case GeometryType::Polygon:
+        return "polygon";
+    case GeometryType::Envelope:
+        return "envelope";
+    default:
+        return "unknown";
+    }
+}
+
+static py::dict toColumns(const py::object& model, int index)
+{
+    GeoElementsOverlayModel* overlayModel = toQObject<GeoElementsOverlayModel>(model, "GeoElementsOverlayModel");
+    unique_ptr<GeoElementColumns> columns;
+    {
+        py::gil_scoped_release release;
+        columns = make_unique<GeoElementColumns>(overlayModel->toColumns(index));
+    }
+
+    // All arrays share the buffers owned by the capsule
+    const GeoElementColumns& buffers = *columns;
+    py::capsule owner(columns.release(), [](void* pointer)
+    {
+        delete static_cast<GeoElementColumns*>(pointer);
+    });
+
+    py::dict result;
+    result["geometryType"] = geometryTypeName(buffers.geometryType);
+    result["count"] = buffers.rowCount;
+    result["x"] = toArray(buffers.x, owner);
+    result["y"] = toArray(buffers.y, owner);
+    if (buffers.hasZ)
+    {
+        result["z"] = toArray(buffers.z, owner);
+    }
+    if (!buffers.partOffsets.isEmpty())
+    {
+        result["partOffsets"] = toArray(buffers.partOffsets, owner);
+    }
+    if (!buffers.geometryOffsets.isEmpty())
+    {
+        result["geometryOffsets"] = toArray(buffers.geometryOffsets, owner);
+    }
+
+    py::dict attributes;
+    py::dict nulls;
+    for (const GeoElementColumn& column : buffers.attributes)
+    {
+        py::str name(column.name.toStdString());
+        switch (column.type)
+        {
+        case GeoElementColumnType::Boolean:
+            attributes[name] = toBooleanArray(column.booleans, owner);
+            break;
+        case GeoElementColumnType::Integer:
+            attributes[name] = toArray(column.integers, owner);
+            break;
+        case GeoElementColumnType::Null:
+        case GeoElementColumnType::Double:
+            attributes[name] = toArray(column.doubles, owner);
+            break;
+        case GeoElementColumnType::String:
+            attributes[name] = toUnicodeArray(column.strings);
+            break;
+        }
+        if (0 < column.nullCount)
+        {
+            nulls[name] = toBooleanArray(column.nulls, owner);
+        }
+    }
+    result["attributes"] = attributes;
+    result["nulls"] = nulls;
+
+    return result;
 }
 
 
@@ -123,6 +447,21 @@ PYBIND11_MODULE(coremapping, m) {
     m.def("initialize", &initialize, "Initializes the underlying ArcGIS Runtime core environment.",
           py::arg("apiKey") = py::none());
 
+    m.def("addPointArrays", &addPointArrays, "Adds points from NumPy coordinate arrays into a new graphics overlay of the map view model.",
+          py::arg("model"), py::arg("x"), py::arg("y"), py::arg("renderer"), py::arg("z") = py::none(), py::arg("m") = py::none(),
+          py::arg("attributes") = py::dict(), py::arg("wkid") = 4326);
+    m.def("addPolylineArrays", &addPolylineArrays, "Adds polylines from NumPy coordinate and offset arrays into a new graphics overlay of the map view model.",
+          py::arg("model"), py::arg("x"), py::arg("y"), py::arg("partOffsets"), py::arg("renderer"),
+          py::arg("geometryOffsets") = py::none(), py::arg("z") = py::none(), py::arg("m") = py::none(),
+          py::arg("attributes") = py::dict(), py::arg("wkid") = 4326);
+    m.def("addPolygonArrays", &addPolygonArrays, "Adds polygons from NumPy coordinate and offset arrays into a new graphics overlay of the map view model.",
+          py::arg("model"), py::arg("x"), py::arg("y"), py::arg("partOffsets"), py::arg("renderer"),
+          py::arg("geometryOffsets") = py::none(), py::arg("z") = py::none(), py::arg("m") = py::none(),
+          py::arg("attributes") = py::dict(), py::arg("wkid") = 4326);
+
+    m.def("toColumns", &toColumns, "Exports the geoelements of a graphics overlay as NumPy coordinate, offset and attribute arrays.",
+          py::arg("model"), py::arg("index"));
+
     // The types are only needed for typing support!
     py::class_<MapViewModel>(m, "MapViewModel");
     py::class_<GeoElementsOverlayModel>(m, "GeoElementsOverlayModel");
@@ -0,0 +1,231 @@
+// geoint-mapping offers core mapping and Geospatial Intelligence capabilities for Python.
+// Copyright (C) 2024 Jan Tschada (gisfromscratch@live.de)
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// Additional permission under GNU LGPL version 3 section 4 and 5
+// If you modify this Program, or any covered work, by linking or combining
+// it with ArcGIS Runtime for Qt (or a modified version of that library),
+// containing parts covered by the terms of ArcGIS Runtime for Qt,
+// the licensors of this Program grant you additional permission to convey the resulting work.
+// See <https://developers.arcgis.com/qt/> for further information.
+//
+
+// Writes features into the binary feature format and reads them back,
+// including files whose index has been corrupted.
+
+#include "FeatureBinaryFormat.h"
+#include "FeatureBinaryReader.h"
+#include "FeatureBinaryWriter.h"
+
+#include <QFile>
+#include <QSet>
+#include <QTemporaryDir>
+#include <QTest>
+
+#include <cstring>
+
+class FeatureBinaryTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void roundTrip();
+    void searchExtent();
+    void decreasingOffsetIsRejected();
+    void offsetBeyondRecordsIsRejected();
+    void truncatedFileIsRejected();
+
+private:
+    static QList<GeoJsonFeature> createFeatures();
+    QString writeFeatures(const QList<GeoJsonFeature>& features);
+    bool patchRecordOffset(const QString& filePath, qsizetype offsetIndex, quint64 offset);
+
+    QTemporaryDir m_directory;
+    QString m_filePath;
+};
+
+QList<GeoJsonFeature> FeatureBinaryTest::createFeatures()
+{
+    QList<GeoJsonFeature> features;
+
+    GeoJsonFeature point;
+    point.geometry.type = GeoJsonGeometryType::Point;
+    point.geometry.coordinates = { 8.5417, 47.3769 };
+    point.properties = { { "id", 1 }, { "name", "Zurich" }, { "population", 421878.0 } };
+    features.append(point);
+
+    GeoJsonFeature line;
+    line.geometry.type = GeoJsonGeometryType::LineString;
+    line.geometry.coordinates = { 13.4050, 52.5200, 11.5820, 48.1351, 9.9937, 53.5511 };
+    line.geometry.parts = { 0 };
+    line.properties = { { "id", 2 }, { "name", "Route" } };
+    features.append(line);
+
+    // Exterior ring with one hole
+    GeoJsonFeature polygon;
+    polygon.geometry.type = GeoJsonGeometryType::Polygon;
+    polygon.geometry.coordinates = { 0.0, 0.0, 10.0, 0.0, 10.0, 10.0, 0.0, 10.0, 0.0, 0.0,
+                                     2.0, 2.0, 2.0, 4.0, 4.0, 4.0, 4.0, 2.0, 2.0, 2.0 };
+    polygon.geometry.parts = { 0, 5 };
+    polygon.geometry.polygons = { 0 };
+    polygon.properties = { { "id", 3 }, { "visible", true } };
+    features.append(polygon);
+
+    GeoJsonFeature multiPolygon;
+    multiPolygon.geometry.type = GeoJsonGeometryType::MultiPolygon;
+    multiPolygon.geometry.coordinates = { -40.0, -40.0, -30.0, -40.0, -30.0, -30.0, -40.0, -40.0,
+                                          40.0, -40.0, 50.0, -40.0, 50.0, -30.0, 40.0, -40.0 };
+    multiPolygon.geometry.parts = { 0, 4 };
+    multiPolygon.geometry.polygons = { 0, 1 };
+    multiPolygon.properties = { { "id", 4 } };
+    features.append(multiPolygon);
+
+    return features;
+}
+
+void FeatureBinaryTest::init()
+{
+    QVERIFY(m_directory.isValid());
+    m_filePath = m_directory.filePath(QString::fromLatin1(QTest::currentTestFunction()) + ".gmfb");
+}
+
+QString FeatureBinaryTest::writeFeatures(const QList<GeoJsonFeature>& features)
+{
+    FeatureBinaryWriter writer;
+    for (const GeoJsonFeature& feature : features)
+    {
+        writer.append(feature);
+    }
+    if (!writer.write(m_filePath))
+    {
+        qWarning() << writer.errorString();
+        return QString();
+    }
+    return m_filePath;
+}
+
+bool FeatureBinaryTest::patchRecordOffset(const QString& filePath, qsizetype offsetIndex, quint64 offset)
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadWrite))
+    {
+        return false;
+    }
+
+    FeatureBinaryFormat::FileHeader header;
+    if (qint64(sizeof(header)) != file.read(reinterpret_cast<char*>(&header), sizeof(header)))
+    {
+        return false;
+    }
+
+    const qint64 offsetsBegin = sizeof(header) + header.nodeCount * sizeof(PackedRTree::Box);
+    return file.seek(offsetsBegin + offsetIndex * sizeof(quint64))
+        && qint64(sizeof(offset)) == file.write(reinterpret_cast<const char*>(&offset), sizeof(offset));
+}
+
+void FeatureBinaryTest::roundTrip()
+{
+    const QList<GeoJsonFeature> features = createFeatures();
+    const QString filePath = writeFeatures(features);
+    QVERIFY(!filePath.isEmpty());
+
+    FeatureBinaryReader reader;
+    QVERIFY2(reader.open(filePath), qPrintable(reader.errorString()));
+    QCOMPARE(reader.size(), features.size());
+
+    // The records are stored in the order of the tree leaves
+    QSet<qlonglong> readIds;
+    GeoJsonFeature feature;
+    for (qsizetype featureIndex = 0; featureIndex < reader.size(); featureIndex++)
+    {
+        QVERIFY(reader.feature(featureIndex, feature));
+        const qlonglong id = feature.properties.value("id").toLongLong();
+        QVERIFY(0 < id && id <= features.size());
+        readIds.insert(id);
+
+        const GeoJsonFeature& expected = features.at(id - 1);
+        QCOMPARE(feature.geometry.type, expected.geometry.type);
+        QCOMPARE(feature.geometry.coordinates, expected.geometry.coordinates);
+        QCOMPARE(feature.geometry.parts, expected.geometry.parts);
+        QCOMPARE(feature.geometry.polygons, expected.geometry.polygons);
+        for (auto property = expected.properties.cbegin(); property != expected.properties.cend(); property++)
+        {
+            QCOMPARE(feature.properties.value(property.key()).toString(), property.value().toString());
+        }
+    }
+    QCOMPARE(readIds.size(), features.size());
+    QVERIFY(!reader.feature(reader.size(), feature));
+}
+
+void FeatureBinaryTest::searchExtent()
+{
+    const QString filePath = writeFeatures(createFeatures());
+    QVERIFY(!filePath.isEmpty());
+
+    FeatureBinaryReader reader;
+    QVERIFY(reader.open(filePath));
+    const PackedRTree::Box extent = reader.extent();
+    QCOMPARE(extent.minX, -40.0);
+    QCOMPARE(extent.minY, -40.0);
+    QCOMPARE(extent.maxX, 50.0);
+    QCOMPARE(extent.maxY, 53.5511);
+
+    // Only the box of the polygon with the hole covers the search box
+    const QList<qsizetype> found = reader.search(PackedRTree::Box{ 1.0, 1.0, 1.5, 1.5 });
+    QCOMPARE(found.size(), 1);
+    GeoJsonFeature feature;
+    QVERIFY(reader.feature(found.first(), feature));
+    QCOMPARE(feature.properties.value("id").toLongLong(), 3);
+}
+
+void FeatureBinaryTest::decreasingOffsetIsRejected()
+{
+    const QString filePath = writeFeatures(createFeatures());
+    QVERIFY(!filePath.isEmpty());
+    QVERIFY(patchRecordOffset(filePath, 2, 0));
+
+    FeatureBinaryReader reader;
+    QVERIFY(!reader.open(filePath));
+    QVERIFY(!reader.isOpen());
+}
+
+void FeatureBinaryTest::offsetBeyondRecordsIsRejected()
+{
+    // An intermediate offset past the mapping must not be used by feature()
+    const QString filePath = writeFeatures(createFeatures());
+    QVERIFY(!filePath.isEmpty());
+    QVERIFY(patchRecordOffset(filePath, 1, quint64(1) << 40));
+
+    FeatureBinaryReader reader;
+    QVERIFY(!reader.open(filePath));
+}
+
+void FeatureBinaryTest::truncatedFileIsRejected()
+{
+    const QString filePath = writeFeatures(createFeatures());
+    QVERIFY(!filePath.isEmpty());
+    {
+        QFile file(filePath);
+        QVERIFY(file.resize(file.size() - 16));
+    }
+
+    FeatureBinaryReader reader;
+    QVERIFY(!reader.open(filePath));
+}
+
+QTEST_GUILESS_MAIN(FeatureBinaryTest)
+
+#include "FeatureBinaryTest.moc"
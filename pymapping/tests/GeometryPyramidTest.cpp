@@ -0,0 +1,140 @@
+// geoint-mapping offers core mapping and Geospatial Intelligence capabilities for Python.
+// Copyright (C) 2024 Jan Tschada (gisfromscratch@live.de)
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// Additional permission under GNU LGPL version 3 section 4 and 5
+// If you modify this Program, or any covered work, by linking or combining
+// it with ArcGIS Runtime for Qt (or a modified version of that library),
+// containing parts covered by the terms of ArcGIS Runtime for Qt,
+// the licensors of this Program grant you additional permission to convey the resulting work.
+// See <https://developers.arcgis.com/qt/> for further information.
+//
+
+// Simplifies tracks and rings at the tolerances of the levels of detail.
+
+#include "GeometryPyramid.h"
+
+#include <QRandomGenerator>
+#include <QTest>
+
+#include <cmath>
+
+static constexpr double Pi = 3.14159265358979323846;
+
+class GeometryPyramidTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void trackLevels();
+    void smallGeometriesAreKept();
+    void collapsedRingStaysValid();
+    void levelForScale();
+
+private:
+    static GeoJsonGeometry createTrack(qsizetype pointCount);
+    static GeoJsonGeometry createRing(qsizetype pointCount, double radius);
+};
+
+GeoJsonGeometry GeometryPyramidTest::createTrack(qsizetype pointCount)
+{
+    // A random walk with steps of about 100 m
+    QRandomGenerator random(42);
+    GeoJsonGeometry track;
+    track.type = GeoJsonGeometryType::LineString;
+    track.parts = { 0 };
+    double x = 8.0;
+    double y = 47.0;
+    for (qsizetype pointIndex = 0; pointIndex < pointCount; pointIndex++)
+    {
+        track.coordinates.append(x);
+        track.coordinates.append(y);
+        x += random.bounded(0.002) - 0.001;
+        y += random.bounded(0.002) - 0.001;
+    }
+    return track;
+}
+
+GeoJsonGeometry GeometryPyramidTest::createRing(qsizetype pointCount, double radius)
+{
+    GeoJsonGeometry ring;
+    ring.type = GeoJsonGeometryType::Polygon;
+    ring.parts = { 0 };
+    ring.polygons = { 0 };
+    for (qsizetype pointIndex = 0; pointIndex < pointCount - 1; pointIndex++)
+    {
+        const double angle = 2.0 * Pi * pointIndex / (pointCount - 1);
+        ring.coordinates.append(radius * std::cos(angle));
+        ring.coordinates.append(radius * std::sin(angle));
+    }
+    ring.coordinates.append(ring.coordinates.at(0));
+    ring.coordinates.append(ring.coordinates.at(1));
+    return ring;
+}
+
+void GeometryPyramidTest::trackLevels()
+{
+    const GeoJsonGeometry track = createTrack(1000);
+    qsizetype previousCount = track.pointCount();
+    for (int level = 1; level < GeometryPyramid::LevelCount; level++)
+    {
+        const GeoJsonGeometry simplified = GeometryPyramid::simplify(track, GeometryPyramid::tolerance(level));
+        QCOMPARE(simplified.type, track.type);
+        QCOMPARE(simplified.partCount(), 1);
+        QVERIFY(2 <= simplified.pointCount());
+        QVERIFY(simplified.pointCount() <= previousCount);
+        previousCount = simplified.pointCount();
+
+        // The end points are always kept
+        QCOMPARE(simplified.coordinates.first(), track.coordinates.first());
+        QCOMPARE(simplified.coordinates.last(), track.coordinates.last());
+    }
+    QVERIFY(previousCount < track.pointCount() / 10);
+}
+
+void GeometryPyramidTest::smallGeometriesAreKept()
+{
+    const GeoJsonGeometry track = createTrack(GeometryPyramid::MinimumPointCount - 1);
+    const GeoJsonGeometry simplified = GeometryPyramid::simplify(track, GeometryPyramid::tolerance(GeometryPyramid::LevelCount - 1));
+    QCOMPARE(simplified.coordinates, track.coordinates);
+}
+
+void GeometryPyramidTest::collapsedRingStaysValid()
+{
+    // The ring is far smaller than the tolerance and becomes a closed triangle
+    const GeoJsonGeometry ring = createRing(100, 0.00001);
+    const GeoJsonGeometry simplified = GeometryPyramid::simplify(ring, GeometryPyramid::tolerance(GeometryPyramid::LevelCount - 1));
+    QCOMPARE(simplified.pointCount(), 4);
+    QCOMPARE(simplified.polygons, ring.polygons);
+    QCOMPARE(simplified.vertex(0)[0], simplified.vertex(3)[0]);
+    QCOMPARE(simplified.vertex(0)[1], simplified.vertex(3)[1]);
+}
+
+void GeometryPyramidTest::levelForScale()
+{
+    // Coarser levels are used when zooming out
+    int previousLevel = 0;
+    for (double mapScale = 1000.0; mapScale < 1e9; mapScale *= 10.0)
+    {
+        const int level = GeometryPyramid::levelForScale(mapScale);
+        QVERIFY(previousLevel <= level);
+        QVERIFY(level < GeometryPyramid::LevelCount);
+        previousLevel = level;
+    }
+}
+
+QTEST_GUILESS_MAIN(GeometryPyramidTest)
+
+#include "GeometryPyramidTest.moc"
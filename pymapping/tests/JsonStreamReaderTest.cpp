@@ -0,0 +1,134 @@
+// geoint-mapping offers core mapping and Geospatial Intelligence capabilities for Python.
+// Copyright (C) 2024 Jan Tschada (gisfromscratch@live.de)
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// Additional permission under GNU LGPL version 3 section 4 and 5
+// If you modify this Program, or any covered work, by linking or combining
+// it with ArcGIS Runtime for Qt (or a modified version of that library),
+// containing parts covered by the terms of ArcGIS Runtime for Qt,
+// the licensors of this Program grant you additional permission to convey the resulting work.
+// See <https://developers.arcgis.com/qt/> for further information.
+//
+
+// Reads the same documents from memory and in chunks from a device, so that
+// every token of interest is split at a chunk boundary once.
+
+#include "JsonStreamReader.h"
+
+#include <QBuffer>
+#include <QTest>
+
+class JsonStreamReaderTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void chunkBoundaries_data();
+    void chunkBoundaries();
+    void truncatedDocument();
+
+private:
+    static QStringList readTokens(JsonStreamReader& reader);
+};
+
+// The smallest chunk size of the reader
+static constexpr qint64 ChunkSize = 1024;
+
+QStringList JsonStreamReaderTest::readTokens(JsonStreamReader& reader)
+{
+    QStringList tokens;
+    forever
+    {
+        const JsonStreamReader::TokenType tokenType = reader.readNext();
+        switch (tokenType)
+        {
+        case JsonStreamReader::Name:
+        case JsonStreamReader::String:
+            tokens.append(QString::number(tokenType) + ":" + reader.text());
+            break;
+        case JsonStreamReader::Number:
+            tokens.append(QString::number(tokenType) + ":" + (reader.isInteger() ? QString::number(reader.integer()) : QString::number(reader.number(), 'g', 17)));
+            break;
+        case JsonStreamReader::Bool:
+            tokens.append(QString::number(tokenType) + ":" + (reader.boolean() ? "true" : "false"));
+            break;
+        case JsonStreamReader::Invalid:
+            tokens.append(QString::number(tokenType) + ":" + reader.errorString());
+            return tokens;
+        case JsonStreamReader::EndDocument:
+        case JsonStreamReader::NoToken:
+            tokens.append(QString::number(tokenType));
+            return tokens;
+        default:
+            tokens.append(QString::number(tokenType));
+            break;
+        }
+    }
+}
+
+void JsonStreamReaderTest::chunkBoundaries_data()
+{
+    QTest::addColumn<QByteArray>("document");
+
+    QTest::newRow("numbers") << QByteArray(R"({"coordinates":[[-122.4194155,37.7749295,12.5],[1e-7,-2.5E+3,9007199254740993],[0,-0,123456789012]]})");
+    QTest::newRow("escapes") << QByteArray(R"({"name":"line\nbreak \"quoted\" back\\slash \/ tab\t","unicode":"\u00e4\u20ac\ud83d\ude00"})");
+    QTest::newRow("literals") << QByteArray(R"({"visible":true,"hidden":false,"missing":null,"list":[true,false,null]})");
+    // Multi-byte UTF-8 sequences must not be split by the reader
+    QTest::newRow("utf8") << QByteArray("{\"city\":\"Z\xC3\xBCrich\",\"symbol\":\"\xE2\x82\xAC\",\"emoji\":\"\xF0\x9F\x98\x80\"}");
+}
+
+void JsonStreamReaderTest::chunkBoundaries()
+{
+    QFETCH(QByteArray, document);
+
+    JsonStreamReader memoryReader(document);
+    const QStringList expectedTokens = readTokens(memoryReader);
+    QVERIFY(!memoryReader.hasError());
+    QCOMPARE(expectedTokens.last(), QString::number(JsonStreamReader::EndDocument));
+
+    // Leading whitespace moves the first chunk boundary over every byte of the document
+    for (qsizetype padding = ChunkSize - document.size(); padding <= ChunkSize; padding++)
+    {
+        QByteArray paddedDocument(padding, ' ');
+        paddedDocument.append(document);
+        QBuffer device(&paddedDocument);
+        QVERIFY(device.open(QIODevice::ReadOnly));
+
+        JsonStreamReader chunkReader(&device, ChunkSize);
+        const QStringList tokens = readTokens(chunkReader);
+        if (tokens != expectedTokens)
+        {
+            QFAIL(qPrintable(QStringLiteral("Tokens differ with the chunk boundary at byte %1").arg(ChunkSize - padding)));
+        }
+        QCOMPARE(chunkReader.bytesConsumed(), paddedDocument.size());
+    }
+}
+
+void JsonStreamReaderTest::truncatedDocument()
+{
+    QByteArray document(ChunkSize - 4, ' ');
+    document.append(R"({"name":"trunc)");
+    QBuffer device(&document);
+    QVERIFY(device.open(QIODevice::ReadOnly));
+
+    JsonStreamReader reader(&device, ChunkSize);
+    const QStringList tokens = readTokens(reader);
+    QVERIFY(reader.hasError());
+    QVERIFY(tokens.last().startsWith(QString::number(JsonStreamReader::Invalid)));
+}
+
+QTEST_GUILESS_MAIN(JsonStreamReaderTest)
+
+#include "JsonStreamReaderTest.moc"
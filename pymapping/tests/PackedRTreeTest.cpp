@@ -0,0 +1,151 @@
+// geoint-mapping offers core mapping and Geospatial Intelligence capabilities for Python.
+// Copyright (C) 2024 Jan Tschada (gisfromscratch@live.de)
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// Additional permission under GNU LGPL version 3 section 4 and 5
+// If you modify this Program, or any covered work, by linking or combining
+// it with ArcGIS Runtime for Qt (or a modified version of that library),
+// containing parts covered by the terms of ArcGIS Runtime for Qt,
+// the licensors of this Program grant you additional permission to convey the resulting work.
+// See <https://developers.arcgis.com/qt/> for further information.
+//
+
+// Compares the packed R-tree with a linear scan over random boxes.
+
+#include "PackedRTree.h"
+
+#include <QRandomGenerator>
+#include <QTest>
+
+#include <algorithm>
+
+class PackedRTreeTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void searchMatchesLinearScan();
+    void emptyBoxesAreNotFound();
+    void visitStopsEarly();
+    void nodesDescribeTheSameTree();
+    void emptyTree();
+
+private:
+    static QList<PackedRTree::Box> randomBoxes(qsizetype count, QRandomGenerator& random);
+    static QList<qsizetype> linearSearch(const QList<PackedRTree::Box>& boxes, const PackedRTree::Box& searchBox);
+};
+
+QList<PackedRTree::Box> PackedRTreeTest::randomBoxes(qsizetype count, QRandomGenerator& random)
+{
+    QList<PackedRTree::Box> boxes;
+    boxes.reserve(count);
+    for (qsizetype index = 0; index < count; index++)
+    {
+        const double x = random.bounded(360.0) - 180.0;
+        const double y = random.bounded(180.0) - 90.0;
+        const double width = 0 == index % 4 ? 0.0 : random.bounded(2.0);
+        const double height = 0 == index % 4 ? 0.0 : random.bounded(2.0);
+        boxes.append(PackedRTree::Box{ x, y, x + width, y + height });
+    }
+    return boxes;
+}
+
+QList<qsizetype> PackedRTreeTest::linearSearch(const QList<PackedRTree::Box>& boxes, const PackedRTree::Box& searchBox)
+{
+    QList<qsizetype> indices;
+    for (qsizetype index = 0; index < boxes.size(); index++)
+    {
+        if (!boxes.at(index).isEmpty() && searchBox.intersects(boxes.at(index)))
+        {
+            indices.append(index);
+        }
+    }
+    return indices;
+}
+
+void PackedRTreeTest::searchMatchesLinearScan()
+{
+    QRandomGenerator random(42);
+    const QList<PackedRTree::Box> boxes = randomBoxes(10000, random);
+    const PackedRTree tree(boxes);
+    QCOMPARE(tree.size(), boxes.size());
+
+    for (int queryIndex = 0; queryIndex < 200; queryIndex++)
+    {
+        const double x = random.bounded(360.0) - 180.0;
+        const double y = random.bounded(180.0) - 90.0;
+        const double size = random.bounded(20.0);
+        const PackedRTree::Box searchBox{ x, y, x + size, y + size };
+
+        QList<qsizetype> found = tree.search(searchBox);
+        std::sort(found.begin(), found.end());
+        QCOMPARE(found, linearSearch(boxes, searchBox));
+    }
+}
+
+void PackedRTreeTest::emptyBoxesAreNotFound()
+{
+    QList<PackedRTree::Box> boxes(100, PackedRTree::Box());
+    boxes[42] = PackedRTree::Box{ 1.0, 1.0, 2.0, 2.0 };
+    const PackedRTree tree(boxes);
+
+    const QList<qsizetype> found = tree.search(PackedRTree::Box{ -1000.0, -1000.0, 1000.0, 1000.0 });
+    QCOMPARE(found, QList<qsizetype>({ 42 }));
+}
+
+void PackedRTreeTest::visitStopsEarly()
+{
+    QRandomGenerator random(7);
+    const QList<PackedRTree::Box> boxes = randomBoxes(1000, random);
+    const PackedRTree tree(boxes);
+
+    qsizetype visited = 0;
+    tree.visit(tree.extent(), [&visited](qsizetype)
+    {
+        visited++;
+        return visited < 10;
+    });
+    QCOMPARE(visited, qsizetype(10));
+}
+
+void PackedRTreeTest::nodesDescribeTheSameTree()
+{
+    QRandomGenerator random(1);
+    const QList<PackedRTree::Box> boxes = randomBoxes(5000, random);
+    const PackedRTree tree(boxes);
+
+    // Trees on external nodes report leaves, which map to the items of the built tree
+    const PackedRTree nodeTree = PackedRTree::fromNodes(tree.size(), tree.nodes(), tree.nodeCount());
+    QCOMPARE(nodeTree.nodeCount(), PackedRTree::nodeCount(boxes.size()));
+    const PackedRTree::Box searchBox{ -30.0, -30.0, 30.0, 30.0 };
+    QList<qsizetype> found;
+    for (qsizetype leafIndex : nodeTree.search(searchBox))
+    {
+        found.append(tree.itemIndex(leafIndex));
+    }
+    std::sort(found.begin(), found.end());
+    QCOMPARE(found, linearSearch(boxes, searchBox));
+}
+
+void PackedRTreeTest::emptyTree()
+{
+    const PackedRTree tree;
+    QVERIFY(tree.isEmpty());
+    QVERIFY(tree.search(PackedRTree::Box{ -1.0, -1.0, 1.0, 1.0 }).isEmpty());
+}
+
+QTEST_GUILESS_MAIN(PackedRTreeTest)
+
+#include "PackedRTreeTest.moc"